@@ -0,0 +1,32 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+static inline uint64_t bench_now_ns(void) {
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t) ((double) now.QuadPart * 1e9 / (double) freq.QuadPart);
+}
+#else
+#include <time.h>
+
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+#endif
+
+/* Keeps the optimiser from discarding work whose result is otherwise unused. */
+static const void *volatile bench_sink;
+
+static inline void bench_consume(const void *p) {
+    bench_sink = p;
+}
+
+#endif /* BENCH_H */
@@ -0,0 +1,94 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "codec.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Shift codec throughput per kernel on a large value blob.
+ *
+ *   codec_bench [blob_mib] [rounds]
+ */
+
+static int verify(sso_codec_kernel_t kernel, const uint8_t *src, uint8_t *a, uint8_t *b) {
+    /* Odd lengths and offsets exercise every tail path. */
+    for (size_t len = 0; len < 1100; len += 7) {
+        sso_codec_select_kernel(SSO_CODEC_SCALAR);
+        sso_shift_decode(a, src + 3, len, 0x5b);
+        sso_codec_select_kernel(kernel);
+        sso_shift_decode(b, src + 3, len, 0x5b);
+        if (memcmp(a, b, len))
+            return 1;
+        sso_shift_encode(b, b, len, 0x5b);
+        if (memcmp(b, src + 3, len))
+            return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const size_t mib = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : 64;
+    const int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    const size_t len = mib << 20;
+
+    uint8_t *src = (uint8_t *) malloc(len);
+    uint8_t *dst = (uint8_t *) malloc(len);
+    uint8_t *tmp = (uint8_t *) malloc(2048);
+    if (!src || !dst || !tmp || len < 2048) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    uint32_t x = 0x12345678u;
+    for (size_t i = 0; i < len; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        src[i] = (uint8_t) x;
+    }
+
+    printf("%-8s %-8s %10s %10s\n", "kernel", "mode", "GB/s", "ok");
+
+    for (int k = SSO_CODEC_SCALAR; k < SSO_CODEC_KERNEL_COUNT; ++k) {
+        const sso_codec_kernel_t kernel = (sso_codec_kernel_t) k;
+        if (!sso_codec_kernel_supported(kernel)) {
+            printf("%-8s %-8s %10s %10s\n", sso_codec_kernel_name(kernel), "-", "-", "n/a");
+            continue;
+        }
+
+        const int ok = verify(kernel, src, dst, tmp) == 0;
+        sso_codec_select_kernel(kernel);
+
+        uint64_t t0 = bench_now_ns();
+        for (int r = 0; r < rounds; ++r)
+            sso_shift_decode(dst, src, len, (uint8_t) r);
+        uint64_t t1 = bench_now_ns();
+        bench_consume(dst);
+
+        memcpy(dst, src, len);
+        uint64_t t2 = bench_now_ns();
+        for (int r = 0; r < rounds; ++r)
+            sso_shift_decode(dst, dst, len, (uint8_t) r);
+        uint64_t t3 = bench_now_ns();
+        bench_consume(dst);
+
+        const double bytes = (double) len * rounds;
+        printf("%-8s %-8s %10.2f %10s\n", sso_codec_kernel_name(kernel), "copy",
+               bytes / (double) (t1 - t0), ok ? "yes" : "NO");
+        printf("%-8s %-8s %10.2f %10s\n", sso_codec_kernel_name(kernel), "inplace",
+               bytes / (double) (t3 - t2), ok ? "yes" : "NO");
+    }
+
+    sso_codec_select_kernel(SSO_CODEC_AUTO);
+    printf("auto-selected: %s\n", sso_codec_kernel_name(sso_codec_active_kernel()));
+
+    free(tmp);
+    free(dst);
+    free(src);
+    return 0;
+}
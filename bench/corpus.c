@@ -0,0 +1,169 @@
+#include "corpus.h"
+#include "text.h"
+#include "vf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+static uint64_t corpus_next(uint64_t *state) {
+    /* splitmix64: tiny, seedable and identical on every platform. */
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static uint32_t corpus_range(uint64_t *state, uint32_t min, uint32_t max) {
+    if (max <= min)
+        return min;
+    return min + (uint32_t) (corpus_next(state) % ((uint64_t) max - min + 1));
+}
+
+static void corpus_fill(uint64_t *state, char *out, uint32_t len) {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789_";
+    for (uint32_t i = 0; i < len; ++i)
+        out[i] = alphabet[corpus_next(state) % (sizeof(alphabet) - 1)];
+    out[len] = '\0';
+}
+
+/* ================== OPTIONS ================== */
+
+void corpus_defaults(corpus_opts_t *opts) {
+    memset(opts, 0, sizeof(*opts));
+    opts->entries = 100000;
+    opts->key_min = 8;
+    opts->key_max = 48;
+    opts->value_min = 4;
+    opts->value_max = 120;
+    opts->path_min = 24;
+    opts->path_max = 96;
+    opts->dirs = 64;
+    opts->seed = 1;
+}
+
+int corpus_parse_option(corpus_opts_t *opts, const char *name, const char *value) {
+    if (!name || !value)
+        return 1;
+    const unsigned long long v = strtoull(value, NULL, 10);
+
+    if (strcmp(name, "--entries") == 0)
+        opts->entries = (uint32_t) v;
+    else if (strcmp(name, "--key-min") == 0)
+        opts->key_min = (uint32_t) v;
+    else if (strcmp(name, "--key-max") == 0)
+        opts->key_max = (uint32_t) v;
+    else if (strcmp(name, "--value-min") == 0)
+        opts->value_min = (uint32_t) v;
+    else if (strcmp(name, "--value-max") == 0)
+        opts->value_max = (uint32_t) v;
+    else if (strcmp(name, "--path-min") == 0)
+        opts->path_min = (uint32_t) v;
+    else if (strcmp(name, "--path-max") == 0)
+        opts->path_max = (uint32_t) v;
+    else if (strcmp(name, "--dirs") == 0)
+        opts->dirs = (uint32_t) v;
+    else if (strcmp(name, "--seed") == 0)
+        opts->seed = (uint64_t) v;
+    else
+        return 1;
+    return 0;
+}
+
+/* ================== GENERATORS ================== */
+
+int corpus_write_text(const char *filename, const corpus_opts_t *opts) {
+    /* Key lengths live in a byte on disk. */
+    if (opts->key_max > 255 || opts->key_min > opts->key_max || opts->value_min > opts->value_max)
+        return 1;
+
+    text_file_t tf;
+    memset(&tf, 0, sizeof(tf));
+    tf.header.entry_count = opts->entries;
+    tf.entries = (text_entry_t *) calloc(opts->entries ? opts->entries : 1, sizeof(text_entry_t));
+    char *buf = (char *) malloc((size_t) (opts->key_max > opts->value_max ? opts->key_max : opts->value_max) + 1);
+    if (!tf.entries || !buf) {
+        free(tf.entries);
+        free(buf);
+        return 1;
+    }
+
+    uint64_t state = opts->seed;
+    int failed = 0;
+    for (uint32_t i = 0; i < opts->entries && !failed; ++i) {
+        text_entry_t *e = &tf.entries[i];
+        const uint32_t key_len = corpus_range(&state, opts->key_min, opts->key_max);
+        corpus_fill(&state, buf, key_len);
+        text_entry_set_key(e, buf);
+        e->key_offset = (uint8_t) corpus_next(&state);
+
+        const uint32_t value_len = corpus_range(&state, opts->value_min, opts->value_max);
+        corpus_fill(&state, buf, value_len);
+        failed = text_entry_set_value_utf8(e, buf, value_len) != 0 || !e->key;
+        /* ASCII values keep the high byte of the first UTF-16 unit zero, which the offset is derived from. */
+        e->value_offset = (uint8_t) corpus_next(&state);
+    }
+
+    if (!failed)
+        failed = text_file_write(filename, &tf);
+
+    for (uint32_t i = 0; i < opts->entries; ++i) {
+        text_entry_set_key(&tf.entries[i], NULL);
+        text_entry_set_value(&tf.entries[i], NULL);
+    }
+    free(tf.entries);
+    free(buf);
+    return failed;
+}
+
+int corpus_write_ccx(const char *filename, const corpus_opts_t *opts) {
+    if (opts->path_min > opts->path_max || opts->dirs == 0)
+        return 1;
+
+    vf_file_t *vf = vf_file_create();
+    char *path = (char *) malloc((size_t) opts->path_max + 64);
+    if (!vf || !path || vf_file_reserve(vf, opts->entries)) {
+        vf_file_free(vf);
+        free(path);
+        return 1;
+    }
+    memcpy(vf->header.magic_bytes, "CCX", 4);
+    vf->header.manifest_version = 1;
+
+    uint64_t state = opts->seed;
+    int failed = 0;
+    for (uint32_t i = 0; i < opts->entries && !failed; ++i) {
+        /* "dirNN\subNN\" prefix from a small pool, so folders repeat the way real installs do. */
+        const uint32_t dir = (uint32_t) (corpus_next(&state) % opts->dirs);
+        const uint32_t sub = (uint32_t) (corpus_next(&state) % 16);
+        const int prefix = snprintf(path, 64, "dir%u\\sub%u\\", dir, sub);
+
+        const uint32_t total = corpus_range(&state, opts->path_min, opts->path_max);
+        const uint32_t leaf = total > (uint32_t) prefix + 5 ? total - (uint32_t) prefix - 4 : 1;
+        corpus_fill(&state, path + prefix, leaf);
+        memcpy(path + prefix + leaf, ".bin", 5);
+
+        vf_entry_t e;
+        memset(&e, 0, sizeof(e));
+        vf_entry_set_path(&e, path);
+        vf_entry_set_name(&e, path + prefix);
+        const uint64_t r = corpus_next(&state);
+        memcpy(e.original_crc, &r, 4);
+        memcpy(e.exported_crc, &r, 4);
+        e.file_size = (uint32_t) (r >> 40);
+        e.source_file_number = i;
+
+        /* A successful take leaves `e` zeroed, so these only free what a failure left behind. */
+        failed = !e.file_name || !e.file_path || vf_file_append_take(vf, &e);
+        sso_free(e.file_name);
+        sso_free(e.file_path);
+    }
+
+    if (!failed)
+        failed = vf_file_write(filename, vf);
+    vf_file_free(vf);
+    free(path);
+    return failed;
+}
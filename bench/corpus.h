@@ -0,0 +1,33 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stdint.h>
+
+/*
+ * Synthetic .text / .ccx files for the benchmarks. Lengths are drawn
+ * uniformly from [min, max]; the same options and seed always produce the
+ * same file. Files go through text_file_write / vf_file_write, so they are
+ * exactly what the library itself would write.
+ */
+typedef struct {
+    uint32_t entries;
+    uint32_t key_min;      /* .text key bytes (at most 255) */
+    uint32_t key_max;
+    uint32_t value_min;    /* .text value characters, stored as UTF-16 */
+    uint32_t value_max;
+    uint32_t path_min;     /* .ccx file_path bytes, directories included */
+    uint32_t path_max;
+    uint32_t dirs;         /* distinct top-level directories in .ccx paths */
+    uint64_t seed;
+} corpus_opts_t;
+
+/* 100k entries: 8-48 byte keys, 4-120 character values, 24-96 byte paths under 64 folders. */
+void corpus_defaults(corpus_opts_t *opts);
+
+/* Applies one "--name value" option (e.g. "--entries", "1000"); returns 1 if the name is not a corpus option. */
+int  corpus_parse_option(corpus_opts_t *opts, const char *name, const char *value);
+
+int  corpus_write_text(const char *filename, const corpus_opts_t *opts);
+int  corpus_write_ccx(const char *filename, const corpus_opts_t *opts);
+
+#endif /* CORPUS_H */
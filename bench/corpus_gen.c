@@ -0,0 +1,36 @@
+#include "corpus.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Writes one synthetic file for benchmarking or profiling.
+ *
+ *   corpus_gen text|ccx <output> [--entries N] [--key-min N] [--key-max N]
+ *              [--value-min N] [--value-max N] [--path-min N] [--path-max N]
+ *              [--dirs N] [--seed N]
+ */
+
+int main(int argc, char **argv) {
+    if (argc < 3 || (strcmp(argv[1], "text") != 0 && strcmp(argv[1], "ccx") != 0)) {
+        fprintf(stderr, "usage: %s text|ccx <output> [--entries N] [--seed N] ...\n", argv[0]);
+        return 2;
+    }
+
+    corpus_opts_t opts;
+    corpus_defaults(&opts);
+    for (int i = 3; i < argc; i += 2) {
+        if (i + 1 >= argc || corpus_parse_option(&opts, argv[i], argv[i + 1])) {
+            fprintf(stderr, "unknown or incomplete option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    const int failed = strcmp(argv[1], "text") == 0 ? corpus_write_text(argv[2], &opts)
+                                                    : corpus_write_ccx(argv[2], &opts);
+    if (failed) {
+        fprintf(stderr, "failed to write %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
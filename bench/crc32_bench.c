@@ -0,0 +1,113 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "crc32.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SSO_BENCH_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+/*
+ * CRC32 throughput per kernel, checked against zlib's crc32() when the
+ * benchmark is built with zlib and against a bitwise reference otherwise.
+ *
+ *   crc32_bench [blob_mib] [rounds]
+ */
+
+static uint32_t reference_crc(uint32_t crc, const uint8_t *p, size_t len) {
+#ifdef SSO_BENCH_HAVE_ZLIB
+    return (uint32_t) crc32(crc, p, (uInt) len);
+#else
+    uint32_t c = ~crc;
+    while (len--) {
+        c ^= *p++;
+        for (int k = 0; k < 8; ++k)
+            c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1u)));
+    }
+    return ~c;
+#endif
+}
+
+static int verify(sso_crc32_kernel_t kernel, const uint8_t *src) {
+    sso_crc32_select_kernel(kernel);
+    /* Odd lengths and misaligned starts exercise every fold and tail path. */
+    for (size_t len = 0; len < 2100; len += 7) {
+        const uint8_t *p = src + len % 13;
+        if (sso_crc32(0x1234u, p, len) != reference_crc(0x1234u, p, len))
+            return 1;
+    }
+    /* Split points across the 64-byte fold boundary must combine back to the whole. */
+    for (size_t a = 0; a < 300; a += 11) {
+        const size_t b = 1000 - a;
+        const uint32_t whole = sso_crc32(0, src, a + b);
+        if (sso_crc32_combine(sso_crc32(0, src, a), sso_crc32(0, src + a, b), b) != whole)
+            return 1;
+    }
+    return 0;
+}
+
+static void report(const char *name, double bytes, uint64_t ns, const char *ok) {
+    printf("%-8s %10.2f %10s\n", name, bytes / (double) ns, ok);
+}
+
+int main(int argc, char **argv) {
+    const size_t mib = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : 64;
+    const int rounds = argc > 2 ? atoi(argv[2]) : 10;
+    const size_t len = mib << 20;
+
+    uint8_t *src = (uint8_t *) malloc(len);
+    if (!src || len < 4096) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    uint32_t x = 0x12345678u;
+    for (size_t i = 0; i < len; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        src[i] = (uint8_t) x;
+    }
+
+    const uint32_t expected = reference_crc(0, src, len);
+    printf("%-8s %10s %10s\n", "kernel", "GB/s", "ok");
+
+    for (int k = SSO_CRC32_SLICE16; k < SSO_CRC32_KERNEL_COUNT; ++k) {
+        const sso_crc32_kernel_t kernel = (sso_crc32_kernel_t) k;
+        if (!sso_crc32_kernel_supported(kernel)) {
+            printf("%-8s %10s %10s\n", sso_crc32_kernel_name(kernel), "-", "n/a");
+            continue;
+        }
+
+        int ok = verify(kernel, src) == 0;
+        uint32_t crc = 0;
+        const uint64_t t0 = bench_now_ns();
+        for (int r = 0; r < rounds; ++r)
+            crc = sso_crc32(0, src, len);
+        const uint64_t t1 = bench_now_ns();
+        ok = ok && crc == expected;
+
+        report(sso_crc32_kernel_name(kernel), (double) len * rounds, t1 - t0, ok ? "yes" : "NO");
+    }
+
+#ifdef SSO_BENCH_HAVE_ZLIB
+    uint32_t crc = 0;
+    const uint64_t t0 = bench_now_ns();
+    for (int r = 0; r < rounds; ++r)
+        crc = (uint32_t) crc32(0, src, (uInt) len);
+    const uint64_t t1 = bench_now_ns();
+    report("zlib", (double) len * rounds, t1 - t0, crc == expected ? "yes" : "NO");
+#endif
+
+    sso_crc32_select_kernel(SSO_CRC32_AUTO);
+    printf("auto-selected: %s\n", sso_crc32_kernel_name(sso_crc32_active_kernel()));
+
+    free(src);
+    return 0;
+}
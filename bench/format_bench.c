@@ -0,0 +1,355 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "text.h"
+#include "vf.h"
+#include "bench.h"
+#include "corpus.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Read / write / free cost of both formats on synthetic corpora (or given
+ * files), one JSON object per line so runs can be compared across versions:
+ *
+ *   {"bench":"vf_file_read","mode":"heap","entries":100000,"bytes":...,
+ *    "rounds":10,"ns_min":...,"ns_median":...,"ns_per_entry":...,
+ *    "mb_per_s":...,"allocs":...,"alloc_bytes":...,"peak_rss_kb":...}
+ *
+ * ns_per_entry and mb_per_s come from the median round; allocs and
+ * alloc_bytes are the library's own allocations per round, counted through
+ * sso_set_allocator. Each group of cases runs in its own process where fork
+ * exists, so peak_rss_kb belongs to that group alone; it is null where the
+ * platform cannot measure it.
+ *
+ *   format_bench [--rounds N] [--dir D] [--text FILE] [--ccx FILE] [corpus options]
+ */
+
+#define BENCH_MAX_ROUNDS 1000
+
+/* ================== ALLOCATION COUNTING ================== */
+
+static uint64_t bench_allocs;
+static uint64_t bench_alloc_bytes;
+
+static void *bench_alloc(void *user, size_t size) {
+    (void) user;
+    bench_allocs++;
+    bench_alloc_bytes += size;
+    return malloc(size);
+}
+
+static void *bench_realloc(void *user, void *p, size_t size) {
+    (void) user;
+    bench_allocs++;
+    bench_alloc_bytes += size;
+    return realloc(p, size);
+}
+
+static void bench_free(void *user, void *p) {
+    (void) user;
+    free(p);
+}
+
+/* ================== MEASUREMENT ================== */
+
+typedef struct {
+    const char *text_path;
+    const char *ccx_path;
+    const char *out_path;
+    int         rounds;
+} bench_ctx_t;
+
+typedef struct {
+    uint64_t ns[BENCH_MAX_ROUNDS];
+    int      count;
+    uint64_t allocs;
+    uint64_t alloc_bytes;
+    uint64_t allocs_start;
+    uint64_t alloc_bytes_start;
+    uint64_t start;
+} bench_sample_t;
+
+static void sample_begin(bench_sample_t *s) {
+    s->allocs_start = bench_allocs;
+    s->alloc_bytes_start = bench_alloc_bytes;
+    s->start = bench_now_ns();
+}
+
+static void sample_end(bench_sample_t *s) {
+    const uint64_t now = bench_now_ns();
+    if (s->count < BENCH_MAX_ROUNDS)
+        s->ns[s->count++] = now - s->start;
+    s->allocs = bench_allocs - s->allocs_start;
+    s->alloc_bytes = bench_alloc_bytes - s->alloc_bytes_start;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    const uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return x < y ? -1 : x > y;
+}
+
+static long peak_rss_kb(void) {
+#ifdef _WIN32
+    return -1;
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru))
+        return -1;
+#ifdef __APPLE__
+    return ru.ru_maxrss / 1024;
+#else
+    return ru.ru_maxrss;
+#endif
+#endif
+}
+
+static uint64_t file_size(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return 0;
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0)
+        size = ftell(f);
+    fclose(f);
+    return size < 0 ? 0 : (uint64_t) size;
+}
+
+static void report(const char *bench, const char *mode, uint32_t entries, uint64_t bytes, bench_sample_t *s) {
+    if (s->count == 0)
+        return;
+    qsort(s->ns, (size_t) s->count, sizeof(uint64_t), cmp_u64);
+    const uint64_t median = s->ns[s->count / 2];
+
+    printf("{\"bench\":\"%s\",\"mode\":\"%s\",\"entries\":%u,\"bytes\":%llu,\"rounds\":%d,"
+           "\"ns_min\":%llu,\"ns_median\":%llu,\"ns_per_entry\":%.2f,\"mb_per_s\":%.2f,",
+           bench, mode, entries, (unsigned long long) bytes, s->count,
+           (unsigned long long) s->ns[0], (unsigned long long) median,
+           entries ? (double) median / entries : 0.0,
+           median ? (double) bytes / 1e6 / ((double) median / 1e9) : 0.0);
+    printf("\"allocs\":%llu,\"alloc_bytes\":%llu,",
+           (unsigned long long) s->allocs, (unsigned long long) s->alloc_bytes);
+    const long rss = peak_rss_kb();
+    if (rss >= 0)
+        printf("\"peak_rss_kb\":%ld}\n", rss);
+    else
+        printf("\"peak_rss_kb\":null}\n");
+}
+
+/* ================== CASES ================== */
+
+static int bench_text(const bench_ctx_t *ctx, int arena) {
+    const char *mode = arena ? "arena" : "heap";
+    bench_sample_t *read = (bench_sample_t *) calloc(2, sizeof(bench_sample_t));
+    if (!read)
+        return 1;
+    bench_sample_t *release = read + 1;
+
+    uint32_t entries = 0;
+    for (int r = 0; r < ctx->rounds; ++r) {
+        sample_begin(read);
+        text_file_t *tf = arena ? text_file_read_arena(ctx->text_path) : text_file_read(ctx->text_path);
+        sample_end(read);
+        if (!tf) {
+            free(read);
+            return 1;
+        }
+        entries = tf->header.entry_count;
+        bench_consume(tf);
+
+        sample_begin(release);
+        text_file_free(tf);
+        sample_end(release);
+    }
+
+    const uint64_t bytes = file_size(ctx->text_path);
+    report(arena ? "text_file_read_arena" : "text_file_read", mode, entries, bytes, read);
+    report("text_file_free", mode, entries, bytes, release);
+    free(read);
+    return 0;
+}
+
+static int bench_vf(const bench_ctx_t *ctx, int arena) {
+    const char *mode = arena ? "arena" : "heap";
+    bench_sample_t *read = (bench_sample_t *) calloc(2, sizeof(bench_sample_t));
+    if (!read)
+        return 1;
+    bench_sample_t *release = read + 1;
+
+    uint32_t entries = 0;
+    for (int r = 0; r < ctx->rounds; ++r) {
+        sample_begin(read);
+        vf_file_t *vf = arena ? vf_file_read_arena(ctx->ccx_path) : vf_file_read(ctx->ccx_path);
+        sample_end(read);
+        if (!vf) {
+            free(read);
+            return 1;
+        }
+        entries = vf->header.entry_count;
+        bench_consume(vf);
+
+        sample_begin(release);
+        vf_file_free(vf);
+        sample_end(release);
+    }
+
+    const uint64_t bytes = file_size(ctx->ccx_path);
+    report(arena ? "vf_file_read_arena" : "vf_file_read", mode, entries, bytes, read);
+    report("vf_file_free", mode, entries, bytes, release);
+    free(read);
+    return 0;
+}
+
+static int bench_vf_write(const bench_ctx_t *ctx) {
+    vf_file_t *vf = vf_file_read(ctx->ccx_path);
+    bench_sample_t *write = (bench_sample_t *) calloc(1, sizeof(bench_sample_t));
+    if (!vf || !write) {
+        vf_file_free(vf);
+        free(write);
+        return 1;
+    }
+
+    int failed = 0;
+    for (int r = 0; r < ctx->rounds && !failed; ++r) {
+        sample_begin(write);
+        failed = vf_file_write(ctx->out_path, vf);
+        sample_end(write);
+    }
+
+    if (!failed)
+        report("vf_file_write", "heap", vf->header.entry_count, file_size(ctx->out_path), write);
+    remove(ctx->out_path);
+    vf_file_free(vf);
+    free(write);
+    return failed;
+}
+
+/* Runs one group of cases in a child process so its peak RSS is its own. */
+static int run_group(int (*fn)(const bench_ctx_t *, int), const bench_ctx_t *ctx, int arg) {
+#ifndef _WIN32
+    fflush(stdout);
+    const pid_t pid = fork();
+    if (pid == 0) {
+        const int rc = fn(ctx, arg);
+        fflush(stdout);
+        _exit(rc);
+    }
+    if (pid > 0) {
+        int status = 0;
+        if (waitpid(pid, &status, 0) != pid)
+            return 1;
+        return !(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+#endif
+    return fn(ctx, arg);
+}
+
+static int bench_vf_write_group(const bench_ctx_t *ctx, int arg) {
+    (void) arg;
+    return bench_vf_write(ctx);
+}
+
+/* ================== DRIVER ================== */
+
+static char *join_path(const char *dir, const char *name) {
+    const size_t a = strlen(dir), b = strlen(name);
+    char *p = (char *) malloc(a + b + 2);
+    if (!p)
+        return NULL;
+    memcpy(p, dir, a);
+    p[a] = '/';
+    memcpy(p + a + 1, name, b + 1);
+    return p;
+}
+
+int main(int argc, char **argv) {
+    corpus_opts_t opts;
+    corpus_defaults(&opts);
+
+    bench_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.rounds = 10;
+    const char *dir = ".";
+
+    sso_allocator_t counting;
+    counting.alloc = bench_alloc;
+    counting.realloc = bench_realloc;
+    counting.free = bench_free;
+    counting.user = NULL;
+    sso_set_allocator(&counting);
+
+    for (int i = 1; i < argc; i += 2) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            fprintf(stderr, "missing value for %s\n", argv[i]);
+            return 2;
+        }
+        if (strcmp(argv[i], "--rounds") == 0)
+            ctx.rounds = atoi(value);
+        else if (strcmp(argv[i], "--dir") == 0)
+            dir = value;
+        else if (strcmp(argv[i], "--text") == 0)
+            ctx.text_path = value;
+        else if (strcmp(argv[i], "--ccx") == 0)
+            ctx.ccx_path = value;
+        else if (corpus_parse_option(&opts, argv[i], value)) {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (ctx.rounds < 1 || ctx.rounds > BENCH_MAX_ROUNDS) {
+        fprintf(stderr, "--rounds must be between 1 and %d\n", BENCH_MAX_ROUNDS);
+        return 2;
+    }
+
+    /* Generated corpora are removed afterwards; given files are left alone. */
+    char *gen_text = ctx.text_path ? NULL : join_path(dir, "format_bench_corpus.text");
+    char *gen_ccx = ctx.ccx_path ? NULL : join_path(dir, "format_bench_corpus.ccx");
+    char *out = join_path(dir, "format_bench_out.ccx");
+    if ((!ctx.text_path && !gen_text) || (!ctx.ccx_path && !gen_ccx) || !out) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    if (gen_text && corpus_write_text(gen_text, &opts)) {
+        fprintf(stderr, "failed to generate %s\n", gen_text);
+        return 1;
+    }
+    if (gen_ccx && corpus_write_ccx(gen_ccx, &opts)) {
+        fprintf(stderr, "failed to generate %s\n", gen_ccx);
+        return 1;
+    }
+    if (gen_text)
+        ctx.text_path = gen_text;
+    if (gen_ccx)
+        ctx.ccx_path = gen_ccx;
+    ctx.out_path = out;
+
+    int failed = 0;
+    failed |= run_group(bench_text, &ctx, 0);
+    failed |= run_group(bench_text, &ctx, 1);
+    failed |= run_group(bench_vf, &ctx, 0);
+    failed |= run_group(bench_vf, &ctx, 1);
+    failed |= run_group(bench_vf_write_group, &ctx, 0);
+
+    if (gen_text)
+        remove(gen_text);
+    if (gen_ccx)
+        remove(gen_ccx);
+    free(gen_text);
+    free(gen_ccx);
+    free(out);
+
+    if (failed)
+        fprintf(stderr, "some benchmarks failed\n");
+    return failed;
+}
@@ -0,0 +1,60 @@
+#ifndef SSO_ALLOC_H
+#define SSO_ALLOC_H
+
+#include <stddef.h>
+#include "sso.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Every block the library allocates or frees goes through one allocator:
+ * the calling thread's override if set, else the global one, else libc.
+ *
+ * Memory must be released through the allocator it came from. Install the
+ * global allocator before anything is allocated, and free objects under the
+ * same override they were created under (or just drop them with your arena).
+ * Anything the library will free has to come from it too: start files with
+ * text_file_create / vf_file_create and owned strings with sso_malloc.
+ * Parallel operations hand the caller's allocator to their worker threads,
+ * so it must then be safe to call concurrently.
+ *
+ * free receives NULL never; alloc/realloc are never asked for 0 bytes.
+ */
+
+typedef struct {
+    void *(*alloc)(void *user, size_t size);
+    void *(*realloc)(void *user, void *ptr, size_t size);
+    void  (*free)(void *user, void *ptr);
+    void  *user;
+} sso_allocator_t;
+
+/* ================== ALLOCATOR SELECTION ================== */
+
+/* Copies `a`; NULL restores libc. Not synchronised: call before other threads use the library. */
+SSO_API void                   sso_set_allocator(const sso_allocator_t *a);
+
+/*
+ * Per-thread override, kept by pointer until replaced; NULL falls back to the
+ * global allocator. Returns the previous override so calls can nest.
+ */
+SSO_API const sso_allocator_t *sso_set_thread_allocator(const sso_allocator_t *a);
+SSO_API const sso_allocator_t *sso_get_thread_allocator(void);
+
+/* ================== ALLOCATION ================== */
+
+/*
+ * The library's own entry points, for memory handed to the library to own
+ * (e.g. strings passed to vf_file_append_take) or received from it.
+ */
+SSO_API void *sso_malloc(size_t size);
+SSO_API void *sso_calloc(size_t n, size_t size);
+SSO_API void *sso_realloc(void *ptr, size_t size);
+SSO_API void  sso_free(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSO_ALLOC_H */
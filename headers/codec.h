@@ -0,0 +1,48 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sso.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Caesar-style byte shift used to obfuscate .text keys and values.
+ *
+ *   decode: dst[i] = src[i] + offset
+ *   encode: dst[i] = src[i] - offset
+ *
+ * dst may equal src for in-place operation; any other overlap is undefined.
+ * The fastest kernel the CPU supports is picked on first use.
+ */
+
+typedef enum {
+    SSO_CODEC_AUTO = 0,
+    SSO_CODEC_SCALAR,
+    SSO_CODEC_SSE2,
+    SSO_CODEC_AVX2,
+    SSO_CODEC_AVX512,
+    SSO_CODEC_KERNEL_COUNT
+} sso_codec_kernel_t;
+
+/* ================== CODEC ================== */
+
+SSO_API void               sso_shift_decode(void *dst, const void *src, size_t len, uint8_t offset);
+SSO_API void               sso_shift_encode(void *dst, const void *src, size_t len, uint8_t offset);
+
+/* ================== KERNEL SELECTION ================== */
+
+SSO_API sso_codec_kernel_t sso_codec_active_kernel(void);
+SSO_API int                sso_codec_kernel_supported(sso_codec_kernel_t kernel);
+/* Forces a kernel (mostly for benchmarks), SSO_CODEC_AUTO restores detection. Returns 1 if unsupported. */
+SSO_API int                sso_codec_select_kernel(sso_codec_kernel_t kernel);
+SSO_API const char        *sso_codec_kernel_name(sso_codec_kernel_t kernel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CODEC_H */
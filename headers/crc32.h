@@ -0,0 +1,49 @@
+#ifndef SSO_CRC32_H
+#define SSO_CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sso.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320), the checksum zlib
+ * computes and the .ccx original_crc / exported_crc fields hold.
+ *
+ * Pass 0 to start and the previous result to continue a running CRC, as with
+ * zlib's crc32(). The fastest kernel the CPU supports is picked on first use.
+ */
+
+typedef enum {
+    SSO_CRC32_AUTO = 0,
+    SSO_CRC32_SLICE16,
+    SSO_CRC32_PCLMUL,
+    SSO_CRC32_KERNEL_COUNT
+} sso_crc32_kernel_t;
+
+/* ================== CRC32 ================== */
+
+SSO_API uint32_t           sso_crc32(uint32_t crc, const void *data, size_t len);
+
+/*
+ * CRC of A followed by B from crc(A), crc(B) and the length of B, so chunks
+ * hashed independently (e.g. on several threads) can be merged in order.
+ */
+SSO_API uint32_t           sso_crc32_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b);
+
+/* ================== KERNEL SELECTION ================== */
+
+SSO_API sso_crc32_kernel_t sso_crc32_active_kernel(void);
+SSO_API int                sso_crc32_kernel_supported(sso_crc32_kernel_t kernel);
+/* Forces a kernel (mostly for benchmarks), SSO_CRC32_AUTO restores detection. Returns 1 if unsupported. */
+SSO_API int                sso_crc32_select_kernel(sso_crc32_kernel_t kernel);
+SSO_API const char        *sso_crc32_kernel_name(sso_crc32_kernel_t kernel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSO_CRC32_H */
@@ -1,7 +1,16 @@
 #ifndef IO_H
 #define IO_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include "sso.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 static inline int io_read_exact(FILE *f, void *buf, size_t n) {
     return fread(buf, 1, n, f) != n;
 }
@@ -10,4 +19,92 @@ static inline int io_write_exact(FILE *f, const void *buf, size_t n) {
     return fwrite(buf, 1, n, f) != n;
 }
 
+/* ================== READERS ================== */
+
+/*
+ * Byte source for the *_read_from loaders. Backends that hold the data in
+ * memory expose it as the window data[pos, size): sso_reader_read copies from
+ * there and bumps pos, and only calls ops->read when the window runs short
+ * (to refill it, or to report the end). Backends without a window leave data
+ * NULL and are called for every read.
+ *
+ * For a custom backend, zero the struct, set ops and ctx, and optionally
+ * point data/size at a buffer that ops->read refills.
+ */
+typedef struct sso_reader sso_reader_t;
+
+typedef struct {
+    int  (*read)(sso_reader_t *r, void *buf, size_t n);  /* exactly n bytes, 0 on success */
+    int  (*remaining)(sso_reader_t *r, uint64_t *out);   /* bytes left to read; may be NULL */
+    void (*close)(sso_reader_t *r);                      /* may be NULL */
+} sso_reader_ops_t;
+
+struct sso_reader {
+    const sso_reader_ops_t *ops;
+    const uint8_t          *data;
+    size_t                  size;
+    size_t                  pos;
+    void                   *ctx;
+};
+
+static inline int sso_reader_read(sso_reader_t *r, void *buf, size_t n) {
+    if (r->data && r->size - r->pos >= n) {
+        memcpy(buf, r->data + r->pos, n);
+        r->pos += n;
+        return 0;
+    }
+    return r->ops->read(r, buf, n);
+}
+
+/* `data` must outlive the reader; nothing is copied. */
+SSO_API void sso_reader_init_mem(sso_reader_t *r, const void *data, size_t size);
+/* Maps the whole file read-only; sso_reader_close unmaps it. */
+SSO_API int  sso_reader_open_mmap(sso_reader_t *r, const char *filename);
+/* Reads `fd` from `offset` with pread through an internal buffer; the fd stays open after close. */
+SSO_API int  sso_reader_init_fd(sso_reader_t *r, int fd, uint64_t offset);
+/* Reads from the current position of `f`; the FILE stays open after close. */
+SSO_API void sso_reader_init_stdio(sso_reader_t *r, FILE *f);
+
+SSO_API int  sso_reader_remaining(sso_reader_t *r, uint64_t *out);
+SSO_API void sso_reader_close(sso_reader_t *r);
+
+/* ================== WRITERS ================== */
+
+/*
+ * Byte sink for the *_write_to functions. The memory backend collects the
+ * output in data[0, size), which sso_writer_take hands over.
+ */
+typedef struct sso_writer sso_writer_t;
+
+typedef struct {
+    int  (*write)(sso_writer_t *w, const void *buf, size_t n);  /* all n bytes, 0 on success */
+    void (*close)(sso_writer_t *w);                             /* may be NULL */
+} sso_writer_ops_t;
+
+struct sso_writer {
+    const sso_writer_ops_t *ops;
+    uint8_t                *data;
+    size_t                  size;
+    size_t                  capacity;
+    void                   *ctx;
+};
+
+static inline int sso_writer_write(sso_writer_t *w, const void *buf, size_t n) {
+    return w->ops->write(w, buf, n);
+}
+
+/* Growing buffer from the library allocator. */
+SSO_API void  sso_writer_init_mem(sso_writer_t *w);
+/* Writes to `fd` at its current position; the fd stays open after close. */
+SSO_API void  sso_writer_init_fd(sso_writer_t *w, int fd);
+SSO_API void  sso_writer_init_stdio(sso_writer_t *w, FILE *f);
+
+/* Detaches a memory writer's buffer (release with sso_free; NULL if empty) and resets the writer. */
+SSO_API void *sso_writer_take(sso_writer_t *w, size_t *size);
+SSO_API void  sso_writer_close(sso_writer_t *w);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
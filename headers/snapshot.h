@@ -0,0 +1,108 @@
+#ifndef SSO_SNAPSHOT_H
+#define SSO_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sso.h"
+#include "text.h"
+#include "vf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Preparsed, position-independent image of a .text or .ccx file.
+ *
+ * Layout: a fixed header, `entry_count` fixed-width records, a hash table
+ * over the keys (text key or ccx file_path) and one string heap. Records
+ * refer to strings by heap offset, so the file is used exactly as mapped:
+ * opening is one mmap plus a bounds check of the header, with nothing to
+ * decode, unshift or relocate. Keys and values are stored de-obfuscated.
+ *
+ * Everything is little-endian. sso_snapshot_open only checks the header;
+ * call sso_snapshot_verify before trusting a snapshot from elsewhere.
+ */
+
+#define SSO_SNAPSHOT_VERSION 2u
+
+#define SSO_SNAPSHOT_TEXT 1u
+#define SSO_SNAPSHOT_VF   2u
+
+/* Heap offset of a string that was NULL in the source entry. */
+#define SSO_SNAPSHOT_NONE UINT32_MAX
+
+typedef struct sso_snapshot sso_snapshot_t;
+
+/* One .text entry; key is NUL-terminated, value is the decoded UTF-16LE bytes with their 00 00. */
+typedef struct {
+    uint32_t key;
+    uint32_t key_length;
+    uint32_t value;
+    uint32_t value_length;
+    uint8_t  unknown[2];
+    uint8_t  key_offset;
+    uint8_t  value_offset;
+    uint8_t  unknown2[4];
+    uint8_t  unknown3[4];
+    uint8_t  unknown4;
+    uint8_t  unknown5;
+    uint8_t  unknown6;
+    uint8_t  reserved;
+} sso_snapshot_text_record_t;
+
+/* One .ccx entry; name and path are NUL-terminated. */
+typedef struct {
+    uint32_t name;
+    uint32_t name_length;
+    uint32_t path;
+    uint32_t path_length;
+    uint8_t  unknown1[8];
+    uint8_t  original_crc[4];
+    uint8_t  exported_crc[4];
+    uint8_t  unknown2[4];
+    uint32_t file_size;
+    uint8_t  unknown4[8];
+    uint32_t source_file_number;
+    uint8_t  unknown5[4];
+} sso_snapshot_vf_record_t;
+
+/* ================== EXPORT ================== */
+
+SSO_API int sso_snapshot_write_text(const char *filename, const text_file_t *tf);
+SSO_API int sso_snapshot_write_vf(const char *filename, const vf_file_t *vf);
+
+/* ================== ACCESS ================== */
+
+SSO_API sso_snapshot_t *sso_snapshot_open(const char *filename);
+SSO_API void            sso_snapshot_close(sso_snapshot_t *s);
+
+/* Recomputes the content hash, which also covers the source header; returns 1 if the snapshot is corrupt. */
+SSO_API int             sso_snapshot_verify(const sso_snapshot_t *s);
+
+SSO_API uint32_t        sso_snapshot_kind(const sso_snapshot_t *s);
+SSO_API uint32_t        sso_snapshot_entry_count(const sso_snapshot_t *s);
+
+/* The source file's header, NULL if the snapshot is of the other kind. */
+SSO_API const text_header_t *sso_snapshot_text_header(const sso_snapshot_t *s);
+SSO_API const vf_header_t   *sso_snapshot_vf_header(const sso_snapshot_t *s);
+
+/* Records point into the mapping and stay valid until sso_snapshot_close. */
+SSO_API const sso_snapshot_text_record_t *sso_snapshot_text_record(const sso_snapshot_t *s, uint32_t index);
+SSO_API const sso_snapshot_vf_record_t   *sso_snapshot_vf_record(const sso_snapshot_t *s, uint32_t index);
+
+/* String at a record's heap offset, NULL for SSO_SNAPSHOT_NONE or out of range. */
+SSO_API const char     *sso_snapshot_string(const sso_snapshot_t *s, uint32_t offset);
+
+/* Lowest entry index whose key (text) or file_path (ccx) equals `key`. */
+SSO_API int             sso_snapshot_find(const sso_snapshot_t *s, const char *key, size_t len, uint32_t *out);
+
+/* Owned copies of one entry, release with text_entry_free / vf_entry_free. */
+SSO_API text_entry_t   *sso_snapshot_clone_text_entry(const sso_snapshot_t *s, uint32_t index);
+SSO_API vf_entry_t     *sso_snapshot_clone_vf_entry(const sso_snapshot_t *s, uint32_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSO_SNAPSHOT_H */
@@ -0,0 +1,14 @@
+#ifndef SSO_H
+#define SSO_H
+
+#ifdef _WIN32
+    #ifdef SSO_BUILD_DLL
+        #define SSO_API __declspec(dllexport)
+    #else
+        #define SSO_API __declspec(dllimport)
+    #endif
+#else
+    #define SSO_API
+#endif
+
+#endif /* SSO_H */
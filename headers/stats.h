@@ -0,0 +1,72 @@
+#ifndef SSO_STATS_H
+#define SSO_STATS_H
+
+#include <stdint.h>
+#include "sso.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Opt-in load counters and tracing hooks.
+ *
+ * Collection only exists when the library is built with SSO_ENABLE_STATS
+ * (CMake option of the same name); otherwise every probe compiles to nothing
+ * and the functions below are inert, with sso_stats_compiled_in() returning 0.
+ *
+ * Counters are per thread. Each top-level operation (text_file_read,
+ * vf_file_read and their _arena, _mem, _from, _parallel, _cached and mapped
+ * variants, the index builds) adds to the calling thread's running total and
+ * also leaves its own figures in the "last call" record. Mapped loads count
+ * the whole image as read; work done on pool threads is not attributed. Phase times are only taken after sso_stats_set_flags(SSO_STATS_TIMING)
+ * on that thread, since they cost a clock read around every piece of work.
+ */
+
+/* sso_stats_set_flags bits. */
+#define SSO_STATS_TIMING 0x1u
+
+typedef struct {
+    uint64_t calls;          /* top-level operations recorded */
+    uint64_t bytes_read;     /* bytes taken from files */
+    uint64_t entries_parsed;
+    uint64_t alloc_count;    /* blocks requested through the library allocator */
+    uint64_t alloc_bytes;
+    uint64_t io_ns;          /* reading, with SSO_STATS_TIMING */
+    uint64_t decode_ns;      /* shift_bytes de-obfuscation, with SSO_STATS_TIMING */
+    uint64_t alloc_ns;       /* time inside the library allocator, with SSO_STATS_TIMING */
+    uint64_t index_ns;       /* lookup index builds, with SSO_STATS_TIMING */
+} sso_stats_t;
+
+/*
+ * Called around every instrumented operation, nested ones included, on the
+ * thread doing the work. `name` is the public function name; `delta` is what
+ * the operation added to the thread's counters.
+ */
+typedef void (*sso_trace_begin_fn)(void *user, const char *name);
+typedef void (*sso_trace_end_fn)(void *user, const char *name, const sso_stats_t *delta);
+
+/* ================== COUNTERS ================== */
+
+SSO_API int  sso_stats_compiled_in(void);
+
+/* Per-thread collection flags (SSO_STATS_TIMING); counters are always kept when compiled in. */
+SSO_API void sso_stats_set_flags(uint32_t flags);
+
+/* Running total of the calling thread since its start or the last reset. */
+SSO_API void sso_stats_thread_get(sso_stats_t *out);
+SSO_API void sso_stats_thread_reset(void);
+
+/* Figures of the calling thread's most recent top-level operation. */
+SSO_API void sso_stats_last_call(sso_stats_t *out);
+
+/* ================== TRACING ================== */
+
+/* Process-wide; install before loading on other threads. NULL functions are skipped. */
+SSO_API void sso_stats_set_hooks(sso_trace_begin_fn begin, sso_trace_end_fn end, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSO_STATS_H */
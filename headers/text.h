@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include "io.h"
+#include "alloc.h"
 
 #ifdef _WIN32
     #ifdef TEXT_BUILD_DLL
@@ -43,13 +44,61 @@ typedef struct {
 
     uint8_t  value_offset;
     char    *value;
+
+    uint8_t  flags;
 } text_entry_t;
 
+/* text_entry_t.flags: string is owned by the file's arena, not by the entry. */
+#define TEXT_ENTRY_KEY_BORROWED   0x01
+#define TEXT_ENTRY_VALUE_BORROWED 0x02
+
+struct sso_arena;
+struct text_index;
+
 typedef struct {
-    text_header_t header;
-    text_entry_t *entries;
+    text_header_t      header;
+    text_entry_t      *entries;
+    struct sso_arena  *arena;
+    struct text_index *index;
 } text_file_t;
 
+/*
+ * Handle to a memory-mapped .text file. Only an offset table is built on
+ * open; keys and values are de-obfuscated in place the first time they are
+ * accessed, on private copy-on-write pages.
+ */
+typedef struct text_mapped text_mapped_t;
+
+/* Non-owning view into a mapped file. Keys are not NUL-terminated. */
+typedef struct {
+    const char *data;
+    uint32_t    length;
+} text_view_t;
+
+/*
+ * Keys in byte order, as ranks into a permutation of the entry array.
+ * Built from a snapshot of the keys: rebuild after adding, removing or
+ * renaming entries.
+ */
+typedef struct text_sorted text_sorted_t;
+
+/*
+ * Pull-style single pass over a .text file. One entry buffer is reused for
+ * every call, so memory is bounded by the largest entry plus the read-ahead
+ * buffer.
+ */
+typedef struct text_reader text_reader_t;
+
+/*
+ * UTF-8 copies of every value of a file in one allocation. Value i is
+ * NUL-terminated at data + offsets[i]; offsets has count + 1 elements.
+ */
+typedef struct {
+    char     *data;
+    uint32_t *offsets;
+    uint32_t  count;
+} text_utf8_table_t;
+
 /* ================== INTERNAL STRUCT I/O ================== */
 
 int         text_header_read(FILE *f, text_header_t *h);
@@ -60,10 +109,110 @@ int         text_entry_write(FILE *f, const text_entry_t *e);
 
 /* ================== CORE PUBLIC API ================== */
 
+/* Empty file to fill through the entry management functions; release with text_file_free. */
+TEXT_API text_file_t *text_file_create(void);
 TEXT_API text_file_t *text_file_read(const char *filename);
+/* Same as text_file_read, but all strings share a few arena blocks released at once by text_file_free. */
+TEXT_API text_file_t *text_file_read_arena(const char *filename);
 TEXT_API int          text_file_write(const char *filename, const text_file_t *tf);
 TEXT_API void         text_file_free(text_file_t *tf);
 
+/*
+ * Parse an image already in memory, or from any reader backend (see io.h),
+ * positioned at the header. Both load in arena mode; strings are copied, so
+ * `data` may be released once the call returns. The reader is not closed.
+ */
+TEXT_API text_file_t *text_file_read_mem(const void *data, size_t size);
+TEXT_API text_file_t *text_file_read_from(sso_reader_t *r);
+/* Encodes the file and hands it to `w` in a single write. */
+TEXT_API int          text_file_write_to(sso_writer_t *w, const text_file_t *tf);
+
+/*
+ * text_file_read / text_file_free with `a` as the allocator for the duration
+ * of the call. Free a file under the allocator it was read with.
+ */
+TEXT_API text_file_t *text_file_read_with(const char *filename, const sso_allocator_t *a);
+TEXT_API void         text_file_free_with(text_file_t *tf, const sso_allocator_t *a);
+
+/*
+ * Scans all length fields first, then decodes entries on `nthreads` threads
+ * (0 = one per CPU). Produces the same layout as text_file_read. Files over
+ * 4 GiB are loaded with text_file_read on the calling thread.
+ */
+TEXT_API text_file_t *text_file_read_parallel(const char *filename, unsigned nthreads);
+
+/*
+ * Like text_file_read, with the entry offsets and key index kept in a
+ * "<filename>.ssoidx" sidecar. A sidecar matching the file's size, mtime and
+ * content hash replaces the length scan and the key index build; a missing,
+ * stale or corrupt one is rebuilt. The file is still hashed in full to check
+ * the sidecar and every entry is still decoded, so the saving is the index
+ * build, not the I/O. The returned file already has its key index.
+ */
+TEXT_API text_file_t *text_file_read_cached(const char *filename);
+
+/* ================== MAPPED READER ================== */
+
+TEXT_API text_mapped_t       *text_file_open_mapped(const char *filename);
+/* Takes the offset table from the ".ssoidx" sidecar, as text_file_read_cached does. */
+TEXT_API text_mapped_t       *text_file_open_mapped_cached(const char *filename);
+TEXT_API void                 text_mapped_close(text_mapped_t *tm);
+
+TEXT_API const text_header_t *text_mapped_header(const text_mapped_t *tm);
+TEXT_API uint32_t             text_mapped_entry_count(const text_mapped_t *tm);
+
+/* Views stay valid until text_mapped_close. Decoding on first access makes these non-thread-safe. */
+TEXT_API int                  text_mapped_get_key(text_mapped_t *tm, uint32_t index, text_view_t *out);
+TEXT_API int                  text_mapped_get_value(text_mapped_t *tm, uint32_t index, text_view_t *out);
+
+/* Owned copy of one entry, release with text_entry_free. */
+TEXT_API text_entry_t        *text_mapped_clone_entry(text_mapped_t *tm, uint32_t index);
+
+/* ================== STREAMING READER ================== */
+
+/* buffer_size is the stdio read-ahead in bytes, 0 picks 64 KiB. */
+TEXT_API text_reader_t       *text_reader_open(const char *filename, size_t buffer_size);
+TEXT_API void                 text_reader_close(text_reader_t *r);
+TEXT_API const text_header_t *text_reader_header(const text_reader_t *r);
+
+/*
+ * Returns 0 and the next entry, valid until the next call or close.
+ * Returns 1 at the end of the file or on error; text_reader_failed tells which.
+ */
+TEXT_API int                  text_reader_next(text_reader_t *r, const text_entry_t **out);
+TEXT_API int                  text_reader_failed(const text_reader_t *r);
+
+/* ================== KEY INDEX ================== */
+
+/*
+ * Open-addressing hash index over the entry keys. It follows
+ * text_file_add_entry / text_file_remove_entry / text_file_resize;
+ * rebuild it after renaming keys with text_entry_set_key. Without an
+ * index the find functions fall back to a linear scan. If keys repeat,
+ * one of the matching entries is returned.
+ */
+TEXT_API int           text_file_build_index(text_file_t *tf);
+TEXT_API void          text_file_drop_index(text_file_t *tf);
+
+TEXT_API text_entry_t *text_file_find(text_file_t *tf, const char *key, size_t len);
+TEXT_API int           text_file_find_index(const text_file_t *tf, const char *key, size_t len, uint32_t *out);
+
+/* ================== SORTED KEY INDEX ================== */
+
+TEXT_API text_sorted_t *text_sorted_build(const text_file_t *tf);
+TEXT_API void           text_sorted_free(text_sorted_t *ts);
+
+TEXT_API uint32_t       text_sorted_count(const text_sorted_t *ts);
+/* Entry index (for text_file_get_entry) at a rank, UINT32_MAX if out of range. */
+TEXT_API uint32_t       text_sorted_entry(const text_sorted_t *ts, uint32_t rank);
+
+/* First rank whose key is >= key, resp. > key. */
+TEXT_API uint32_t       text_sorted_lower_bound(const text_sorted_t *ts, const char *key, size_t len);
+TEXT_API uint32_t       text_sorted_upper_bound(const text_sorted_t *ts, const char *key, size_t len);
+/* Ranks [*first, *last) of all keys starting with prefix. */
+TEXT_API int            text_sorted_prefix_range(const text_sorted_t *ts, const char *prefix, size_t len,
+                                                 uint32_t *first, uint32_t *last);
+
 /* ================== STRING ACCESSORS ================== */
 
 TEXT_API void        text_entry_set_key(text_entry_t *e, const char *key);
@@ -72,6 +221,21 @@ TEXT_API const char *text_entry_get_key(const text_entry_t *e);
 TEXT_API void        text_entry_set_value(text_entry_t *e, const char *value);
 TEXT_API const char *text_entry_get_value(const text_entry_t *e);
 
+/* ================== UTF-8 TRANSCODING ================== */
+
+/*
+ * Writes the value as NUL-terminated UTF-8. *out_len always receives the
+ * UTF-8 length (without NUL); returns 1 if out is NULL or smaller than that + 1.
+ * An entry without a value reads as the empty string.
+ */
+TEXT_API int         text_entry_get_value_utf8(const text_entry_t *e, char *out, size_t out_size, size_t *out_len);
+/* Stores UTF-8 input as a UTF-16LE value with its 00 00 terminator. */
+TEXT_API int         text_entry_set_value_utf8(text_entry_t *e, const char *utf8, size_t len);
+
+TEXT_API int         text_file_transcode_all(const text_file_t *tf, text_utf8_table_t *out);
+TEXT_API const char *text_utf8_table_get(const text_utf8_table_t *t, uint32_t index, size_t *len);
+TEXT_API void        text_utf8_table_free(text_utf8_table_t *t);
+
 /* ================== ENTRY LIFECYCLE ================== */
 
 TEXT_API text_entry_t *text_entry_create(void);
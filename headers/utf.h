@@ -0,0 +1,35 @@
+#ifndef UTF_H
+#define UTF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sso.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * UTF-16LE <-> UTF-8 transcoding for .text values. Sources are byte
+ * pointers without alignment requirements. Unpaired surrogates and
+ * malformed UTF-8 are replaced with U+FFFD. Vector kernels (ASCII and
+ * two-byte fast paths) are selected at runtime like the shift codec.
+ */
+
+/* Exact UTF-8 size of `units` UTF-16LE code units. */
+SSO_API size_t sso_utf16le_to_utf8_length(const void *src, size_t units);
+
+/* Writes no terminator. Returns bytes written, or SIZE_MAX if dst_size is too small; NULL src with 0 units is empty. */
+SSO_API size_t sso_utf16le_to_utf8(const void *src, size_t units, char *dst, size_t dst_size);
+
+/* Exact number of UTF-16 code units `len` bytes of UTF-8 decode to. */
+SSO_API size_t sso_utf8_to_utf16le_length(const char *src, size_t len);
+
+/* Writes no terminator. Returns code units written, or SIZE_MAX if dst_units is too small; NULL src with 0 len is empty. */
+SSO_API size_t sso_utf8_to_utf16le(const char *src, size_t len, void *dst, size_t dst_units);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UTF_H */
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include "io.h"
+#include "alloc.h"
 
 #ifdef _WIN32
     #ifdef VF_BUILD_DLL
@@ -38,13 +39,211 @@ typedef struct {
     uint32_t source_file_number;
     uint8_t  unknown5[4];
     char    *file_path;
+
+    uint8_t  flags;
 } vf_entry_t;
 
+/* vf_entry_t.flags: string is owned by the file's arena, not by the entry. */
+#define VF_ENTRY_NAME_BORROWED 0x01
+#define VF_ENTRY_PATH_BORROWED 0x02
+
+struct sso_arena;
+struct vf_index;
+
 typedef struct {
-    vf_header_t header;
-    vf_entry_t *entries;
+    vf_header_t       header;
+    vf_entry_t       *entries;
+    struct sso_arena *arena;
+    struct vf_index  *index;
+    uint32_t          capacity;  /* slots allocated in entries */
 } vf_file_t;
 
+/* Selects entries for vf_file_remove_if; `index` is the entry's position before any removal. */
+typedef int (*vf_entry_pred_fn)(void *ctx, const vf_entry_t *e, uint32_t index);
+
+/*
+ * Handle to a memory-mapped, read-only .ccx manifest. Opening validates
+ * every entry once and builds one fixed-size record per entry; names and
+ * paths are then served straight from the mapping. Safe to share between
+ * threads.
+ */
+typedef struct vf_mapped vf_mapped_t;
+
+/* Non-owning view into a mapped file. Strings are not NUL-terminated. */
+typedef struct {
+    const char *data;
+    uint32_t    length;
+} vf_view_t;
+
+/* One mapped entry: string positions relative to the mapping, fixed fields decoded. */
+typedef struct {
+    uint32_t name_pos;
+    uint32_t name_len;
+    uint32_t path_pos;
+    uint32_t path_len;
+    uint8_t  unknown1[8];
+    uint8_t  original_crc[4];
+    uint8_t  exported_crc[4];
+    uint8_t  unknown2[4];
+    uint32_t file_size;
+    uint8_t  unknown4[8];
+    uint32_t source_file_number;
+    uint8_t  unknown5[4];
+} vf_record_t;
+
+/*
+ * Read-only manifest with paths split into an interned directory tree and
+ * names, strings and repeated fixed-block bytes stored once. Paths are
+ * rebuilt on demand. Safe to share between threads.
+ */
+typedef struct vf_compact vf_compact_t;
+
+#define VF_COMPACT_NONE      UINT32_MAX   /* no directory / string */
+#define VF_COMPACT_VERBATIM  0x80000000u  /* vf_compact_record_t.leaf holds the whole path */
+
+/* One compact entry; string ids resolve through vf_compact_string. */
+typedef struct {
+    uint32_t dir;    /* directory holding the entry, VF_COMPACT_NONE without a path */
+    uint32_t leaf;   /* last path segment, or the whole path if its separators are mixed */
+    uint32_t name;   /* file_name */
+    uint32_t extra;  /* interned unknown1/2/4/5 bytes, see vf_compact_clone_entry */
+    uint8_t  original_crc[4];
+    uint8_t  exported_crc[4];
+    uint32_t file_size;
+    uint32_t source_file_number;
+} vf_compact_record_t;
+
+/*
+ * Column-per-field copy of a manifest for scans that touch one or two fields.
+ * CRCs are the little-endian field values. Paths, then names, are stored
+ * NUL-terminated in `strings`; the offset arrays hold count + 1 entries so a
+ * length is the difference minus one, and missing strings are stored empty.
+ * Every array lives in `block`, each column 64-byte aligned.
+ */
+typedef struct {
+    uint32_t  count;
+    uint32_t *file_size;
+    uint32_t *original_crc;
+    uint32_t *exported_crc;
+    uint32_t *source_file_number;
+    uint32_t *path_offset;
+    uint32_t *name_offset;
+    char     *strings;
+    size_t    strings_size;
+    void     *block;
+} vf_columns_t;
+
+/* Unsigned comparison for vf_columns_filter: column[i] <op> value. */
+typedef enum {
+    VF_CMP_EQ = 0,
+    VF_CMP_NE,
+    VF_CMP_LT,
+    VF_CMP_LE,
+    VF_CMP_GT,
+    VF_CMP_GE
+} vf_cmp_t;
+
+/* vf_diff_change_t.changes bits; resized and CRC-changed can come together. */
+#define VF_DIFF_ADDED        0x01u
+#define VF_DIFF_REMOVED      0x02u
+#define VF_DIFF_RESIZED      0x04u
+#define VF_DIFF_CRC_CHANGED  0x08u  /* original_crc or exported_crc differs */
+
+#define VF_DIFF_NONE         UINT32_MAX  /* no entry on that side */
+
+/* One change between two manifests, entries paired by exact file_path. */
+typedef struct {
+    uint32_t old_index;
+    uint32_t new_index;
+    uint32_t changes;
+} vf_diff_change_t;
+
+/* Change list plus per-category counts; an entry both resized and re-hashed counts in both. */
+typedef struct {
+    vf_diff_change_t *changes;
+    uint32_t          count;
+    uint32_t          capacity;
+    uint32_t          added;
+    uint32_t          removed;
+    uint32_t          resized;
+    uint32_t          crc_changed;
+    uint32_t          unchanged;
+} vf_diff_t;
+
+/*
+ * Receives each change as it is found, with the entries on both sides (NULL
+ * for the missing one); entries are only valid during the call. Returning
+ * nonzero stops the diff, a negative value makes it report failure.
+ */
+typedef int (*vf_diff_fn)(void *ctx, const vf_diff_change_t *change, const vf_entry_t *old_e,
+                          const vf_entry_t *new_e);
+
+/* Per-entry outcome of vf_verify_tree. */
+typedef enum {
+    VF_VERIFY_OK = 0,
+    VF_VERIFY_MISSING,
+    VF_VERIFY_SIZE_MISMATCH,
+    VF_VERIFY_CRC_MISMATCH,
+    VF_VERIFY_READ_ERROR
+} vf_verify_status_t;
+
+/* Which manifest CRC the file contents are compared against. */
+typedef enum {
+    VF_VERIFY_CRC_ORIGINAL = 0,
+    VF_VERIFY_CRC_EXPORTED,
+    VF_VERIFY_CRC_EITHER,
+    VF_VERIFY_CRC_NONE
+} vf_verify_crc_t;
+
+/*
+ * Persistent map from file path to (dev, inode, size, mtime, ctime, CRC).
+ * Files whose metadata still matches are not read again.
+ */
+typedef struct vf_verify_cache vf_verify_cache_t;
+
+/* Zero-initialised options verify original_crc with 1 MiB reads on every CPU, without a cache. */
+typedef struct {
+    unsigned           nthreads;
+    vf_verify_crc_t    crc;
+    size_t             read_size;
+    int                use_mmap;
+    vf_verify_cache_t *cache;
+} vf_verify_opts_t;
+
+/*
+ * Zero-initialised options hash with 1 MiB reads on every CPU, join path
+ * segments with a backslash and number entries from 0, without a cache. The
+ * header's magic and version are copied into the result.
+ */
+typedef struct {
+    unsigned           nthreads;
+    size_t             read_size;
+    int                use_mmap;
+    char               separator;
+    uint32_t           first_source_number;
+    vf_header_t        header;
+    vf_verify_cache_t *cache;
+} vf_build_opts_t;
+
+typedef struct {
+    uint8_t  *status;     /* vf_verify_status_t per entry */
+    uint32_t *crc;        /* computed CRC per entry, 0 if the file was not hashed */
+    uint32_t  count;
+    uint32_t  ok;
+    uint32_t  missing;
+    uint32_t  size_mismatch;
+    uint32_t  crc_mismatch;
+    uint32_t  read_errors;
+    uint32_t  cache_hits;
+    uint64_t  bytes_hashed;
+} vf_verify_report_t;
+
+/*
+ * Pull-style single pass over a .ccx file. One entry buffer is reused for
+ * every call, so memory is bounded by the longest entry plus the read-ahead
+ * buffer.
+ */
+typedef struct vf_reader vf_reader_t;
 
 int        vf_header_read(FILE *f, vf_header_t *h);
 int        vf_header_write(FILE *f, const vf_header_t *h);
@@ -54,10 +253,201 @@ int        vf_entry_write(FILE *f, const vf_entry_t *e);
 
 /* ================== CORE PUBLIC API ================== */
 
+/* Empty manifest to fill through the entry management functions; release with vf_file_free. */
+VF_API vf_file_t *vf_file_create(void);
 VF_API vf_file_t *vf_file_read(const char *filename);
+/* Same as vf_file_read, but all strings share a few arena blocks released at once by vf_file_free. */
+VF_API vf_file_t *vf_file_read_arena(const char *filename);
+/*
+ * Like vf_file_read_arena, with the entry offsets and lookup index kept in a
+ * "<filename>.ssoidx" sidecar. A sidecar matching the file's size, mtime and
+ * content hash replaces the scan, the path hashing and the index build; a
+ * missing, stale or corrupt one is rebuilt. The file is still hashed in full
+ * to check the sidecar and every entry is still copied out. The returned
+ * file already has its lookup index.
+ */
+VF_API vf_file_t *vf_file_read_cached(const char *filename);
 VF_API int        vf_file_write(const char *filename, const vf_file_t *vf);
 VF_API void       vf_file_free(vf_file_t *vf);
 
+/*
+ * Parse an image already in memory, or from any reader backend (see io.h),
+ * positioned at the header. Both load in arena mode; strings are copied, so
+ * `data` may be released once the call returns. The reader is not closed.
+ */
+VF_API vf_file_t *vf_file_read_mem(const void *data, size_t size);
+VF_API vf_file_t *vf_file_read_from(sso_reader_t *r);
+/* Encodes the manifest and hands it to `w` in a single write. */
+VF_API int        vf_file_write_to(sso_writer_t *w, const vf_file_t *vf);
+
+/*
+ * vf_file_read / vf_file_free with `a` as the allocator for the duration of
+ * the call. Free a file under the allocator it was read with.
+ */
+VF_API vf_file_t *vf_file_read_with(const char *filename, const sso_allocator_t *a);
+VF_API void       vf_file_free_with(vf_file_t *vf, const sso_allocator_t *a);
+
+/* ================== BATCH LOADING ================== */
+
+/*
+ * Loads n manifests with vf_file_read on `nthreads` threads (0 = one per
+ * CPU). Returns an array of n files, NULL where a path failed to load;
+ * release everything with vf_files_free.
+ */
+VF_API vf_file_t **vf_files_read_many(const char *const *paths, size_t n, unsigned nthreads);
+VF_API void        vf_files_free(vf_file_t **files, size_t n);
+
+/* ================== MAPPED READER ================== */
+
+VF_API vf_mapped_t       *vf_file_open_mapped(const char *filename);
+VF_API void               vf_mapped_close(vf_mapped_t *vm);
+
+VF_API const vf_header_t *vf_mapped_header(const vf_mapped_t *vm);
+VF_API uint32_t           vf_mapped_entry_count(const vf_mapped_t *vm);
+
+/* Record array and the mapping its positions refer to, valid until vf_mapped_close. */
+VF_API const vf_record_t *vf_mapped_records(const vf_mapped_t *vm);
+VF_API const char        *vf_mapped_data(const vf_mapped_t *vm);
+
+VF_API const vf_record_t *vf_mapped_record(const vf_mapped_t *vm, uint32_t index);
+VF_API int                vf_mapped_get_name(const vf_mapped_t *vm, uint32_t index, vf_view_t *out);
+VF_API int                vf_mapped_get_path(const vf_mapped_t *vm, uint32_t index, vf_view_t *out);
+
+/* Owned copy of one entry, release with vf_entry_free. */
+VF_API vf_entry_t        *vf_mapped_clone_entry(const vf_mapped_t *vm, uint32_t index);
+
+/* ================== STREAMING READER ================== */
+
+/* buffer_size is the stdio read-ahead in bytes, 0 picks 64 KiB. */
+VF_API vf_reader_t       *vf_reader_open(const char *filename, size_t buffer_size);
+VF_API void               vf_reader_close(vf_reader_t *r);
+VF_API const vf_header_t *vf_reader_header(const vf_reader_t *r);
+
+/*
+ * Returns 0 and the next entry, valid until the next call or close.
+ * Returns 1 at the end of the file or on error; vf_reader_failed tells which.
+ */
+VF_API int                vf_reader_next(vf_reader_t *r, const vf_entry_t **out);
+VF_API int                vf_reader_failed(const vf_reader_t *r);
+
+/* ================== COMPACT MANIFESTS ================== */
+
+VF_API vf_compact_t              *vf_compact_build(const vf_file_t *vf);
+/* Streams the file straight into compact form; no vf_file_t is ever held. */
+VF_API vf_compact_t              *vf_compact_read(const char *filename);
+VF_API void                       vf_compact_free(vf_compact_t *vc);
+
+VF_API const vf_header_t         *vf_compact_header(const vf_compact_t *vc);
+VF_API uint32_t                   vf_compact_entry_count(const vf_compact_t *vc);
+/* Bytes of heap the compact form holds. */
+VF_API size_t                     vf_compact_memory(const vf_compact_t *vc);
+
+VF_API const vf_compact_record_t *vf_compact_record(const vf_compact_t *vc, uint32_t index);
+VF_API const char                *vf_compact_string(const vf_compact_t *vc, uint32_t id, uint32_t *len);
+VF_API const char                *vf_compact_get_name(const vf_compact_t *vc, uint32_t index);
+
+/*
+ * Writes the entry's file_path, NUL-terminated. *out_len always receives the
+ * path length (without NUL); returns 1 if out is NULL or smaller than that + 1.
+ */
+VF_API int                        vf_compact_get_path(const vf_compact_t *vc, uint32_t index, char *out,
+                                                      size_t out_size, size_t *out_len);
+
+/* Owned copy of one entry, release with vf_entry_free. */
+VF_API vf_entry_t                *vf_compact_clone_entry(const vf_compact_t *vc, uint32_t index);
+
+/*
+ * Directories are numbered in preorder from the root (0). Lookups accept
+ * either separator and ignore one trailing separator.
+ */
+VF_API int                        vf_compact_find_dir(const vf_compact_t *vc, const char *path, size_t len,
+                                                      uint32_t *out);
+VF_API uint32_t                   vf_compact_dir_count(const vf_compact_t *vc);
+VF_API uint32_t                   vf_compact_dir_parent(const vf_compact_t *vc, uint32_t dir);
+VF_API const char                *vf_compact_dir_name(const vf_compact_t *vc, uint32_t dir, uint32_t *len);
+/* Subdirectory iteration, VF_COMPACT_NONE when there are no more. */
+VF_API uint32_t                   vf_compact_dir_first_child(const vf_compact_t *vc, uint32_t dir);
+VF_API uint32_t                   vf_compact_dir_next_sibling(const vf_compact_t *vc, uint32_t dir);
+
+/*
+ * Entry indices directly inside `dir`, or anywhere below it if `recursive`,
+ * ascending within each directory. The array is owned by vc.
+ */
+VF_API const uint32_t            *vf_compact_dir_entries(const vf_compact_t *vc, uint32_t dir, int recursive,
+                                                         uint32_t *count);
+
+/* ================== COLUMNAR VIEW ================== */
+
+VF_API int         vf_file_to_columns(const vf_file_t *vf, vf_columns_t *out);
+VF_API void        vf_columns_free(vf_columns_t *c);
+VF_API const char *vf_columns_path(const vf_columns_t *c, uint32_t index, uint32_t *len);
+VF_API const char *vf_columns_name(const vf_columns_t *c, uint32_t index, uint32_t *len);
+
+/*
+ * Indices of matching rows, ascending, written to `out` (room for `count`
+ * needed); with out NULL the matches are only counted. Uses AVX2 when the
+ * CPU has it.
+ */
+VF_API uint32_t    vf_columns_filter(const uint32_t *column, uint32_t count, vf_cmp_t op, uint32_t value,
+                                     uint32_t *out);
+/* Rows whose path starts with `prefix`; a folder path plus its trailing separator selects everything under it. */
+VF_API uint32_t    vf_columns_filter_prefix(const vf_columns_t *c, const char *prefix, size_t len, uint32_t *out);
+
+VF_API uint64_t    vf_columns_sum(const uint32_t *column, uint32_t count);
+VF_API uint64_t    vf_columns_sum_selected(const uint32_t *column, const uint32_t *indices, uint32_t n);
+/* bins[k] counts values with bit length k: bins[0] is zeros, bins[k] covers [2^(k-1), 2^k). */
+VF_API void        vf_columns_histogram_log2(const uint32_t *column, uint32_t count, uint64_t bins[33]);
+
+/* ================== MANIFEST DIFF ================== */
+
+/*
+ * Hash join on file_path: old paths go into a table, new entries probe it.
+ * Changes come in new-file order, then removals in old-file order; duplicate
+ * paths pair up in order. Release the result with vf_diff_free.
+ */
+VF_API int  vf_diff(const vf_file_t *old_vf, const vf_file_t *new_vf, vf_diff_t *out);
+VF_API void vf_diff_free(vf_diff_t *d);
+
+/* Streaming forms; `counts` (may be NULL) gets the totals, its change array is left empty. */
+VF_API int  vf_diff_each(const vf_file_t *old_vf, const vf_file_t *new_vf, vf_diff_fn fn, void *ctx,
+                         vf_diff_t *counts);
+/* Reads the new manifest entry by entry, so only the old one is ever held in memory. */
+VF_API int  vf_diff_each_file(const vf_file_t *old_vf, const char *new_filename, vf_diff_fn fn, void *ctx,
+                              vf_diff_t *counts);
+
+/* ================== VERIFICATION ================== */
+
+/*
+ * Checks every entry's file_path, joined onto root_dir, against file_size
+ * and a manifest CRC. Files are stat'ed and hashed on a worker pool. opts
+ * may be NULL. Returns 0 once every entry has a status, even if some fail;
+ * release the report with vf_verify_report_free.
+ */
+VF_API int  vf_verify_tree(const vf_file_t *vf, const char *root_dir, const vf_verify_opts_t *opts,
+                           vf_verify_report_t *report);
+VF_API void vf_verify_report_free(vf_verify_report_t *report);
+
+/*
+ * Opens (or starts, if missing or damaged) a verification cache file. Pass it
+ * through vf_verify_opts_t.cache; vf_verify_tree reads it and records newly
+ * hashed files, vf_verify_cache_save writes it back atomically.
+ */
+VF_API vf_verify_cache_t *vf_verify_cache_open(const char *filename);
+VF_API int                vf_verify_cache_save(const vf_verify_cache_t *c);
+VF_API uint32_t           vf_verify_cache_count(const vf_verify_cache_t *c);
+VF_API void               vf_verify_cache_close(vf_verify_cache_t *c);
+
+/* ================== MANIFEST BUILDING ================== */
+
+/*
+ * Walks root_dir (one pool round per directory level), then stats and
+ * CRC32s every regular file on the pool. Entries come out in byte order of
+ * their relative paths, with both CRC fields set and source_file_number
+ * counting up in that order, ready for vf_file_write. Symlinked directories
+ * are not followed. Returns NULL if any directory or file cannot be read.
+ */
+VF_API vf_file_t *vf_file_build_from_dir(const char *root_dir, const vf_build_opts_t *opts);
+
 /* ================== STRING ACCESSORS ================== */
 
 VF_API void        vf_entry_set_name(vf_entry_t *e, const char *name);
@@ -80,6 +470,47 @@ VF_API int         vf_file_add_entry(vf_file_t *vf, const vf_entry_t *src);
 VF_API int         vf_file_remove_entry(vf_file_t *vf, uint32_t index);
 VF_API int         vf_file_resize(vf_file_t *vf, uint32_t new_count);
 
+/*
+ * The entry array grows geometrically and keeps its slots when entries are
+ * removed; vf_file_reserve sizes it up front and vf_file_shrink_to_fit hands
+ * the spare slots back.
+ */
+VF_API int         vf_file_reserve(vf_file_t *vf, uint32_t capacity);
+VF_API int         vf_file_shrink_to_fit(vf_file_t *vf);
+
+/*
+ * Moves `e` into the file without copying its strings; the file owns them
+ * afterwards and `e` is left zeroed. Borrowed strings must come from this
+ * file's arena.
+ */
+VF_API int         vf_file_append_take(vf_file_t *vf, vf_entry_t *e);
+
+/* Removes every entry `pred` returns nonzero for, in one pass; returns how many went. */
+VF_API uint32_t    vf_file_remove_if(vf_file_t *vf, vf_entry_pred_fn pred, void *ctx);
+
+/* ================== LOOKUP INDEX ================== */
+
+/*
+ * Open-addressing hash tables over file_path, file_name and
+ * source_file_number. vf_file_add_entry, vf_file_remove_entry and
+ * vf_file_resize keep the index current; renaming an entry or changing its
+ * source number in place needs another vf_index_build. Without an index the
+ * find functions fall back to a linear scan.
+ */
+VF_API int      vf_index_build(vf_file_t *vf);
+VF_API void     vf_index_drop(vf_file_t *vf);
+
+/* Lowest entry index with this exact path. */
+VF_API int      vf_index_find_path(const vf_file_t *vf, const char *path, size_t len, uint32_t *out);
+
+/*
+ * Names and source numbers repeat, so these return how many entries match
+ * and store the first `max` of them, in ascending order, in `out`.
+ */
+VF_API uint32_t vf_index_find_name(const vf_file_t *vf, const char *name, size_t len, uint32_t *out, uint32_t max);
+VF_API uint32_t vf_index_find_source(const vf_file_t *vf, uint32_t source_file_number, uint32_t *out,
+                                     uint32_t max);
+
 /* ================== FIELD GETTERS / SETTERS ================== */
 
 VF_API uint32_t    vf_entry_get_file_size(const vf_entry_t *e);
@@ -36,6 +36,7 @@ class TextEntry(ctypes.Structure):
         ("unknown6", ctypes.c_uint8),
         ("value_offset", ctypes.c_uint8),
         ("value", ctypes.c_void_p), #Because cpython
+        ("flags", ctypes.c_uint8),
     ]
 
 
@@ -46,6 +47,8 @@ class TextFile(ctypes.Structure):
     _fields_ = [
         ("header", TextHeader),
         ("entries", ctypes.POINTER(TextEntry)),
+        ("arena", ctypes.c_void_p),
+        ("index", ctypes.c_void_p),
     ]
 
 
@@ -55,6 +58,15 @@ class TextFile(ctypes.Structure):
 text.text_file_read.argtypes = [ctypes.c_char_p]
 text.text_file_read.restype  = ctypes.POINTER(TextFile)
 
+text.text_file_read_arena.argtypes = [ctypes.c_char_p]
+text.text_file_read_arena.restype  = ctypes.POINTER(TextFile)
+
+text.text_file_read_parallel.argtypes = [ctypes.c_char_p, ctypes.c_uint]
+text.text_file_read_parallel.restype  = ctypes.POINTER(TextFile)
+
+text.text_file_read_cached.argtypes = [ctypes.c_char_p]
+text.text_file_read_cached.restype  = ctypes.POINTER(TextFile)
+
 text.text_file_write.argtypes = [ctypes.c_char_p, ctypes.POINTER(TextFile)]
 text.text_file_write.restype  = ctypes.c_int
 
@@ -62,6 +74,35 @@ text.text_file_free.argtypes = [ctypes.POINTER(TextFile)]
 text.text_file_free.restype  = None
 
 
+# ------------------------------------------------------------
+# Mapped reader
+# ------------------------------------------------------------
+class TextView(ctypes.Structure):
+    _fields_ = [
+        ("data", ctypes.c_void_p),
+        ("length", ctypes.c_uint32),
+    ]
+
+
+text.text_file_open_mapped.argtypes = [ctypes.c_char_p]
+text.text_file_open_mapped.restype  = ctypes.c_void_p
+
+text.text_file_open_mapped_cached.argtypes = [ctypes.c_char_p]
+text.text_file_open_mapped_cached.restype  = ctypes.c_void_p
+
+text.text_mapped_close.argtypes = [ctypes.c_void_p]
+text.text_mapped_close.restype  = None
+
+text.text_mapped_entry_count.argtypes = [ctypes.c_void_p]
+text.text_mapped_entry_count.restype  = ctypes.c_uint32
+
+text.text_mapped_get_key.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(TextView)]
+text.text_mapped_get_key.restype  = ctypes.c_int
+
+text.text_mapped_get_value.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(TextView)]
+text.text_mapped_get_value.restype  = ctypes.c_int
+
+
 # ------------------------------------------------------------
 # Entry lifecycle
 # ------------------------------------------------------------
@@ -91,6 +132,33 @@ text.text_file_resize.argtypes = [ctypes.POINTER(TextFile), ctypes.c_uint32]
 text.text_file_resize.restype  = ctypes.c_int
 
 
+# ------------------------------------------------------------
+# Key index
+# ------------------------------------------------------------
+text.text_file_build_index.argtypes = [ctypes.POINTER(TextFile)]
+text.text_file_build_index.restype  = ctypes.c_int
+
+text.text_file_find.argtypes = [ctypes.POINTER(TextFile), ctypes.c_char_p, ctypes.c_size_t]
+text.text_file_find.restype  = ctypes.POINTER(TextEntry)
+
+
+# ------------------------------------------------------------
+# Sorted key index
+# ------------------------------------------------------------
+text.text_sorted_build.argtypes = [ctypes.POINTER(TextFile)]
+text.text_sorted_build.restype  = ctypes.c_void_p
+
+text.text_sorted_free.argtypes = [ctypes.c_void_p]
+text.text_sorted_free.restype  = None
+
+text.text_sorted_entry.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+text.text_sorted_entry.restype  = ctypes.c_uint32
+
+text.text_sorted_prefix_range.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t,
+                                          ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(ctypes.c_uint32)]
+text.text_sorted_prefix_range.restype  = ctypes.c_int
+
+
 # ------------------------------------------------------------
 # String getters/setters
 # ------------------------------------------------------------
@@ -106,6 +174,13 @@ text.text_entry_get_value.restype  = ctypes.c_void_p   # raw UTF‑16 bytes, cty
 text.text_entry_set_value.argtypes = [ctypes.POINTER(TextEntry), ctypes.c_char_p]
 text.text_entry_set_value.restype  = None
 
+text.text_entry_get_value_utf8.argtypes = [ctypes.POINTER(TextEntry), ctypes.c_char_p, ctypes.c_size_t,
+                                           ctypes.POINTER(ctypes.c_size_t)]
+text.text_entry_get_value_utf8.restype  = ctypes.c_int
+
+text.text_entry_set_value_utf8.argtypes = [ctypes.POINTER(TextEntry), ctypes.c_char_p, ctypes.c_size_t]
+text.text_entry_set_value_utf8.restype  = ctypes.c_int
+
 
 # ------------------------------------------------------------
 # Unknown field getters/setters
@@ -140,8 +215,13 @@ def _make_block_setter(func, size):
 # ------------------------------------------------------------
 # High-level helper API
 # ------------------------------------------------------------
-def load_text(path: str) -> ctypes.POINTER(TextFile):
-    tf = text.text_file_read(path.encode("utf-8"))
+def load_text(path: str, arena: bool = False, cached: bool = False) -> ctypes.POINTER(TextFile):
+    """cached=True keeps an offset/index sidecar (<path>.ssoidx) for fast reopening."""
+    if cached:
+        reader = text.text_file_read_cached
+    else:
+        reader = text.text_file_read_arena if arena else text.text_file_read
+    tf = reader(path.encode("utf-8"))
     if not tf:
         raise RuntimeError(f"Failed to load text file: {path}")
     return tf
@@ -169,6 +249,32 @@ def iter_entries(tf: ctypes.POINTER(TextFile)):
         yield get_entry(tf, i)
 
 
+def build_index(tf: ctypes.POINTER(TextFile)):
+    if text.text_file_build_index(tf):
+        raise RuntimeError("Failed to build key index")
+
+
+def find_entry(tf: ctypes.POINTER(TextFile), key: str):
+    raw = key.encode("utf-8")
+    ptr = text.text_file_find(tf, raw, len(raw))
+    return ptr.contents if ptr else None
+
+
+def iter_prefix(tf: ctypes.POINTER(TextFile), prefix: str):
+    """Yield entries whose key starts with prefix, in key order."""
+    ts = text.text_sorted_build(tf)
+    if not ts:
+        raise RuntimeError("Failed to build sorted key index")
+    try:
+        raw = prefix.encode("utf-8")
+        first, last = ctypes.c_uint32(), ctypes.c_uint32()
+        text.text_sorted_prefix_range(ts, raw, len(raw), ctypes.byref(first), ctypes.byref(last))
+        for rank in range(first.value, last.value):
+            yield get_entry(tf, text.text_sorted_entry(ts, rank))
+    finally:
+        text.text_sorted_free(ts)
+
+
 # ------------------------------------------------------------
 # Pythonic convenience wrappers
 # ------------------------------------------------------------
@@ -180,15 +286,76 @@ def set_key(entry: TextEntry, key: str):
     text.text_entry_set_key(ctypes.byref(entry), key.encode("utf-8"))
 
 def get_value(entry: TextEntry) -> str:
-    ptr = text.text_entry_get_value(ctypes.byref(entry))
-    if not ptr:
-        return ""
-
-    length = entry.value_length
-    raw = ctypes.string_at(ptr, length)
-    return raw.decode("utf-16-le")
+    """Transcode the UTF‑16 value to UTF‑8 in C."""
+    length = ctypes.c_size_t()
+    text.text_entry_get_value_utf8(ctypes.byref(entry), None, 0, ctypes.byref(length))
+    buf = ctypes.create_string_buffer(length.value + 1)
+    if text.text_entry_get_value_utf8(ctypes.byref(entry), buf, len(buf), None):
+        raise RuntimeError("Failed to transcode value")
+    return buf.raw[:length.value].decode("utf-8")
 
 def set_value(entry: TextEntry, value_utf8: str):
-    """Encode UTF‑8 → UTF‑16 and pass to C."""
-    utf16 = value_utf8.encode("utf-16-le")
-    text.text_entry_set_value(ctypes.byref(entry), utf16)
+    """Pass UTF‑8 to C, which stores it as terminated UTF‑16."""
+    raw = value_utf8.encode("utf-8")
+    if text.text_entry_set_value_utf8(ctypes.byref(entry), raw, len(raw)):
+        raise RuntimeError("Failed to set value")
+
+
+# ------------------------------------------------------------
+# Mapped reader helpers
+# ------------------------------------------------------------
+def open_mapped(path: str, cached: bool = False) -> ctypes.c_void_p:
+    opener = text.text_file_open_mapped_cached if cached else text.text_file_open_mapped
+    tm = opener(path.encode("utf-8"))
+    if not tm:
+        raise RuntimeError(f"Failed to map text file: {path}")
+    return tm
+
+
+def close_mapped(tm: ctypes.c_void_p):
+    text.text_mapped_close(tm)
+
+
+def mapped_key(tm: ctypes.c_void_p, index: int) -> str:
+    view = TextView()
+    if text.text_mapped_get_key(tm, index, ctypes.byref(view)):
+        raise IndexError(f"Entry index {index} out of range")
+    return ctypes.string_at(view.data, view.length).decode("utf-8")
+
+
+def mapped_value(tm: ctypes.c_void_p, index: int) -> str:
+    view = TextView()
+    if text.text_mapped_get_value(tm, index, ctypes.byref(view)):
+        raise IndexError(f"Entry index {index} out of range")
+    return ctypes.string_at(view.data, view.length - 2).decode("utf-16-le")
+
+
+# ------------------------------------------------------------
+# Streaming reader
+# ------------------------------------------------------------
+text.text_reader_open.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
+text.text_reader_open.restype  = ctypes.c_void_p
+
+text.text_reader_close.argtypes = [ctypes.c_void_p]
+text.text_reader_close.restype  = None
+
+text.text_reader_next.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.POINTER(TextEntry))]
+text.text_reader_next.restype  = ctypes.c_int
+
+text.text_reader_failed.argtypes = [ctypes.c_void_p]
+text.text_reader_failed.restype  = ctypes.c_int
+
+
+def stream_entries(path: str, buffer_size: int = 0):
+    """Yield entries one at a time; each entry is only valid until the next one is read."""
+    reader = text.text_reader_open(path.encode("utf-8"), buffer_size)
+    if not reader:
+        raise RuntimeError(f"Failed to open: {path}")
+    try:
+        entry = ctypes.POINTER(TextEntry)()
+        while not text.text_reader_next(reader, ctypes.byref(entry)):
+            yield entry.contents
+        if text.text_reader_failed(reader):
+            raise RuntimeError(f"Corrupt or truncated file: {path}")
+    finally:
+        text.text_reader_close(reader)
@@ -34,6 +34,7 @@ class VFEntry(ctypes.Structure):
         ("source_file_number", ctypes.c_uint32),
         ("unknown5", ctypes.c_uint8 * 4),
         ("file_path", ctypes.c_char_p),
+        ("flags", ctypes.c_uint8),
     ]
 
 # ------------------------------------------------------------
@@ -43,6 +44,9 @@ class VFFile(ctypes.Structure):
     _fields_ = [
         ("header", VFHeader),
         ("entries", ctypes.POINTER(VFEntry)),
+        ("arena", ctypes.c_void_p),
+        ("index", ctypes.c_void_p),
+        ("capacity", ctypes.c_uint32),
     ]
 
 
@@ -52,6 +56,12 @@ class VFFile(ctypes.Structure):
 vf.vf_file_read.argtypes = [ctypes.c_char_p]
 vf.vf_file_read.restype  = ctypes.POINTER(VFFile)
 
+vf.vf_file_read_arena.argtypes = [ctypes.c_char_p]
+vf.vf_file_read_arena.restype  = ctypes.POINTER(VFFile)
+
+vf.vf_file_read_cached.argtypes = [ctypes.c_char_p]
+vf.vf_file_read_cached.restype  = ctypes.POINTER(VFFile)
+
 vf.vf_file_write.argtypes = [ctypes.c_char_p, ctypes.POINTER(VFFile)]
 vf.vf_file_write.restype  = ctypes.c_int
 
@@ -161,11 +171,34 @@ vf.vf_entry_clone.argtypes = [ctypes.POINTER(VFEntry)]
 vf.vf_entry_clone.restype  = ctypes.POINTER(VFEntry)
 
 
+# ------------------------------------------------------------
+# Lookup index
+# ------------------------------------------------------------
+vf.vf_index_build.argtypes = [ctypes.POINTER(VFFile)]
+vf.vf_index_build.restype  = ctypes.c_int
+
+vf.vf_index_find_path.argtypes = [ctypes.POINTER(VFFile), ctypes.c_char_p, ctypes.c_size_t,
+                                  ctypes.POINTER(ctypes.c_uint32)]
+vf.vf_index_find_path.restype  = ctypes.c_int
+
+vf.vf_index_find_name.argtypes = [ctypes.POINTER(VFFile), ctypes.c_char_p, ctypes.c_size_t,
+                                  ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32]
+vf.vf_index_find_name.restype  = ctypes.c_uint32
+
+vf.vf_index_find_source.argtypes = [ctypes.POINTER(VFFile), ctypes.c_uint32,
+                                    ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32]
+vf.vf_index_find_source.restype  = ctypes.c_uint32
+
 # ------------------------------------------------------------
 # High-level helper API
 # ------------------------------------------------------------
-def load_vf(path: str) -> ctypes.POINTER(VFFile):
-    vf_file = vf.vf_file_read(path.encode("utf-8"))
+def load_vf(path: str, arena: bool = False, cached: bool = False) -> ctypes.POINTER(VFFile):
+    """cached=True keeps an offset sidecar (<path>.ssoidx) for fast reopening."""
+    if cached:
+        reader = vf.vf_file_read_cached
+    else:
+        reader = vf.vf_file_read_arena if arena else vf.vf_file_read
+    vf_file = reader(path.encode("utf-8"))
     if not vf_file:
         raise RuntimeError(f"Failed to load VF file: {path}")
     return vf_file
@@ -193,6 +226,36 @@ def iter_entries(vf_file: ctypes.POINTER(VFFile)):
         yield get_entry(vf_file, i)
 
 
+def build_index(vf_file: ctypes.POINTER(VFFile)):
+    if vf.vf_index_build(vf_file):
+        raise RuntimeError("Failed to build lookup index")
+
+
+def find_path(vf_file: ctypes.POINTER(VFFile), path: str):
+    """Index of the entry with this file_path, or None."""
+    raw = path.encode("utf-8")
+    index = ctypes.c_uint32()
+    if vf.vf_index_find_path(vf_file, raw, len(raw), ctypes.byref(index)):
+        return None
+    return index.value
+
+
+def _collect(find, vf_file, *key):
+    count = find(vf_file, *key, None, 0)
+    out = (ctypes.c_uint32 * count)()
+    find(vf_file, *key, out, count)
+    return list(out)
+
+
+def find_name(vf_file: ctypes.POINTER(VFFile), name: str) -> list:
+    """Indices of every entry with this file_name, ascending."""
+    raw = name.encode("utf-8")
+    return _collect(vf.vf_index_find_name, vf_file, raw, len(raw))
+
+
+def find_source(vf_file: ctypes.POINTER(VFFile), source_file_number: int) -> list:
+    return _collect(vf.vf_index_find_source, vf_file, source_file_number)
+
 # ------------------------------------------------------------
 # Pythonic convenience wrappers
 # ------------------------------------------------------------
@@ -210,3 +273,431 @@ def set_entry_name(entry: VFEntry, name: str):
 
 def set_entry_path(entry: VFEntry, path: str):
     vf.vf_entry_set_path(ctypes.byref(entry), path.encode("utf-8"))
+
+
+# ------------------------------------------------------------
+# Mapped reader
+# ------------------------------------------------------------
+class VFView(ctypes.Structure):
+    _fields_ = [
+        ("data", ctypes.c_void_p),
+        ("length", ctypes.c_uint32),
+    ]
+
+
+class VFRecord(ctypes.Structure):
+    _fields_ = [
+        ("name_pos", ctypes.c_uint32),
+        ("name_len", ctypes.c_uint32),
+        ("path_pos", ctypes.c_uint32),
+        ("path_len", ctypes.c_uint32),
+        ("unknown1", ctypes.c_uint8 * 8),
+        ("original_crc", ctypes.c_uint8 * 4),
+        ("exported_crc", ctypes.c_uint8 * 4),
+        ("unknown2", ctypes.c_uint8 * 4),
+        ("file_size", ctypes.c_uint32),
+        ("unknown4", ctypes.c_uint8 * 8),
+        ("source_file_number", ctypes.c_uint32),
+        ("unknown5", ctypes.c_uint8 * 4),
+    ]
+
+
+vf.vf_file_open_mapped.argtypes = [ctypes.c_char_p]
+vf.vf_file_open_mapped.restype  = ctypes.c_void_p
+
+vf.vf_mapped_close.argtypes = [ctypes.c_void_p]
+vf.vf_mapped_close.restype  = None
+
+vf.vf_mapped_entry_count.argtypes = [ctypes.c_void_p]
+vf.vf_mapped_entry_count.restype  = ctypes.c_uint32
+
+vf.vf_mapped_record.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+vf.vf_mapped_record.restype  = ctypes.POINTER(VFRecord)
+
+vf.vf_mapped_get_name.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(VFView)]
+vf.vf_mapped_get_name.restype  = ctypes.c_int
+
+vf.vf_mapped_get_path.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(VFView)]
+vf.vf_mapped_get_path.restype  = ctypes.c_int
+
+
+def open_mapped(path: str) -> ctypes.c_void_p:
+    vm = vf.vf_file_open_mapped(path.encode("utf-8"))
+    if not vm:
+        raise RuntimeError(f"Failed to map VF file: {path}")
+    return vm
+
+
+def close_mapped(vm: ctypes.c_void_p):
+    vf.vf_mapped_close(vm)
+
+
+def mapped_record(vm: ctypes.c_void_p, index: int) -> VFRecord:
+    rec = vf.vf_mapped_record(vm, index)
+    if not rec:
+        raise IndexError(f"Entry index {index} out of range")
+    return rec.contents
+
+
+def mapped_name(vm: ctypes.c_void_p, index: int) -> str:
+    view = VFView()
+    if vf.vf_mapped_get_name(vm, index, ctypes.byref(view)):
+        raise IndexError(f"Entry index {index} out of range")
+    return ctypes.string_at(view.data, view.length).decode("utf-8")
+
+
+def mapped_path(vm: ctypes.c_void_p, index: int) -> str:
+    view = VFView()
+    if vf.vf_mapped_get_path(vm, index, ctypes.byref(view)):
+        raise IndexError(f"Entry index {index} out of range")
+    return ctypes.string_at(view.data, view.length).decode("utf-8")
+
+
+# ------------------------------------------------------------
+# Manifest diff
+# ------------------------------------------------------------
+DIFF_ADDED = 0x01
+DIFF_REMOVED = 0x02
+DIFF_RESIZED = 0x04
+DIFF_CRC_CHANGED = 0x08
+DIFF_NONE = 0xFFFFFFFF
+
+
+class VFDiffChange(ctypes.Structure):
+    _fields_ = [
+        ("old_index", ctypes.c_uint32),
+        ("new_index", ctypes.c_uint32),
+        ("changes", ctypes.c_uint32),
+    ]
+
+
+class VFDiff(ctypes.Structure):
+    _fields_ = [
+        ("changes", ctypes.POINTER(VFDiffChange)),
+        ("count", ctypes.c_uint32),
+        ("capacity", ctypes.c_uint32),
+        ("added", ctypes.c_uint32),
+        ("removed", ctypes.c_uint32),
+        ("resized", ctypes.c_uint32),
+        ("crc_changed", ctypes.c_uint32),
+        ("unchanged", ctypes.c_uint32),
+    ]
+
+
+vf.vf_diff.argtypes = [ctypes.POINTER(VFFile), ctypes.POINTER(VFFile), ctypes.POINTER(VFDiff)]
+vf.vf_diff.restype  = ctypes.c_int
+
+vf.vf_diff_free.argtypes = [ctypes.POINTER(VFDiff)]
+vf.vf_diff_free.restype  = None
+
+
+def diff(old_file: ctypes.POINTER(VFFile), new_file: ctypes.POINTER(VFFile)) -> dict:
+    """Counts per category plus (old_index, new_index, changes) tuples; None marks a missing side."""
+    d = VFDiff()
+    if vf.vf_diff(old_file, new_file, ctypes.byref(d)):
+        raise RuntimeError("Failed to diff VF files")
+    try:
+        side = lambda i: None if i == DIFF_NONE else i
+        return {
+            "added": d.added,
+            "removed": d.removed,
+            "resized": d.resized,
+            "crc_changed": d.crc_changed,
+            "unchanged": d.unchanged,
+            "changes": [(side(c.old_index), side(c.new_index), c.changes) for c in d.changes[:d.count]],
+        }
+    finally:
+        vf.vf_diff_free(ctypes.byref(d))
+
+# ------------------------------------------------------------
+# Compact manifests
+# ------------------------------------------------------------
+class VFCompactRecord(ctypes.Structure):
+    _fields_ = [
+        ("dir", ctypes.c_uint32),
+        ("leaf", ctypes.c_uint32),
+        ("name", ctypes.c_uint32),
+        ("extra", ctypes.c_uint32),
+        ("original_crc", ctypes.c_uint8 * 4),
+        ("exported_crc", ctypes.c_uint8 * 4),
+        ("file_size", ctypes.c_uint32),
+        ("source_file_number", ctypes.c_uint32),
+    ]
+
+
+vf.vf_compact_read.argtypes = [ctypes.c_char_p]
+vf.vf_compact_read.restype  = ctypes.c_void_p
+
+vf.vf_compact_free.argtypes = [ctypes.c_void_p]
+vf.vf_compact_free.restype  = None
+
+vf.vf_compact_entry_count.argtypes = [ctypes.c_void_p]
+vf.vf_compact_entry_count.restype  = ctypes.c_uint32
+
+vf.vf_compact_memory.argtypes = [ctypes.c_void_p]
+vf.vf_compact_memory.restype  = ctypes.c_size_t
+
+vf.vf_compact_record.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+vf.vf_compact_record.restype  = ctypes.POINTER(VFCompactRecord)
+
+vf.vf_compact_get_name.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+vf.vf_compact_get_name.restype  = ctypes.c_char_p
+
+vf.vf_compact_get_path.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_char_p, ctypes.c_size_t,
+                                   ctypes.POINTER(ctypes.c_size_t)]
+vf.vf_compact_get_path.restype  = ctypes.c_int
+
+vf.vf_compact_find_dir.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t,
+                                   ctypes.POINTER(ctypes.c_uint32)]
+vf.vf_compact_find_dir.restype  = ctypes.c_int
+
+vf.vf_compact_dir_entries.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_int,
+                                      ctypes.POINTER(ctypes.c_uint32)]
+vf.vf_compact_dir_entries.restype  = ctypes.POINTER(ctypes.c_uint32)
+
+
+def open_compact(path: str) -> ctypes.c_void_p:
+    vc = vf.vf_compact_read(path.encode("utf-8"))
+    if not vc:
+        raise RuntimeError(f"Failed to load VF file: {path}")
+    return vc
+
+
+def close_compact(vc: ctypes.c_void_p):
+    vf.vf_compact_free(vc)
+
+
+def compact_record(vc: ctypes.c_void_p, index: int) -> VFCompactRecord:
+    rec = vf.vf_compact_record(vc, index)
+    if not rec:
+        raise IndexError(f"Entry index {index} out of range")
+    return rec.contents
+
+
+def compact_name(vc: ctypes.c_void_p, index: int) -> str:
+    name = vf.vf_compact_get_name(vc, index)
+    return name.decode("utf-8") if name is not None else None
+
+
+def compact_path(vc: ctypes.c_void_p, index: int) -> str:
+    length = ctypes.c_size_t()
+    vf.vf_compact_get_path(vc, index, None, 0, ctypes.byref(length))
+    buf = ctypes.create_string_buffer(length.value + 1)
+    if vf.vf_compact_get_path(vc, index, buf, len(buf), None):
+        raise IndexError(f"Entry index {index} has no path")
+    return buf.value.decode("utf-8")
+
+
+def list_dir(vc: ctypes.c_void_p, folder: str, recursive: bool = True) -> list:
+    """Entry indices under folder ('' for the root); either separator works."""
+    raw = folder.encode("utf-8")
+    dir_id = ctypes.c_uint32()
+    if vf.vf_compact_find_dir(vc, raw, len(raw), ctypes.byref(dir_id)):
+        return []
+    count = ctypes.c_uint32()
+    entries = vf.vf_compact_dir_entries(vc, dir_id, int(recursive), ctypes.byref(count))
+    return entries[:count.value]
+
+# ------------------------------------------------------------
+# Columnar view
+# ------------------------------------------------------------
+class VFColumns(ctypes.Structure):
+    _fields_ = [
+        ("count", ctypes.c_uint32),
+        ("file_size", ctypes.POINTER(ctypes.c_uint32)),
+        ("original_crc", ctypes.POINTER(ctypes.c_uint32)),
+        ("exported_crc", ctypes.POINTER(ctypes.c_uint32)),
+        ("source_file_number", ctypes.POINTER(ctypes.c_uint32)),
+        ("path_offset", ctypes.POINTER(ctypes.c_uint32)),
+        ("name_offset", ctypes.POINTER(ctypes.c_uint32)),
+        ("strings", ctypes.c_void_p),
+        ("strings_size", ctypes.c_size_t),
+        ("block", ctypes.c_void_p),
+    ]
+
+
+CMP = {"==": 0, "!=": 1, "<": 2, "<=": 3, ">": 4, ">=": 5}
+
+vf.vf_file_to_columns.argtypes = [ctypes.POINTER(VFFile), ctypes.POINTER(VFColumns)]
+vf.vf_file_to_columns.restype  = ctypes.c_int
+
+vf.vf_columns_free.argtypes = [ctypes.POINTER(VFColumns)]
+vf.vf_columns_free.restype  = None
+
+vf.vf_columns_filter.argtypes = [ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32, ctypes.c_int, ctypes.c_uint32,
+                                 ctypes.POINTER(ctypes.c_uint32)]
+vf.vf_columns_filter.restype  = ctypes.c_uint32
+
+vf.vf_columns_sum.argtypes = [ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32]
+vf.vf_columns_sum.restype  = ctypes.c_uint64
+
+
+def to_columns(vf_file: ctypes.POINTER(VFFile)) -> VFColumns:
+    """Column-per-field copy of the manifest; release it with free_columns."""
+    cols = VFColumns()
+    if vf.vf_file_to_columns(vf_file, ctypes.byref(cols)):
+        raise RuntimeError("Failed to build columns")
+    return cols
+
+
+def free_columns(cols: VFColumns):
+    vf.vf_columns_free(ctypes.byref(cols))
+
+
+def column_filter(cols: VFColumns, field: str, op: str, value: int) -> list:
+    """Indices of entries where <field> <op> value, e.g. column_filter(c, "original_crc", "==", 0)."""
+    column = getattr(cols, field)
+    out = (ctypes.c_uint32 * max(cols.count, 1))()
+    n = vf.vf_columns_filter(column, cols.count, CMP[op], value, out)
+    return list(out[:n])
+
+
+def column_sum(cols: VFColumns, field: str) -> int:
+    return vf.vf_columns_sum(getattr(cols, field), cols.count)
+
+
+# ------------------------------------------------------------
+# Verification
+# ------------------------------------------------------------
+VERIFY_STATUS = ("ok", "missing", "size_mismatch", "crc_mismatch", "read_error")
+VERIFY_CRC = {"original": 0, "exported": 1, "either": 2, "none": 3}
+
+
+class VFVerifyOpts(ctypes.Structure):
+    _fields_ = [
+        ("nthreads", ctypes.c_uint),
+        ("crc", ctypes.c_int),
+        ("read_size", ctypes.c_size_t),
+        ("use_mmap", ctypes.c_int),
+        ("cache", ctypes.c_void_p),
+    ]
+
+
+class VFVerifyReport(ctypes.Structure):
+    _fields_ = [
+        ("status", ctypes.POINTER(ctypes.c_uint8)),
+        ("crc", ctypes.POINTER(ctypes.c_uint32)),
+        ("count", ctypes.c_uint32),
+        ("ok", ctypes.c_uint32),
+        ("missing", ctypes.c_uint32),
+        ("size_mismatch", ctypes.c_uint32),
+        ("crc_mismatch", ctypes.c_uint32),
+        ("read_errors", ctypes.c_uint32),
+        ("cache_hits", ctypes.c_uint32),
+        ("bytes_hashed", ctypes.c_uint64),
+    ]
+
+
+vf.vf_verify_tree.argtypes = [ctypes.POINTER(VFFile), ctypes.c_char_p,
+                              ctypes.POINTER(VFVerifyOpts), ctypes.POINTER(VFVerifyReport)]
+vf.vf_verify_tree.restype  = ctypes.c_int
+
+vf.vf_verify_report_free.argtypes = [ctypes.POINTER(VFVerifyReport)]
+vf.vf_verify_report_free.restype  = None
+
+vf.vf_verify_cache_open.argtypes = [ctypes.c_char_p]
+vf.vf_verify_cache_open.restype  = ctypes.c_void_p
+
+vf.vf_verify_cache_save.argtypes = [ctypes.c_void_p]
+vf.vf_verify_cache_save.restype  = ctypes.c_int
+
+vf.vf_verify_cache_close.argtypes = [ctypes.c_void_p]
+vf.vf_verify_cache_close.restype  = None
+
+
+def verify_tree(vf_file: ctypes.POINTER(VFFile), root: str, crc: str = "original",
+                nthreads: int = 0, use_mmap: bool = False, cache_path: str = None) -> list:
+    """Return one status string per entry (see VERIFY_STATUS).
+
+    With cache_path, unchanged files are skipped using a persistent verification cache.
+    """
+    cache = vf.vf_verify_cache_open(cache_path.encode("utf-8")) if cache_path else None
+    if cache_path and not cache:
+        raise RuntimeError(f"Failed to open verification cache: {cache_path}")
+    opts = VFVerifyOpts(nthreads, VERIFY_CRC[crc], 0, int(use_mmap), cache)
+    report = VFVerifyReport()
+    try:
+        if vf.vf_verify_tree(vf_file, root.encode("utf-8"), ctypes.byref(opts), ctypes.byref(report)):
+            raise RuntimeError(f"Verification failed to run: {root}")
+        if cache:
+            vf.vf_verify_cache_save(cache)
+        return [VERIFY_STATUS[report.status[i]] for i in range(report.count)]
+    finally:
+        vf.vf_verify_report_free(ctypes.byref(report))
+        if cache:
+            vf.vf_verify_cache_close(cache)
+
+
+# ------------------------------------------------------------
+# Manifest building
+# ------------------------------------------------------------
+class VFBuildOpts(ctypes.Structure):
+    _fields_ = [
+        ("nthreads", ctypes.c_uint),
+        ("read_size", ctypes.c_size_t),
+        ("use_mmap", ctypes.c_int),
+        ("separator", ctypes.c_char),
+        ("first_source_number", ctypes.c_uint32),
+        ("header", VFHeader),
+        ("cache", ctypes.c_void_p),
+    ]
+
+
+vf.vf_file_build_from_dir.argtypes = [ctypes.c_char_p, ctypes.POINTER(VFBuildOpts)]
+vf.vf_file_build_from_dir.restype  = ctypes.POINTER(VFFile)
+
+
+def build_from_dir(root: str, magic: bytes = b"CCX\0", manifest_version: int = 1, separator: str = "\\",
+                   nthreads: int = 0, use_mmap: bool = False, cache_path: str = None) -> ctypes.POINTER(VFFile):
+    """Hash every regular file under root into a new manifest; free it with free_vf."""
+    cache = vf.vf_verify_cache_open(cache_path.encode("utf-8")) if cache_path else None
+    if cache_path and not cache:
+        raise RuntimeError(f"Failed to open verification cache: {cache_path}")
+    opts = VFBuildOpts()
+    opts.nthreads = nthreads
+    opts.use_mmap = int(use_mmap)
+    opts.separator = separator.encode("ascii")
+    opts.header.magic_bytes[:] = list(magic[:4].ljust(4, b"\0"))
+    opts.header.manifest_version = manifest_version
+    opts.cache = cache
+    try:
+        result = vf.vf_file_build_from_dir(root.encode("utf-8"), ctypes.byref(opts))
+        if not result:
+            raise RuntimeError(f"Failed to build manifest from: {root}")
+        if cache:
+            vf.vf_verify_cache_save(cache)
+        return result
+    finally:
+        if cache:
+            vf.vf_verify_cache_close(cache)
+
+
+# ------------------------------------------------------------
+# Streaming reader
+# ------------------------------------------------------------
+vf.vf_reader_open.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
+vf.vf_reader_open.restype  = ctypes.c_void_p
+
+vf.vf_reader_close.argtypes = [ctypes.c_void_p]
+vf.vf_reader_close.restype  = None
+
+vf.vf_reader_next.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.POINTER(VFEntry))]
+vf.vf_reader_next.restype  = ctypes.c_int
+
+vf.vf_reader_failed.argtypes = [ctypes.c_void_p]
+vf.vf_reader_failed.restype  = ctypes.c_int
+
+
+def stream_entries(path: str, buffer_size: int = 0):
+    """Yield entries one at a time; each entry is only valid until the next one is read."""
+    reader = vf.vf_reader_open(path.encode("utf-8"), buffer_size)
+    if not reader:
+        raise RuntimeError(f"Failed to open: {path}")
+    try:
+        entry = ctypes.POINTER(VFEntry)()
+        while not vf.vf_reader_next(reader, ctypes.byref(entry)):
+            yield entry.contents
+        if vf.vf_reader_failed(reader):
+            raise RuntimeError(f"Corrupt or truncated file: {path}")
+    finally:
+        vf.vf_reader_close(reader)
@@ -0,0 +1,104 @@
+#define SSO_BUILD_DLL
+#include "alloc.h"
+#include "stats_internal.h"
+#include "tls.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+static sso_allocator_t                       sso_global_allocator;
+static SSO_TLS const sso_allocator_t        *sso_thread_allocator;
+
+/* NULL means libc. */
+static const sso_allocator_t *sso_current_allocator(void) {
+    const sso_allocator_t *a = sso_thread_allocator;
+    if (a)
+        return a;
+    return sso_global_allocator.alloc ? &sso_global_allocator : NULL;
+}
+
+/* ================== ALLOCATOR SELECTION ================== */
+
+SSO_API void sso_set_allocator(const sso_allocator_t *a) {
+    if (a && a->alloc && a->realloc && a->free)
+        sso_global_allocator = *a;
+    else
+        memset(&sso_global_allocator, 0, sizeof(sso_global_allocator));
+}
+
+SSO_API const sso_allocator_t *sso_set_thread_allocator(const sso_allocator_t *a) {
+    const sso_allocator_t *prev = sso_thread_allocator;
+    sso_thread_allocator = (a && a->alloc && a->realloc && a->free) ? a : NULL;
+    return prev;
+}
+
+SSO_API const sso_allocator_t *sso_get_thread_allocator(void) {
+    return sso_thread_allocator;
+}
+
+/* ================== ALLOCATION ================== */
+
+SSO_API void *sso_malloc(size_t size) {
+    const sso_allocator_t *a = sso_current_allocator();
+    if (size == 0)
+        size = 1;
+
+    SSO_STATS_TIME(t);
+    void *p = a ? a->alloc(a->user, size) : malloc(size);
+    SSO_STATS_TIME_END(t, SSO_STATS_PHASE_ALLOC);
+    if (p)
+        SSO_STATS_ALLOC(size);
+    return p;
+}
+
+SSO_API void *sso_calloc(size_t n, size_t size) {
+    if (size && n > SIZE_MAX / size)
+        return NULL;
+
+    const sso_allocator_t *a = sso_current_allocator();
+    const size_t total = (n && size) ? n * size : 1;
+
+    SSO_STATS_TIME(t);
+    void *p;
+    if (a) {
+        p = a->alloc(a->user, total);
+        if (p)
+            memset(p, 0, total);
+    } else {
+        p = calloc(total, 1);
+    }
+    SSO_STATS_TIME_END(t, SSO_STATS_PHASE_ALLOC);
+    if (p)
+        SSO_STATS_ALLOC(total);
+    return p;
+}
+
+SSO_API void *sso_realloc(void *ptr, size_t size) {
+    if (!ptr)
+        return sso_malloc(size);
+
+    const sso_allocator_t *a = sso_current_allocator();
+    if (size == 0)
+        size = 1;
+
+    SSO_STATS_TIME(t);
+    void *p = a ? a->realloc(a->user, ptr, size) : realloc(ptr, size);
+    SSO_STATS_TIME_END(t, SSO_STATS_PHASE_ALLOC);
+    if (p)
+        SSO_STATS_ALLOC(size);
+    return p;
+}
+
+SSO_API void sso_free(void *ptr) {
+    if (!ptr)
+        return;
+
+    const sso_allocator_t *a = sso_current_allocator();
+    if (a)
+        a->free(a->user, ptr);
+    else
+        free(ptr);
+}
@@ -0,0 +1,101 @@
+#define SSO_BUILD_DLL
+#include "arena.h"
+#include "alloc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define SSO_ARENA_MIN_BLOCK 4096
+
+typedef struct sso_arena_block {
+    struct sso_arena_block *next;
+    size_t                  used;
+    size_t                  cap;
+} sso_arena_block_t;
+
+struct sso_arena {
+    sso_arena_block_t *head;
+    size_t             block_size;
+};
+
+/* Block payload starts right after the header, rounded so 8-byte requests stay aligned. */
+#define SSO_ARENA_HEADER ((sizeof(sso_arena_block_t) + 15) & ~(size_t) 15)
+
+static sso_arena_block_t *arena_block_new(size_t cap) {
+    sso_arena_block_t *b = (sso_arena_block_t *) sso_malloc(SSO_ARENA_HEADER + cap);
+    if (!b)
+        return NULL;
+    b->next = NULL;
+    b->used = 0;
+    b->cap = cap;
+    return b;
+}
+
+sso_arena_t *sso_arena_create(size_t block_size) {
+    sso_arena_t *a = (sso_arena_t *) sso_calloc(1, sizeof(sso_arena_t));
+    if (!a)
+        return NULL;
+
+    a->block_size = block_size < SSO_ARENA_MIN_BLOCK ? SSO_ARENA_MIN_BLOCK : block_size;
+    a->head = arena_block_new(a->block_size);
+    if (!a->head) {
+        sso_free(a);
+        return NULL;
+    }
+    return a;
+}
+
+void *sso_arena_alloc(sso_arena_t *a, size_t size, size_t align) {
+    if (!a || align == 0 || (align & (align - 1)))
+        return NULL;
+
+    sso_arena_block_t *b = a->head;
+    size_t start = (b->used + align - 1) & ~(align - 1);
+
+    if (start > b->cap || b->cap - start < size) {
+        /* Later blocks grow geometrically so a bad size estimate costs few extra mallocs. */
+        size_t cap = a->block_size;
+        if (cap < b->cap * 2)
+            cap = b->cap * 2;
+        if (cap < size + align)
+            cap = size + align;
+
+        sso_arena_block_t *nb = arena_block_new(cap);
+        if (!nb)
+            return NULL;
+        nb->next = b;
+        a->head = b = nb;
+        start = 0;
+    }
+
+    b->used = start + size;
+    return (uint8_t *) b + SSO_ARENA_HEADER + start;
+}
+
+void sso_arena_reset(sso_arena_t *a) {
+    if (!a)
+        return;
+
+    /* Blocks only ever grow, so the newest one is the largest. */
+    sso_arena_block_t *b = a->head->next;
+    while (b) {
+        sso_arena_block_t *next = b->next;
+        sso_free(b);
+        b = next;
+    }
+    a->head->next = NULL;
+    a->head->used = 0;
+}
+
+void sso_arena_destroy(sso_arena_t *a) {
+    if (!a)
+        return;
+
+    sso_arena_block_t *b = a->head;
+    while (b) {
+        sso_arena_block_t *next = b->next;
+        sso_free(b);
+        b = next;
+    }
+    sso_free(a);
+}
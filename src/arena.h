@@ -0,0 +1,18 @@
+#ifndef SSO_ARENA_H
+#define SSO_ARENA_H
+
+#include <stddef.h>
+
+/*
+ * Bump allocator for string data of a parsed file. Individual allocations
+ * are never freed; the whole arena goes away with one call per block.
+ */
+typedef struct sso_arena sso_arena_t;
+
+sso_arena_t *sso_arena_create(size_t block_size);
+void        *sso_arena_alloc(sso_arena_t *a, size_t size, size_t align);
+/* Drops every allocation but keeps the largest block for reuse. */
+void         sso_arena_reset(sso_arena_t *a);
+void         sso_arena_destroy(sso_arena_t *a);
+
+#endif /* SSO_ARENA_H */
@@ -0,0 +1,204 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#define SSO_BUILD_DLL
+#include "cache.h"
+#include "hash.h"
+#include "write.h"
+#include "alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define SSO_CACHE_VERSION 1u
+#define SSO_CACHE_SUFFIX  ".ssoidx"
+
+/* Content hash samples: head, tail and this many evenly spaced blocks in between. */
+#define SSO_CACHE_EDGE_BYTES    (64u * 1024u)
+#define SSO_CACHE_SAMPLE_BYTES  4096u
+#define SSO_CACHE_SAMPLE_BLOCKS 16u
+
+typedef struct {
+    char     magic[4];
+    uint32_t version;
+    uint32_t kind;
+    uint32_t entry_count;
+    uint64_t source_size;
+    int64_t  source_mtime_ns;
+    uint64_t content_hash;
+    uint32_t record_size;
+    uint32_t slot_size;
+    uint32_t table_slots;
+    uint32_t reserved;
+    uint64_t payload_hash;
+} sso_cache_header_t;
+
+static const char sso_cache_magic[4] = { 'S', 'S', 'O', 'X' };
+
+static char *sso_cache_path(const char *source) {
+    const size_t len = strlen(source);
+    char *path = (char *) sso_malloc(len + sizeof(SSO_CACHE_SUFFIX));
+    if (!path)
+        return NULL;
+    memcpy(path, source, len);
+    memcpy(path + len, SSO_CACHE_SUFFIX, sizeof(SSO_CACHE_SUFFIX));
+    return path;
+}
+
+static int sso_cache_mtime_ns(const char *source, int64_t *out) {
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(source, &st))
+        return 1;
+    *out = (int64_t) st.st_mtime * 1000000000;
+#else
+    struct stat st;
+    if (stat(source, &st))
+        return 1;
+    *out = (int64_t) st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return 0;
+}
+
+/*
+ * Hashing the whole source would cost as much as the scan the cache saves,
+ * so only a bounded sample is hashed. Size and mtime catch ordinary edits;
+ * the sample catches copies and restores that carry an old timestamp.
+ */
+static uint64_t sso_cache_content_hash(const uint8_t *data, size_t size) {
+    if (size <= 2 * SSO_CACHE_EDGE_BYTES)
+        return sso_hash_bytes(data, size);
+
+    uint64_t h = sso_hash_bytes(data, SSO_CACHE_EDGE_BYTES);
+    h = sso_hash_mix(h ^ sso_hash_bytes(data + size - SSO_CACHE_EDGE_BYTES, SSO_CACHE_EDGE_BYTES));
+
+    const size_t middle = size - 2 * SSO_CACHE_EDGE_BYTES;
+    if (middle > SSO_CACHE_SAMPLE_BYTES) {
+        const size_t stride = (middle - SSO_CACHE_SAMPLE_BYTES) / SSO_CACHE_SAMPLE_BLOCKS;
+        for (uint32_t i = 0; i < SSO_CACHE_SAMPLE_BLOCKS; ++i) {
+            const uint8_t *p = data + SSO_CACHE_EDGE_BYTES + (size_t) i * stride;
+            h = sso_hash_mix(h ^ sso_hash_bytes(p, SSO_CACHE_SAMPLE_BYTES));
+        }
+    }
+    return h;
+}
+
+/* Checks the mapped cache against the source identity and expected shape. */
+static int sso_cache_validate(sso_cache_t *c, const sso_cache_key_t *key, uint32_t kind,
+                              uint32_t entry_count, uint32_t record_size, uint32_t slot_size) {
+    if (c->map.size < sizeof(sso_cache_header_t))
+        return 1;
+
+    sso_cache_header_t h;
+    memcpy(&h, c->map.data, sizeof(h));
+
+    if (memcmp(h.magic, sso_cache_magic, 4) != 0 || h.version != SSO_CACHE_VERSION || h.kind != kind)
+        return 1;
+    if (h.source_size != key->size || h.source_mtime_ns != key->mtime_ns ||
+        h.content_hash != key->content_hash)
+        return 1;
+    if (h.entry_count != entry_count || h.record_size != record_size ||
+        (h.table_slots && h.slot_size != slot_size))
+        return 1;
+
+    const uint64_t payload = (uint64_t) entry_count * record_size + (uint64_t) h.table_slots * h.slot_size;
+    if (payload != c->map.size - sizeof(sso_cache_header_t))
+        return 1;
+
+    const uint8_t *records = c->map.data + sizeof(sso_cache_header_t);
+    if (sso_hash_bytes(records, (size_t) payload) != h.payload_hash)
+        return 1;
+
+    c->records = records;
+    c->table = h.table_slots ? records + (size_t) entry_count * record_size : NULL;
+    c->table_slots = h.table_slots;
+    return 0;
+}
+
+/* ================== SIDECAR CACHE ================== */
+
+int sso_cache_key_compute(const char *source, const uint8_t *data, size_t size, sso_cache_key_t *key) {
+    if (!source || !data || !key)
+        return 1;
+    if (sso_cache_mtime_ns(source, &key->mtime_ns))
+        return 1;
+    key->size = size;
+    key->content_hash = sso_cache_content_hash(data, size);
+    return 0;
+}
+
+int sso_cache_open(const char *source, const sso_cache_key_t *key, uint32_t kind,
+                   uint32_t entry_count, uint32_t record_size, uint32_t slot_size, sso_cache_t *out) {
+    if (!source || !key || !out)
+        return 1;
+    memset(out, 0, sizeof(*out));
+
+    char *path = sso_cache_path(source);
+    if (!path)
+        return 1;
+    const int failed = sso_map_open(path, 0, &out->map);
+    sso_free(path);
+    if (failed)
+        return 1;
+
+    if (sso_cache_validate(out, key, kind, entry_count, record_size, slot_size)) {
+        sso_cache_close(out);
+        return 1;
+    }
+    return 0;
+}
+
+void sso_cache_close(sso_cache_t *c) {
+    if (!c)
+        return;
+    if (c->map.data)
+        sso_map_close(&c->map);
+    memset(c, 0, sizeof(*c));
+}
+
+int sso_cache_store(const char *source, const sso_cache_key_t *key, uint32_t kind,
+                    uint32_t entry_count, uint32_t record_size, const void *records,
+                    uint32_t slot_size, uint32_t table_slots, const void *table) {
+    if (!source || !key || (entry_count && !records) || (table_slots && !table))
+        return 1;
+
+    const size_t records_size = (size_t) entry_count * record_size;
+    const size_t table_size = (size_t) table_slots * slot_size;
+    const size_t size = sizeof(sso_cache_header_t) + records_size + table_size;
+
+    uint8_t *buf = (uint8_t *) sso_malloc(size);
+    if (!buf)
+        return 1;
+
+    if (records_size)
+        memcpy(buf + sizeof(sso_cache_header_t), records, records_size);
+    if (table_size)
+        memcpy(buf + sizeof(sso_cache_header_t) + records_size, table, table_size);
+
+    sso_cache_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, sso_cache_magic, 4);
+    h.version = SSO_CACHE_VERSION;
+    h.kind = kind;
+    h.entry_count = entry_count;
+    h.source_size = key->size;
+    h.source_mtime_ns = key->mtime_ns;
+    h.content_hash = key->content_hash;
+    h.record_size = record_size;
+    h.slot_size = table_slots ? slot_size : 0;
+    h.table_slots = table_slots;
+    h.payload_hash = sso_hash_bytes(buf + sizeof(h), records_size + table_size);
+    memcpy(buf, &h, sizeof(h));
+
+    char *path = sso_cache_path(source);
+    const int rc = path ? sso_write_atomic(path, buf, size, 0) : 1;
+    sso_free(path);
+    sso_free(buf);
+    return rc;
+}
@@ -0,0 +1,48 @@
+#ifndef SSO_CACHE_H
+#define SSO_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "map.h"
+
+/*
+ * Sidecar index cache, stored next to the source as "<file>.ssoidx".
+ *
+ * Layout: sso_cache_header_t, `entry_count` records of `record_size` bytes,
+ * then `table_slots` hash table slots of `slot_size` bytes. The cache is
+ * only trusted when the source size, mtime and sampled content hash match
+ * and the payload hash checks out; anything else is a miss and the caller
+ * rebuilds it.
+ */
+
+#define SSO_CACHE_KIND_TEXT 1u
+#define SSO_CACHE_KIND_VF   2u
+
+/* Identity of the source file the cache was built from. */
+typedef struct {
+    uint64_t size;
+    int64_t  mtime_ns;
+    uint64_t content_hash;
+} sso_cache_key_t;
+
+typedef struct {
+    sso_map_t   map;
+    const void *records;
+    const void *table;
+    uint32_t    table_slots;
+} sso_cache_t;
+
+/* Fills `key` from the file's metadata and its mapped image. */
+int  sso_cache_key_compute(const char *source, const uint8_t *data, size_t size, sso_cache_key_t *key);
+
+int  sso_cache_open(const char *source, const sso_cache_key_t *key, uint32_t kind,
+                    uint32_t entry_count, uint32_t record_size, uint32_t slot_size, sso_cache_t *out);
+void sso_cache_close(sso_cache_t *c);
+
+/* Best effort: a cache that cannot be written only costs the next reader a scan. */
+int  sso_cache_store(const char *source, const sso_cache_key_t *key, uint32_t kind,
+                     uint32_t entry_count, uint32_t record_size, const void *records,
+                     uint32_t slot_size, uint32_t table_slots, const void *table);
+
+#endif /* SSO_CACHE_H */
@@ -0,0 +1,188 @@
+#define SSO_BUILD_DLL
+#include "codec.h"
+#include "cpu.h"
+#include "once.h"
+
+#ifdef SSO_X86
+#include <immintrin.h>
+#endif
+
+/* ================== KERNELS ================== */
+
+typedef void (*shift_kernel_fn)(uint8_t *dst, const uint8_t *src, size_t len, uint8_t add);
+
+static void shift_scalar(uint8_t *dst, const uint8_t *src, size_t len, uint8_t add) {
+    for (size_t i = 0; i < len; i++)
+        dst[i] = (uint8_t) (src[i] + add);
+}
+
+#ifdef SSO_X86
+
+SSO_TARGET("sse2")
+static void shift_sse2(uint8_t *dst, const uint8_t *src, size_t len, uint8_t add) {
+    const __m128i k = _mm_set1_epi8((char) add);
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i b = _mm_loadu_si128((const __m128i *) (src + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *) (src + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *) (src + i + 48));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_add_epi8(a, k));
+        _mm_storeu_si128((__m128i *) (dst + i + 16), _mm_add_epi8(b, k));
+        _mm_storeu_si128((__m128i *) (dst + i + 32), _mm_add_epi8(c, k));
+        _mm_storeu_si128((__m128i *) (dst + i + 48), _mm_add_epi8(d, k));
+    }
+    for (; i + 16 <= len; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_add_epi8(a, k));
+    }
+    shift_scalar(dst + i, src + i, len - i, add);
+}
+
+SSO_TARGET("avx2")
+static void shift_avx2(uint8_t *dst, const uint8_t *src, size_t len, uint8_t add) {
+    const __m256i k = _mm256_set1_epi8((char) add);
+    size_t i = 0;
+
+    for (; i + 128 <= len; i += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i *) (src + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *) (src + i + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *) (src + i + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i *) (src + i + 96));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_add_epi8(a, k));
+        _mm256_storeu_si256((__m256i *) (dst + i + 32), _mm256_add_epi8(b, k));
+        _mm256_storeu_si256((__m256i *) (dst + i + 64), _mm256_add_epi8(c, k));
+        _mm256_storeu_si256((__m256i *) (dst + i + 96), _mm256_add_epi8(d, k));
+    }
+    for (; i + 32 <= len; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *) (src + i));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_add_epi8(a, k));
+    }
+    if (i + 16 <= len) {
+        __m128i a = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_add_epi8(a, _mm256_castsi256_si128(k)));
+        i += 16;
+    }
+    shift_scalar(dst + i, src + i, len - i, add);
+}
+
+SSO_TARGET("avx512f,avx512bw")
+static void shift_avx512(uint8_t *dst, const uint8_t *src, size_t len, uint8_t add) {
+    const __m512i k = _mm512_set1_epi8((char) add);
+    size_t i = 0;
+
+    for (; i + 256 <= len; i += 256) {
+        __m512i a = _mm512_loadu_si512((const void *) (src + i));
+        __m512i b = _mm512_loadu_si512((const void *) (src + i + 64));
+        __m512i c = _mm512_loadu_si512((const void *) (src + i + 128));
+        __m512i d = _mm512_loadu_si512((const void *) (src + i + 192));
+        _mm512_storeu_si512((void *) (dst + i), _mm512_add_epi8(a, k));
+        _mm512_storeu_si512((void *) (dst + i + 64), _mm512_add_epi8(b, k));
+        _mm512_storeu_si512((void *) (dst + i + 128), _mm512_add_epi8(c, k));
+        _mm512_storeu_si512((void *) (dst + i + 192), _mm512_add_epi8(d, k));
+    }
+    for (; i + 64 <= len; i += 64) {
+        __m512i a = _mm512_loadu_si512((const void *) (src + i));
+        _mm512_storeu_si512((void *) (dst + i), _mm512_add_epi8(a, k));
+    }
+    if (i < len) {
+        /* Masked tail: short keys never leave the vector unit. */
+        const __mmask64 m = (__mmask64) -1 >> (64 - (len - i));
+        __m512i a = _mm512_maskz_loadu_epi8(m, (const void *) (src + i));
+        _mm512_mask_storeu_epi8((void *) (dst + i), m, _mm512_add_epi8(a, k));
+    }
+}
+
+#endif
+
+/* ================== DISPATCH ================== */
+
+static const shift_kernel_fn kernels[SSO_CODEC_KERNEL_COUNT] = {
+    NULL,
+    shift_scalar,
+#ifdef SSO_X86
+    shift_sse2,
+    shift_avx2,
+    shift_avx512,
+#else
+    NULL,
+    NULL,
+    NULL,
+#endif
+};
+
+static const char *const kernel_names[SSO_CODEC_KERNEL_COUNT] = {
+    "auto", "scalar", "sse2", "avx2", "avx512"
+};
+
+static int active = SSO_CODEC_AUTO;
+
+static sso_codec_kernel_t detect_kernel(void) {
+    const uint32_t features = sso_cpu_features();
+    if (features & SSO_CPU_AVX512BW)
+        return SSO_CODEC_AVX512;
+    if (features & SSO_CPU_AVX2)
+        return SSO_CODEC_AVX2;
+    if (features & SSO_CPU_SSE2)
+        return SSO_CODEC_SSE2;
+    return SSO_CODEC_SCALAR;
+}
+
+static inline shift_kernel_fn current_kernel(void) {
+    int k = SSO_ATOMIC_LOAD_INT(&active);
+    if (k == SSO_CODEC_AUTO) {
+        k = (int) detect_kernel();
+        SSO_ATOMIC_STORE_INT(&active, k);
+    }
+    return kernels[k];
+}
+
+SSO_API int sso_codec_kernel_supported(sso_codec_kernel_t kernel) {
+    const uint32_t features = sso_cpu_features();
+    switch (kernel) {
+        case SSO_CODEC_AUTO:
+        case SSO_CODEC_SCALAR:
+            return 1;
+        case SSO_CODEC_SSE2:
+            return kernels[kernel] && (features & SSO_CPU_SSE2);
+        case SSO_CODEC_AVX2:
+            return kernels[kernel] && (features & SSO_CPU_AVX2);
+        case SSO_CODEC_AVX512:
+            return kernels[kernel] && (features & SSO_CPU_AVX512BW);
+        default:
+            return 0;
+    }
+}
+
+SSO_API int sso_codec_select_kernel(sso_codec_kernel_t kernel) {
+    if (!sso_codec_kernel_supported(kernel))
+        return 1;
+    SSO_ATOMIC_STORE_INT(&active, (int) kernel);
+    return 0;
+}
+
+SSO_API sso_codec_kernel_t sso_codec_active_kernel(void) {
+    current_kernel();
+    return (sso_codec_kernel_t) SSO_ATOMIC_LOAD_INT(&active);
+}
+
+SSO_API const char *sso_codec_kernel_name(sso_codec_kernel_t kernel) {
+    if ((unsigned) kernel >= SSO_CODEC_KERNEL_COUNT)
+        return "unknown";
+    return kernel_names[kernel];
+}
+
+/* ================== CODEC ================== */
+
+SSO_API void sso_shift_decode(void *dst, const void *src, size_t len, uint8_t offset) {
+    if (!dst || !src || len == 0)
+        return;
+    current_kernel()((uint8_t *) dst, (const uint8_t *) src, len, offset);
+}
+
+SSO_API void sso_shift_encode(void *dst, const void *src, size_t len, uint8_t offset) {
+    if (!dst || !src || len == 0)
+        return;
+    current_kernel()((uint8_t *) dst, (const uint8_t *) src, len, (uint8_t) (0u - offset));
+}
@@ -0,0 +1,79 @@
+#include "cpu.h"
+#include "once.h"
+
+#ifdef SSO_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#include <immintrin.h>
+
+static void cpuid(int leaf, int sub, uint32_t r[4]) {
+    int regs[4];
+    __cpuidex(regs, leaf, sub);
+    r[0] = (uint32_t) regs[0];
+    r[1] = (uint32_t) regs[1];
+    r[2] = (uint32_t) regs[2];
+    r[3] = (uint32_t) regs[3];
+}
+
+static uint64_t xgetbv0(void) {
+    return _xgetbv(0);
+}
+#else
+#include <cpuid.h>
+
+static void cpuid(int leaf, int sub, uint32_t r[4]) {
+    __cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+}
+
+static uint64_t xgetbv0(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t) hi << 32) | lo;
+}
+#endif
+#endif
+
+static uint32_t detect(void) {
+    uint32_t features = 0;
+#ifdef SSO_X86
+    uint32_t r[4];
+
+    cpuid(0, 0, r);
+    const uint32_t max_leaf = r[0];
+
+    cpuid(1, 0, r);
+    if (r[3] & (1u << 26))
+        features |= SSO_CPU_SSE2;
+    if (r[2] & (1u << 19))
+        features |= SSO_CPU_SSE41;
+    if (r[2] & (1u << 1))
+        features |= SSO_CPU_PCLMUL;
+
+    /* AVX state must be enabled by the OS before any 256/512-bit register is touched. */
+    if (!(r[2] & (1u << 27)) || max_leaf < 7)
+        return features;
+
+    const uint64_t xcr0 = xgetbv0();
+    const int ymm_ok = (xcr0 & 0x06) == 0x06;
+    const int zmm_ok = (xcr0 & 0xE6) == 0xE6;
+
+    cpuid(7, 0, r);
+    if (ymm_ok && (r[1] & (1u << 5)))
+        features |= SSO_CPU_AVX2;
+    if (zmm_ok && (r[1] & (1u << 16)) && (r[1] & (1u << 30)))
+        features |= SSO_CPU_AVX512BW;
+#endif
+    return features;
+}
+
+static uint32_t cached;
+static sso_once_t cached_once = SSO_ONCE_INIT;
+
+static void detect_once(void) {
+    cached = detect();
+}
+
+uint32_t sso_cpu_features(void) {
+    sso_once(&cached_once, detect_once);
+    return cached;
+}
@@ -0,0 +1,25 @@
+#ifndef SSO_CPU_H
+#define SSO_CPU_H
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SSO_X86 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define SSO_TARGET(isa)
+#else
+    #define SSO_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+#define SSO_CPU_SSE2      0x01u
+#define SSO_CPU_SSE41     0x02u
+#define SSO_CPU_AVX2      0x04u
+#define SSO_CPU_AVX512BW  0x08u
+#define SSO_CPU_PCLMUL    0x10u
+
+/* Feature bits usable on this CPU *and* enabled by the OS (XSAVE state). */
+uint32_t sso_cpu_features(void);
+
+#endif /* SSO_CPU_H */
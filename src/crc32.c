@@ -0,0 +1,260 @@
+#define SSO_BUILD_DLL
+#include "crc32.h"
+#include "cpu.h"
+#include "once.h"
+
+#include <string.h>
+
+#ifdef SSO_X86
+#include <immintrin.h>
+#endif
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define SSO_CRC32_POLY 0xEDB88320u
+
+/* crc_table[k][b]: CRC of byte b followed by k zero bytes, for slice-by-16. */
+static uint32_t crc_table[16][256];
+/* crc_x2n[k] = x^(2^k) mod P, for combining. */
+static uint32_t crc_x2n[32];
+static sso_once_t crc_tables_once = SSO_ONCE_INIT;
+
+/* a * b mod P in the reflected bit order CRC-32 uses. */
+static uint32_t crc_multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = 1u << 31, p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ SSO_CRC32_POLY : b >> 1;
+    }
+    return p;
+}
+
+static void crc_tables_build(void) {
+    for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t c = b;
+        for (int k = 0; k < 8; ++k)
+            c = (c >> 1) ^ (SSO_CRC32_POLY & (0u - (c & 1u)));
+        crc_table[0][b] = c;
+    }
+    for (uint32_t b = 0; b < 256; ++b) {
+        for (int k = 1; k < 16; ++k)
+            crc_table[k][b] = (crc_table[k - 1][b] >> 8) ^ crc_table[0][crc_table[k - 1][b] & 0xFF];
+    }
+
+    uint32_t p = 1u << 30; /* x^1 */
+    crc_x2n[0] = p;
+    for (int k = 1; k < 32; ++k)
+        crc_x2n[k] = p = crc_multmodp(p, p);
+}
+
+static inline void crc_tables_init(void) {
+    sso_once(&crc_tables_once, crc_tables_build);
+}
+
+static inline uint32_t load_le32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+/* ================== KERNELS ================== */
+
+/* Kernels work on the inverted running value; sso_crc32 handles the pre/post inversion. */
+typedef uint32_t (*crc_kernel_fn)(uint32_t c, const uint8_t *p, size_t len);
+
+static uint32_t crc_slice16(uint32_t c, const uint8_t *p, size_t len) {
+    while (len >= 16) {
+        const uint32_t w0 = load_le32(p) ^ c;
+        const uint32_t w1 = load_le32(p + 4);
+        const uint32_t w2 = load_le32(p + 8);
+        const uint32_t w3 = load_le32(p + 12);
+        c = crc_table[15][w0 & 0xFF] ^ crc_table[14][(w0 >> 8) & 0xFF] ^
+            crc_table[13][(w0 >> 16) & 0xFF] ^ crc_table[12][w0 >> 24] ^
+            crc_table[11][w1 & 0xFF] ^ crc_table[10][(w1 >> 8) & 0xFF] ^
+            crc_table[9][(w1 >> 16) & 0xFF] ^ crc_table[8][w1 >> 24] ^
+            crc_table[7][w2 & 0xFF] ^ crc_table[6][(w2 >> 8) & 0xFF] ^
+            crc_table[5][(w2 >> 16) & 0xFF] ^ crc_table[4][w2 >> 24] ^
+            crc_table[3][w3 & 0xFF] ^ crc_table[2][(w3 >> 8) & 0xFF] ^
+            crc_table[1][(w3 >> 16) & 0xFF] ^ crc_table[0][w3 >> 24];
+        p += 16;
+        len -= 16;
+    }
+    while (len--)
+        c = (c >> 8) ^ crc_table[0][(c ^ *p++) & 0xFF];
+    return c;
+}
+
+#ifdef SSO_X86
+
+/*
+ * Carry-less multiply folding (Intel, "Fast CRC Computation for Generic
+ * Polynomials Using PCLMULQDQ"): four 128-bit lanes are folded 64 bytes at a
+ * time, merged into one, then Barrett-reduced to 32 bits. Constants are the
+ * bit-reflected x^k mod P values for CRC-32.
+ */
+SSO_TARGET("pclmul,sse4.1")
+static uint32_t crc_pclmul(uint32_t c, const uint8_t *p, size_t len) {
+    if (len < 64)
+        return crc_slice16(c, p, len);
+
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596ll, 0x0154442bd4ll);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009ell, 0x01751997d0ll);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124ll);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641ll, 0x01db710641ll);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i *) (p + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i *) (p + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i *) (p + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i *) (p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int) c));
+    p += 64;
+    len -= 64;
+
+    while (len >= 64) {
+        const __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        const __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        const __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        const __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *) (p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *) (p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *) (p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *) (p + 0x30)));
+        p += 64;
+        len -= 64;
+    }
+
+    /* Fold the four lanes into one. */
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *) p)), x5);
+        p += 16;
+        len -= 16;
+    }
+
+    /* 128 -> 64 bits. */
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+
+    /* Barrett reduction to 32 bits. */
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    c = (uint32_t) _mm_extract_epi32(x1, 1);
+    return crc_slice16(c, p, len);
+}
+
+#endif /* SSO_X86 */
+
+/* ================== KERNEL SELECTION ================== */
+
+static const crc_kernel_fn kernels[SSO_CRC32_KERNEL_COUNT] = {
+    NULL,
+    crc_slice16,
+#ifdef SSO_X86
+    crc_pclmul,
+#else
+    NULL,
+#endif
+};
+
+static const char *const kernel_names[SSO_CRC32_KERNEL_COUNT] = {
+    "auto", "slice16", "pclmul"
+};
+
+static int active = SSO_CRC32_AUTO;
+
+static sso_crc32_kernel_t detect_kernel(void) {
+    const uint32_t need = SSO_CPU_PCLMUL | SSO_CPU_SSE41;
+    if (kernels[SSO_CRC32_PCLMUL] && (sso_cpu_features() & need) == need)
+        return SSO_CRC32_PCLMUL;
+    return SSO_CRC32_SLICE16;
+}
+
+static inline crc_kernel_fn current_kernel(void) {
+    /* Every kernel finishes short tails with the tables. */
+    crc_tables_init();
+    int k = SSO_ATOMIC_LOAD_INT(&active);
+    if (k == SSO_CRC32_AUTO) {
+        k = (int) detect_kernel();
+        SSO_ATOMIC_STORE_INT(&active, k);
+    }
+    return kernels[k];
+}
+
+SSO_API int sso_crc32_kernel_supported(sso_crc32_kernel_t kernel) {
+    const uint32_t need = SSO_CPU_PCLMUL | SSO_CPU_SSE41;
+    switch (kernel) {
+        case SSO_CRC32_AUTO:
+        case SSO_CRC32_SLICE16:
+            return 1;
+        case SSO_CRC32_PCLMUL:
+            return kernels[kernel] && (sso_cpu_features() & need) == need;
+        default:
+            return 0;
+    }
+}
+
+SSO_API int sso_crc32_select_kernel(sso_crc32_kernel_t kernel) {
+    if (!sso_crc32_kernel_supported(kernel))
+        return 1;
+    SSO_ATOMIC_STORE_INT(&active, (int) kernel);
+    return 0;
+}
+
+SSO_API sso_crc32_kernel_t sso_crc32_active_kernel(void) {
+    current_kernel();
+    return (sso_crc32_kernel_t) SSO_ATOMIC_LOAD_INT(&active);
+}
+
+SSO_API const char *sso_crc32_kernel_name(sso_crc32_kernel_t kernel) {
+    if ((unsigned) kernel >= SSO_CRC32_KERNEL_COUNT)
+        return "unknown";
+    return kernel_names[kernel];
+}
+
+/* ================== CRC32 ================== */
+
+SSO_API uint32_t sso_crc32(uint32_t crc, const void *data, size_t len) {
+    if (!data || len == 0)
+        return crc;
+    return ~current_kernel()(~crc, (const uint8_t *) data, len);
+}
+
+SSO_API uint32_t sso_crc32_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b) {
+    crc_tables_init();
+
+    /* crc_a * x^(8 * len_b) mod P, built from the x^(2^k) table. */
+    uint32_t p = 1u << 31; /* x^0 */
+    unsigned k = 3;
+    while (len_b) {
+        if (len_b & 1)
+            p = crc_multmodp(crc_x2n[k & 31], p);
+        len_b >>= 1;
+        k++;
+    }
+    return crc_multmodp(p, crc_a) ^ crc_b;
+}
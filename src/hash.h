@@ -0,0 +1,49 @@
+#ifndef SSO_HASH_H
+#define SSO_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Seedless 64-bit byte hash. Results must stay stable across runs and
+ * builds because they end up in sidecar caches and snapshots.
+ */
+
+static inline uint64_t sso_hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint64_t sso_hash_bytes(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *) data;
+    uint64_t h = 0x9e3779b97f4a7c15ull ^ ((uint64_t) len * 0xff51afd7ed558ccdull);
+
+    while (len >= 8) {
+        uint64_t k;
+        memcpy(&k, p, 8);
+        h = (h ^ sso_hash_mix(k)) * 0x9e3779b97f4a7c15ull;
+        h ^= h >> 29;
+        p += 8;
+        len -= 8;
+    }
+
+    uint64_t tail = 0;
+    for (size_t i = 0; i < len; ++i)
+        tail |= (uint64_t) p[i] << (8 * i);
+    h ^= sso_hash_mix(tail ^ 0x2545f4914f6cdd1dull);
+
+    return sso_hash_mix(h);
+}
+
+/* 32-bit form stored inline in the open-addressing tables. */
+static inline uint32_t sso_hash32(const void *data, size_t len) {
+    const uint64_t h = sso_hash_bytes(data, len);
+    return (uint32_t) (h ^ (h >> 32));
+}
+
+#endif /* SSO_HASH_H */
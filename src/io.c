@@ -0,0 +1,345 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#define SSO_BUILD_DLL
+#include "io.h"
+#include "map.h"
+#include "alloc.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+/* The CRT's <io.h> is shadowed by headers/io.h on the include path. */
+intptr_t __cdecl _get_osfhandle(int fd);
+#else
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* pread window of the fd backend. */
+#define SSO_READER_FD_BUFFER (1u << 16)
+
+/* ================== INTERNAL HELPERS ================== */
+
+/* Chunk bound for single read/write calls, which take 32-bit counts on Windows. */
+#define SSO_IO_CHUNK ((size_t) 1 << 30)
+
+typedef struct {
+    int      fd;
+    uint64_t offset;   /* file position just past the window */
+    uint8_t  buf[SSO_READER_FD_BUFFER];
+} sso_fd_reader_t;
+
+/* Up to `n` bytes at `offset`; 0 at end of file, -1 on error. */
+static long long fd_pread(int fd, void *buf, size_t n, uint64_t offset) {
+    if (n > SSO_IO_CHUNK)
+        n = SSO_IO_CHUNK;
+#ifdef _WIN32
+    HANDLE h = (HANDLE) _get_osfhandle(fd);
+    if (h == INVALID_HANDLE_VALUE)
+        return -1;
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+    ov.Offset = (DWORD) offset;
+    ov.OffsetHigh = (DWORD) (offset >> 32);
+    DWORD got = 0;
+    if (!ReadFile(h, buf, (DWORD) n, &got, &ov))
+        return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+    return (long long) got;
+#else
+    for (;;) {
+        const ssize_t got = pread(fd, buf, n, (off_t) offset);
+        if (got >= 0)
+            return (long long) got;
+        if (errno != EINTR)
+            return -1;
+    }
+#endif
+}
+
+/* ================== READER BACKENDS ================== */
+
+static int mem_read(sso_reader_t *r, void *buf, size_t n) {
+    /* Only reached when the window is short: the source is exhausted. */
+    (void) r;
+    (void) buf;
+    (void) n;
+    return 1;
+}
+
+static int mem_remaining(sso_reader_t *r, uint64_t *out) {
+    *out = r->size - r->pos;
+    return 0;
+}
+
+static const sso_reader_ops_t sso_mem_reader_ops = { mem_read, mem_remaining, NULL };
+
+static void mmap_close(sso_reader_t *r) {
+    sso_map_close((sso_map_t *) r->ctx);
+    sso_free(r->ctx);
+}
+
+static const sso_reader_ops_t sso_mmap_reader_ops = { mem_read, mem_remaining, mmap_close };
+
+static int fd_read(sso_reader_t *r, void *buf, size_t n) {
+    sso_fd_reader_t *s = (sso_fd_reader_t *) r->ctx;
+    uint8_t *out = (uint8_t *) buf;
+
+    const size_t have = r->size - r->pos;
+    if (have) {
+        memcpy(out, r->data + r->pos, have);
+        out += have;
+        n -= have;
+        r->pos = r->size;
+    }
+
+    /* Large reads skip the window; small ones refill it and take their share. */
+    while (n >= sizeof(s->buf)) {
+        const long long got = fd_pread(s->fd, out, n, s->offset);
+        if (got <= 0)
+            return 1;
+        s->offset += (uint64_t) got;
+        out += got;
+        n -= (size_t) got;
+    }
+    while (n) {
+        const long long got = fd_pread(s->fd, s->buf, sizeof(s->buf), s->offset);
+        if (got <= 0)
+            return 1;
+        s->offset += (uint64_t) got;
+        const size_t take = n < (size_t) got ? n : (size_t) got;
+        memcpy(out, s->buf, take);
+        out += take;
+        n -= take;
+        r->data = s->buf;
+        r->size = (size_t) got;
+        r->pos = take;
+    }
+    return 0;
+}
+
+static int fd_remaining(sso_reader_t *r, uint64_t *out) {
+    const sso_fd_reader_t *s = (const sso_fd_reader_t *) r->ctx;
+    uint64_t size;
+#ifdef _WIN32
+    LARGE_INTEGER li;
+    HANDLE h = (HANDLE) _get_osfhandle(s->fd);
+    if (h == INVALID_HANDLE_VALUE || !GetFileSizeEx(h, &li) || li.QuadPart < 0)
+        return 1;
+    size = (uint64_t) li.QuadPart;
+#else
+    struct stat st;
+    if (fstat(s->fd, &st) != 0 || st.st_size < 0)
+        return 1;
+    size = (uint64_t) st.st_size;
+#endif
+    /* Whatever is still in the window plus what lies past it. */
+    *out = (size > s->offset ? size - s->offset : 0) + (r->size - r->pos);
+    return 0;
+}
+
+static void fd_close(sso_reader_t *r) {
+    sso_free(r->ctx);
+}
+
+static const sso_reader_ops_t sso_fd_reader_ops = { fd_read, fd_remaining, fd_close };
+
+static int stdio_read(sso_reader_t *r, void *buf, size_t n) {
+    return io_read_exact((FILE *) r->ctx, buf, n);
+}
+
+/* Bytes from the current position to the end; the position is restored. */
+static int stdio_remaining(sso_reader_t *r, uint64_t *out) {
+    FILE *f = (FILE *) r->ctx;
+    const long here = ftell(f);
+    if (here < 0 || fseek(f, 0, SEEK_END) != 0)
+        return 1;
+    const long end = ftell(f);
+    if (fseek(f, here, SEEK_SET) != 0 || end < here)
+        return 1;
+    *out = (uint64_t) (end - here);
+    return 0;
+}
+
+static const sso_reader_ops_t sso_stdio_reader_ops = { stdio_read, stdio_remaining, NULL };
+
+/* ================== READER API ================== */
+
+SSO_API void sso_reader_init_mem(sso_reader_t *r, const void *data, size_t size) {
+    if (!r)
+        return;
+    memset(r, 0, sizeof(*r));
+    r->ops = &sso_mem_reader_ops;
+    /* A NULL window would send every read to mem_read, so empty input gets a dummy one. */
+    r->data = data ? (const uint8_t *) data : (const uint8_t *) "";
+    r->size = data ? size : 0;
+}
+
+SSO_API int sso_reader_open_mmap(sso_reader_t *r, const char *filename) {
+    if (!r || !filename)
+        return 1;
+    memset(r, 0, sizeof(*r));
+
+    sso_map_t *m = (sso_map_t *) sso_calloc(1, sizeof(sso_map_t));
+    if (!m)
+        return 1;
+    if (sso_map_open(filename, 0, m)) {
+        sso_free(m);
+        return 1;
+    }
+
+    r->ops = &sso_mmap_reader_ops;
+    r->data = m->data ? m->data : (const uint8_t *) "";
+    r->size = m->size;
+    r->ctx = m;
+    return 0;
+}
+
+SSO_API int sso_reader_init_fd(sso_reader_t *r, int fd, uint64_t offset) {
+    if (!r || fd < 0)
+        return 1;
+    memset(r, 0, sizeof(*r));
+
+    sso_fd_reader_t *s = (sso_fd_reader_t *) sso_malloc(sizeof(sso_fd_reader_t));
+    if (!s)
+        return 1;
+    s->fd = fd;
+    s->offset = offset;
+
+    r->ops = &sso_fd_reader_ops;
+    r->data = s->buf;
+    r->ctx = s;
+    return 0;
+}
+
+SSO_API void sso_reader_init_stdio(sso_reader_t *r, FILE *f) {
+    if (!r)
+        return;
+    memset(r, 0, sizeof(*r));
+    r->ops = &sso_stdio_reader_ops;
+    r->ctx = f;
+}
+
+SSO_API int sso_reader_remaining(sso_reader_t *r, uint64_t *out) {
+    if (!r || !out || !r->ops || !r->ops->remaining)
+        return 1;
+    return r->ops->remaining(r, out);
+}
+
+SSO_API void sso_reader_close(sso_reader_t *r) {
+    if (!r)
+        return;
+    if (r->ops && r->ops->close)
+        r->ops->close(r);
+    memset(r, 0, sizeof(*r));
+}
+
+/* ================== WRITER BACKENDS ================== */
+
+static int mem_write(sso_writer_t *w, const void *buf, size_t n) {
+    if (n > SIZE_MAX - w->size)
+        return 1;
+    if (w->capacity - w->size < n) {
+        size_t cap = w->capacity ? w->capacity : 4096;
+        while (cap < w->size + n)
+            cap = cap > SIZE_MAX / 2 ? w->size + n : cap * 2;
+        uint8_t *grown = (uint8_t *) sso_realloc(w->data, cap);
+        if (!grown)
+            return 1;
+        w->data = grown;
+        w->capacity = cap;
+    }
+    if (n)
+        memcpy(w->data + w->size, buf, n);
+    w->size += n;
+    return 0;
+}
+
+static void mem_close(sso_writer_t *w) {
+    sso_free(w->data);
+}
+
+static const sso_writer_ops_t sso_mem_writer_ops = { mem_write, mem_close };
+
+static int fd_write(sso_writer_t *w, const void *buf, size_t n) {
+    const int fd = (int) (intptr_t) w->ctx;
+    const uint8_t *p = (const uint8_t *) buf;
+
+    while (n) {
+        const size_t chunk = n > SSO_IO_CHUNK ? SSO_IO_CHUNK : n;
+#ifdef _WIN32
+        HANDLE h = (HANDLE) _get_osfhandle(fd);
+        DWORD put = 0;
+        if (h == INVALID_HANDLE_VALUE || !WriteFile(h, p, (DWORD) chunk, &put, NULL) || put == 0)
+            return 1;
+        const size_t done = put;
+#else
+        const ssize_t put = write(fd, p, chunk);
+        if (put < 0 && errno == EINTR)
+            continue;
+        if (put <= 0)
+            return 1;
+        const size_t done = (size_t) put;
+#endif
+        p += done;
+        n -= done;
+    }
+    return 0;
+}
+
+static const sso_writer_ops_t sso_fd_writer_ops = { fd_write, NULL };
+
+static int stdio_write(sso_writer_t *w, const void *buf, size_t n) {
+    return io_write_exact((FILE *) w->ctx, buf, n);
+}
+
+static const sso_writer_ops_t sso_stdio_writer_ops = { stdio_write, NULL };
+
+/* ================== WRITER API ================== */
+
+SSO_API void sso_writer_init_mem(sso_writer_t *w) {
+    if (!w)
+        return;
+    memset(w, 0, sizeof(*w));
+    w->ops = &sso_mem_writer_ops;
+}
+
+SSO_API void sso_writer_init_fd(sso_writer_t *w, int fd) {
+    if (!w)
+        return;
+    memset(w, 0, sizeof(*w));
+    w->ops = &sso_fd_writer_ops;
+    w->ctx = (void *) (intptr_t) fd;
+}
+
+SSO_API void sso_writer_init_stdio(sso_writer_t *w, FILE *f) {
+    if (!w)
+        return;
+    memset(w, 0, sizeof(*w));
+    w->ops = &sso_stdio_writer_ops;
+    w->ctx = f;
+}
+
+SSO_API void *sso_writer_take(sso_writer_t *w, size_t *size) {
+    if (!w || w->ops != &sso_mem_writer_ops)
+        return NULL;
+    void *data = w->data;
+    if (size)
+        *size = w->size;
+    w->data = NULL;
+    w->size = 0;
+    w->capacity = 0;
+    return data;
+}
+
+SSO_API void sso_writer_close(sso_writer_t *w) {
+    if (!w)
+        return;
+    if (w->ops && w->ops->close)
+        w->ops->close(w);
+    memset(w, 0, sizeof(*w));
+}
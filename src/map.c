@@ -0,0 +1,107 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "map.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+int sso_map_open(const char *filename, int copy_on_write, sso_map_t *m) {
+    if (!filename || !m)
+        return 1;
+    memset(m, 0, sizeof(*m));
+
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return 1;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 ||
+        (unsigned long long) size.QuadPart > (size_t) -1) {
+        CloseHandle(file);
+        return 1;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL,
+                                        copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY,
+                                        0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return 1;
+    }
+
+    void *data = MapViewOfFile(mapping, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return 1;
+    }
+
+    m->data = (uint8_t *) data;
+    m->size = (size_t) size.QuadPart;
+    m->file = file;
+    m->mapping = mapping;
+    return 0;
+}
+
+void sso_map_close(sso_map_t *m) {
+    if (!m)
+        return;
+    if (m->data)
+        UnmapViewOfFile(m->data);
+    if (m->mapping)
+        CloseHandle(m->mapping);
+    if (m->file)
+        CloseHandle(m->file);
+    memset(m, 0, sizeof(*m));
+}
+
+#else
+
+int sso_map_open(const char *filename, int copy_on_write, sso_map_t *m) {
+    if (!filename || !m)
+        return 1;
+    memset(m, 0, sizeof(*m));
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return 1;
+
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size <= 0) {
+        close(fd);
+        return 1;
+    }
+
+    int prot = copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *data = mmap(NULL, (size_t) st.st_size, prot, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return 1;
+
+    m->data = (uint8_t *) data;
+    m->size = (size_t) st.st_size;
+    return 0;
+}
+
+void sso_map_close(sso_map_t *m) {
+    if (!m)
+        return;
+    if (m->data)
+        munmap(m->data, m->size);
+    memset(m, 0, sizeof(*m));
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef SSO_MAP_H
+#define SSO_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Read-only or copy-on-write view of a whole file.
+ *
+ * A copy-on-write mapping may be modified in place (e.g. to undo the text
+ * obfuscation) without touching the file on disk; only the pages that are
+ * actually written get private copies.
+ */
+typedef struct {
+    uint8_t *data;
+    size_t   size;
+#ifdef _WIN32
+    void    *file;
+    void    *mapping;
+#endif
+} sso_map_t;
+
+int  sso_map_open(const char *filename, int copy_on_write, sso_map_t *m);
+void sso_map_close(sso_map_t *m);
+
+#endif /* SSO_MAP_H */
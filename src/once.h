@@ -0,0 +1,44 @@
+#ifndef SSO_ONCE_H
+#define SSO_ONCE_H
+
+/*
+ * One-time initialisation. Everything the init function writes is visible
+ * to every caller once sso_once returns, which a plain ready flag does not
+ * guarantee.
+ */
+#ifdef _WIN32
+#include <windows.h>
+
+typedef INIT_ONCE sso_once_t;
+#define SSO_ONCE_INIT INIT_ONCE_STATIC_INIT
+
+static BOOL CALLBACK sso_once_thunk(PINIT_ONCE once, PVOID param, PVOID *ctx) {
+    (void) once;
+    (void) ctx;
+    (*(void (**)(void)) param)();
+    return TRUE;
+}
+
+static inline void sso_once(sso_once_t *once, void (*fn)(void)) {
+    InitOnceExecuteOnce(once, sso_once_thunk, (PVOID) &fn, NULL);
+}
+
+/* Word-sized settings read on hot paths; aligned int access is atomic. */
+#define SSO_ATOMIC_LOAD_INT(p)     (*(volatile int *) (p))
+#define SSO_ATOMIC_STORE_INT(p, v) (*(volatile int *) (p) = (v))
+#else
+#include <pthread.h>
+
+typedef pthread_once_t sso_once_t;
+#define SSO_ONCE_INIT PTHREAD_ONCE_INIT
+
+static inline void sso_once(sso_once_t *once, void (*fn)(void)) {
+    pthread_once(once, fn);
+}
+
+/* Word-sized settings read on hot paths; no ordering is implied. */
+#define SSO_ATOMIC_LOAD_INT(p)     __atomic_load_n((p), __ATOMIC_RELAXED)
+#define SSO_ATOMIC_STORE_INT(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#endif
+
+#endif /* SSO_ONCE_H */
@@ -0,0 +1,149 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#define SSO_BUILD_DLL
+#include "pool.h"
+#include "alloc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define SSO_POOL_MAX_THREADS 256
+
+typedef struct {
+    volatile int64_t next;
+    size_t           count;
+    size_t           grain;
+    sso_pool_fn      fn;
+    void            *ctx;
+    const sso_allocator_t *allocator;  /* caller's override, adopted by every worker */
+} sso_pool_job_t;
+
+typedef struct {
+    sso_pool_job_t *job;
+    unsigned        worker;
+} sso_pool_arg_t;
+
+static int64_t claim(volatile int64_t *next, int64_t n) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return InterlockedExchangeAdd64((volatile LONG64 *) next, n);
+#else
+    return __atomic_fetch_add(next, n, __ATOMIC_RELAXED);
+#endif
+}
+
+static void pool_work(sso_pool_job_t *job, unsigned worker) {
+    for (;;) {
+        const int64_t begin = claim(&job->next, (int64_t) job->grain);
+        if (begin < 0 || (size_t) begin >= job->count)
+            return;
+        size_t end = (size_t) begin + job->grain;
+        if (end > job->count)
+            end = job->count;
+        job->fn(job->ctx, (size_t) begin, end, worker);
+    }
+}
+
+#ifdef _WIN32
+static unsigned __stdcall pool_thread(void *p) {
+    sso_pool_arg_t *arg = (sso_pool_arg_t *) p;
+    sso_set_thread_allocator(arg->job->allocator);
+    pool_work(arg->job, arg->worker);
+    return 0;
+}
+#else
+static void *pool_thread(void *p) {
+    sso_pool_arg_t *arg = (sso_pool_arg_t *) p;
+    sso_set_thread_allocator(arg->job->allocator);
+    pool_work(arg->job, arg->worker);
+    return NULL;
+}
+#endif
+
+unsigned sso_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? (unsigned) info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (unsigned) n : 1;
+#endif
+}
+
+unsigned sso_pool_threads(unsigned nthreads, size_t count, size_t grain) {
+    if (nthreads == 0)
+        nthreads = sso_cpu_count();
+    if (nthreads > SSO_POOL_MAX_THREADS)
+        nthreads = SSO_POOL_MAX_THREADS;
+    if (grain == 0)
+        grain = 1;
+
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks < nthreads)
+        nthreads = chunks ? (unsigned) chunks : 1;
+    return nthreads;
+}
+
+void sso_parallel_for(unsigned nthreads, size_t count, size_t grain, sso_pool_fn fn, void *ctx) {
+    if (!fn || count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+
+    nthreads = sso_pool_threads(nthreads, count, grain);
+
+    sso_pool_job_t job;
+    job.next = 0;
+    job.count = count;
+    job.grain = grain;
+    job.fn = fn;
+    job.ctx = ctx;
+    job.allocator = sso_get_thread_allocator();
+
+    if (nthreads == 1) {
+        pool_work(&job, 0);
+        return;
+    }
+
+    sso_pool_arg_t args[SSO_POOL_MAX_THREADS];
+#ifdef _WIN32
+    HANDLE threads[SSO_POOL_MAX_THREADS];
+#else
+    pthread_t threads[SSO_POOL_MAX_THREADS];
+#endif
+    int started[SSO_POOL_MAX_THREADS];
+
+    for (unsigned t = 1; t < nthreads; ++t) {
+        args[t].job = &job;
+        args[t].worker = t;
+#ifdef _WIN32
+        threads[t] = (HANDLE) _beginthreadex(NULL, 0, pool_thread, &args[t], 0, NULL);
+        started[t] = threads[t] != 0;
+#else
+        started[t] = pthread_create(&threads[t], NULL, pool_thread, &args[t]) == 0;
+#endif
+    }
+
+    pool_work(&job, 0);
+
+    for (unsigned t = 1; t < nthreads; ++t) {
+        if (!started[t])
+            continue;
+#ifdef _WIN32
+        WaitForSingleObject(threads[t], INFINITE);
+        CloseHandle(threads[t]);
+#else
+        pthread_join(threads[t], NULL);
+#endif
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef SSO_POOL_H
+#define SSO_POOL_H
+
+#include <stddef.h>
+
+/*
+ * Minimal fork/join helper. The calling thread works alongside
+ * `nthreads - 1` spawned threads; items are claimed `grain` at a time from a
+ * shared counter, so uneven items (files of different sizes) balance out.
+ */
+typedef void (*sso_pool_fn)(void *ctx, size_t begin, size_t end, unsigned worker);
+
+/* Online CPU count, at least 1. */
+unsigned sso_cpu_count(void);
+
+/* Resolves 0 to sso_cpu_count() and clamps to the amount of work available. */
+unsigned sso_pool_threads(unsigned nthreads, size_t count, size_t grain);
+
+/*
+ * Runs fn over [0, count) and returns once every item is done. `worker` is in
+ * [0, sso_pool_threads(...)). If threads cannot be started the remaining
+ * workers simply do more of the items.
+ */
+void sso_parallel_for(unsigned nthreads, size_t count, size_t grain, sso_pool_fn fn, void *ctx);
+
+#endif /* SSO_POOL_H */
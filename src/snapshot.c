@@ -0,0 +1,468 @@
+#define SSO_BUILD_DLL
+#define TEXT_BUILD_DLL
+#define VF_BUILD_DLL
+#include "snapshot.h"
+#include "hash.h"
+#include "map.h"
+#include "write.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define SSO_SNAPSHOT_EMPTY    UINT32_MAX
+#define SSO_SNAPSHOT_MIN_CAP  16u
+
+typedef struct {
+    char     magic[4];
+    uint32_t version;
+    uint32_t kind;
+    uint32_t entry_count;
+    uint32_t record_size;
+    uint32_t table_slots;
+    uint32_t records_offset;
+    uint32_t table_offset;
+    uint64_t heap_offset;
+    uint64_t heap_size;
+    uint64_t payload_hash;    /* see sso_snapshot_hash */
+    uint8_t  source_header[16];
+} sso_snapshot_header_t;
+
+/* Open-addressing slot; the first slot for a key on its probe path is its lowest entry. */
+typedef struct {
+    uint32_t hash;
+    uint32_t index;
+} sso_snapshot_slot_t;
+
+struct sso_snapshot {
+    sso_map_t                    map;
+    const sso_snapshot_header_t *header;
+    const uint8_t               *records;
+    const sso_snapshot_slot_t   *table;
+    const char                  *heap;
+};
+
+static const char sso_snapshot_magic[4] = { 'S', 'S', 'O', 'S' };
+
+/* Image under construction: sizes are fixed by a first pass, so nothing ever moves. */
+typedef struct {
+    uint8_t             *buf;
+    size_t               size;
+    uint8_t             *records;
+    sso_snapshot_slot_t *table;
+    char                *heap;
+    uint64_t             heap_pos;
+    uint32_t             mask;
+} sso_snapshot_image_t;
+
+static uint32_t sso_snapshot_table_slots(uint32_t n) {
+    uint64_t cap = SSO_SNAPSHOT_MIN_CAP;
+    while (cap < (uint64_t) n * 2)
+        cap <<= 1;
+    return cap > 0x80000000u ? 0 : (uint32_t) cap;
+}
+
+static int sso_snapshot_image_init(sso_snapshot_image_t *img, uint32_t kind, uint32_t n, uint32_t record_size,
+                                   uint64_t heap_size, const void *source_header, size_t source_header_size) {
+    memset(img, 0, sizeof(*img));
+
+    const uint32_t slots = sso_snapshot_table_slots(n);
+    const uint64_t records_offset = sizeof(sso_snapshot_header_t);
+    const uint64_t table_offset = records_offset + (uint64_t) n * record_size;
+    const uint64_t heap_offset = table_offset + (uint64_t) slots * sizeof(sso_snapshot_slot_t);
+    /* Heap offsets are 32-bit; the last byte is a NUL so any in-range offset reads a terminated string. */
+    heap_size += 1;
+    if (slots == 0 || heap_offset > UINT32_MAX || heap_size >= SSO_SNAPSHOT_NONE)
+        return 1;
+
+    img->size = (size_t) (heap_offset + heap_size);
+    img->buf = (uint8_t *) sso_calloc(img->size, 1);
+    if (!img->buf)
+        return 1;
+    img->records = img->buf + records_offset;
+    img->table = (sso_snapshot_slot_t *) (img->buf + table_offset);
+    img->heap = (char *) (img->buf + heap_offset);
+    img->mask = slots - 1;
+    for (uint32_t i = 0; i < slots; ++i)
+        img->table[i].index = SSO_SNAPSHOT_EMPTY;
+
+    sso_snapshot_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, sso_snapshot_magic, 4);
+    h.version = SSO_SNAPSHOT_VERSION;
+    h.kind = kind;
+    h.entry_count = n;
+    h.record_size = record_size;
+    h.table_slots = slots;
+    h.records_offset = (uint32_t) records_offset;
+    h.table_offset = (uint32_t) table_offset;
+    h.heap_offset = heap_offset;
+    h.heap_size = heap_size;
+    memcpy(h.source_header, source_header, source_header_size);
+    memcpy(img->buf, &h, sizeof(h));
+    return 0;
+}
+
+/* Copies `len` bytes plus a NUL into the heap, aligned to `align`; SSO_SNAPSHOT_NONE for NULL. */
+static uint32_t sso_snapshot_image_put(sso_snapshot_image_t *img, const void *data, size_t len, uint32_t align) {
+    if (!data)
+        return SSO_SNAPSHOT_NONE;
+    img->heap_pos = (img->heap_pos + align - 1) & ~(uint64_t) (align - 1);
+    const uint32_t offset = (uint32_t) img->heap_pos;
+    memcpy(img->heap + offset, data, len);
+    img->heap_pos += len + 1;
+    return offset;
+}
+
+static void sso_snapshot_image_index(sso_snapshot_image_t *img, const char *key, size_t len, uint32_t index) {
+    if (!key)
+        return;
+    const uint32_t hash = sso_hash32(key, len);
+    uint32_t pos = hash & img->mask;
+    while (img->table[pos].index != SSO_SNAPSHOT_EMPTY)
+        pos = (pos + 1) & img->mask;
+    img->table[pos].hash = hash;
+    img->table[pos].index = index;
+}
+
+/*
+ * Everything after the header plus the copied source header. The other
+ * header fields are checked against each other and the file size on open.
+ */
+static uint64_t sso_snapshot_hash(const sso_snapshot_header_t *h, const uint8_t *payload, size_t len) {
+    return sso_hash_bytes(payload, len) ^ sso_hash_mix(sso_hash_bytes(h->source_header, sizeof(h->source_header)));
+}
+
+static int sso_snapshot_image_store(sso_snapshot_image_t *img, const char *filename) {
+    sso_snapshot_header_t h;
+    memcpy(&h, img->buf, sizeof(h));
+    h.payload_hash = sso_snapshot_hash(&h, img->buf + sizeof(h), img->size - sizeof(h));
+    memcpy(img->buf, &h, sizeof(h));
+
+    const int rc = sso_write_atomic(filename, img->buf, img->size, SSO_WRITE_SYNC);
+    sso_free(img->buf);
+    return rc;
+}
+
+/* Checks that every section the header describes lies inside the mapping, in order. */
+static int sso_snapshot_validate(const sso_snapshot_header_t *h, size_t size) {
+    if (memcmp(h->magic, sso_snapshot_magic, 4) != 0 || h->version != SSO_SNAPSHOT_VERSION)
+        return 1;
+    if ((h->kind != SSO_SNAPSHOT_TEXT || h->record_size != sizeof(sso_snapshot_text_record_t)) &&
+        (h->kind != SSO_SNAPSHOT_VF || h->record_size != sizeof(sso_snapshot_vf_record_t)))
+        return 1;
+    if (h->table_slots < SSO_SNAPSHOT_MIN_CAP || (h->table_slots & (h->table_slots - 1)) != 0 ||
+        h->table_slots / 2 < h->entry_count)
+        return 1;
+    if (h->records_offset != sizeof(sso_snapshot_header_t) ||
+        h->table_offset != h->records_offset + (uint64_t) h->entry_count * h->record_size ||
+        h->heap_offset != h->table_offset + (uint64_t) h->table_slots * sizeof(sso_snapshot_slot_t))
+        return 1;
+    return h->heap_size == 0 || h->heap_size > size || h->heap_offset + h->heap_size != size;
+}
+
+/* ================== EXPORT ================== */
+
+SSO_API int sso_snapshot_write_text(const char *filename, const text_file_t *tf) {
+    if (!filename || !tf)
+        return 1;
+    const uint32_t n = tf->header.entry_count;
+    if (n > 0 && !tf->entries)
+        return 1;
+
+    /* Each value may need one byte of padding to stay 2-byte aligned for UTF-16 access. */
+    uint64_t heap_size = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const text_entry_t *e = &tf->entries[i];
+        if (e->key)
+            heap_size += strlen(e->key) + 1;
+        if (e->value)
+            heap_size += (uint64_t) e->value_length + 2;
+    }
+
+    sso_snapshot_image_t img;
+    if (sso_snapshot_image_init(&img, SSO_SNAPSHOT_TEXT, n, sizeof(sso_snapshot_text_record_t), heap_size,
+                                &tf->header, sizeof(text_header_t)))
+        return 1;
+
+    sso_snapshot_text_record_t *records = (sso_snapshot_text_record_t *) img.records;
+    for (uint32_t i = 0; i < n; ++i) {
+        const text_entry_t *e = &tf->entries[i];
+        sso_snapshot_text_record_t *r = &records[i];
+        const size_t key_len = e->key ? strlen(e->key) : 0;
+
+        r->key = sso_snapshot_image_put(&img, e->key, key_len, 1);
+        r->key_length = (uint32_t) key_len;
+        r->value = sso_snapshot_image_put(&img, e->value, e->value ? e->value_length : 0, 2);
+        r->value_length = e->value_length;
+        memcpy(r->unknown, e->unknown, 2);
+        r->key_offset = e->key_offset;
+        r->value_offset = e->value_offset;
+        memcpy(r->unknown2, e->unknown2, 4);
+        memcpy(r->unknown3, e->unknown3, 4);
+        r->unknown4 = e->unknown4;
+        r->unknown5 = e->unknown5;
+        r->unknown6 = e->unknown6;
+
+        sso_snapshot_image_index(&img, e->key, key_len, i);
+    }
+    return sso_snapshot_image_store(&img, filename);
+}
+
+SSO_API int sso_snapshot_write_vf(const char *filename, const vf_file_t *vf) {
+    if (!filename || !vf)
+        return 1;
+    const uint32_t n = vf->header.entry_count;
+    if (n > 0 && !vf->entries)
+        return 1;
+
+    uint64_t heap_size = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const vf_entry_t *e = &vf->entries[i];
+        if (e->file_name)
+            heap_size += strlen(e->file_name) + 1;
+        if (e->file_path)
+            heap_size += strlen(e->file_path) + 1;
+    }
+
+    sso_snapshot_image_t img;
+    if (sso_snapshot_image_init(&img, SSO_SNAPSHOT_VF, n, sizeof(sso_snapshot_vf_record_t), heap_size,
+                                &vf->header, sizeof(vf_header_t)))
+        return 1;
+
+    sso_snapshot_vf_record_t *records = (sso_snapshot_vf_record_t *) img.records;
+    for (uint32_t i = 0; i < n; ++i) {
+        const vf_entry_t *e = &vf->entries[i];
+        sso_snapshot_vf_record_t *r = &records[i];
+        const size_t name_len = e->file_name ? strlen(e->file_name) : 0;
+        const size_t path_len = e->file_path ? strlen(e->file_path) : 0;
+
+        r->name = sso_snapshot_image_put(&img, e->file_name, name_len, 1);
+        r->name_length = (uint32_t) name_len;
+        r->path = sso_snapshot_image_put(&img, e->file_path, path_len, 1);
+        r->path_length = (uint32_t) path_len;
+        memcpy(r->unknown1, e->unknown1, 8);
+        memcpy(r->original_crc, e->original_crc, 4);
+        memcpy(r->exported_crc, e->exported_crc, 4);
+        memcpy(r->unknown2, e->unknown2, 4);
+        r->file_size = e->file_size;
+        memcpy(r->unknown4, e->unknown4, 8);
+        r->source_file_number = e->source_file_number;
+        memcpy(r->unknown5, e->unknown5, 4);
+
+        sso_snapshot_image_index(&img, e->file_path, path_len, i);
+    }
+    return sso_snapshot_image_store(&img, filename);
+}
+
+/* ================== ACCESS ================== */
+
+SSO_API sso_snapshot_t *sso_snapshot_open(const char *filename) {
+    if (!filename)
+        return NULL;
+
+    sso_snapshot_t *s = (sso_snapshot_t *) sso_calloc(1, sizeof(sso_snapshot_t));
+    if (!s)
+        return NULL;
+    if (sso_map_open(filename, 0, &s->map)) {
+        sso_free(s);
+        return NULL;
+    }
+
+    const sso_snapshot_header_t *h = (const sso_snapshot_header_t *) s->map.data;
+    if (s->map.size < sizeof(sso_snapshot_header_t) || sso_snapshot_validate(h, s->map.size) ||
+        s->map.data[s->map.size - 1] != '\0') {
+        sso_snapshot_close(s);
+        return NULL;
+    }
+
+    s->header = h;
+    s->records = s->map.data + h->records_offset;
+    s->table = (const sso_snapshot_slot_t *) (s->map.data + h->table_offset);
+    s->heap = (const char *) (s->map.data + h->heap_offset);
+    return s;
+}
+
+SSO_API void sso_snapshot_close(sso_snapshot_t *s) {
+    if (!s)
+        return;
+    if (s->map.data)
+        sso_map_close(&s->map);
+    sso_free(s);
+}
+
+SSO_API int sso_snapshot_verify(const sso_snapshot_t *s) {
+    if (!s)
+        return 1;
+    const uint8_t *payload = s->map.data + sizeof(sso_snapshot_header_t);
+    if (sso_snapshot_hash(s->header, payload, s->map.size - sizeof(sso_snapshot_header_t)) != s->header->payload_hash)
+        return 1;
+
+    /* With the hash intact only a buggy writer could break these, but they are what accessors rely on. */
+    const uint32_t n = s->header->entry_count;
+    for (uint32_t i = 0; i < s->header->table_slots; ++i) {
+        const uint32_t index = s->table[i].index;
+        if (index != SSO_SNAPSHOT_EMPTY && index >= n)
+            return 1;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t offsets[2], lengths[2];
+        if (s->header->kind == SSO_SNAPSHOT_TEXT) {
+            const sso_snapshot_text_record_t *r = sso_snapshot_text_record(s, i);
+            offsets[0] = r->key;
+            lengths[0] = r->key_length;
+            offsets[1] = r->value;
+            lengths[1] = r->value_length;
+        } else {
+            const sso_snapshot_vf_record_t *r = sso_snapshot_vf_record(s, i);
+            offsets[0] = r->name;
+            lengths[0] = r->name_length;
+            offsets[1] = r->path;
+            lengths[1] = r->path_length;
+        }
+        for (int k = 0; k < 2; ++k) {
+            if (offsets[k] != SSO_SNAPSHOT_NONE && (uint64_t) offsets[k] + lengths[k] >= s->header->heap_size)
+                return 1;
+        }
+    }
+    return 0;
+}
+
+SSO_API uint32_t sso_snapshot_kind(const sso_snapshot_t *s) {
+    return s ? s->header->kind : 0;
+}
+
+SSO_API uint32_t sso_snapshot_entry_count(const sso_snapshot_t *s) {
+    return s ? s->header->entry_count : 0;
+}
+
+SSO_API const text_header_t *sso_snapshot_text_header(const sso_snapshot_t *s) {
+    if (!s || s->header->kind != SSO_SNAPSHOT_TEXT)
+        return NULL;
+    return (const text_header_t *) s->header->source_header;
+}
+
+SSO_API const vf_header_t *sso_snapshot_vf_header(const sso_snapshot_t *s) {
+    if (!s || s->header->kind != SSO_SNAPSHOT_VF)
+        return NULL;
+    return (const vf_header_t *) s->header->source_header;
+}
+
+SSO_API const sso_snapshot_text_record_t *sso_snapshot_text_record(const sso_snapshot_t *s, uint32_t index) {
+    if (!s || s->header->kind != SSO_SNAPSHOT_TEXT || index >= s->header->entry_count)
+        return NULL;
+    return (const sso_snapshot_text_record_t *) s->records + index;
+}
+
+SSO_API const sso_snapshot_vf_record_t *sso_snapshot_vf_record(const sso_snapshot_t *s, uint32_t index) {
+    if (!s || s->header->kind != SSO_SNAPSHOT_VF || index >= s->header->entry_count)
+        return NULL;
+    return (const sso_snapshot_vf_record_t *) s->records + index;
+}
+
+SSO_API const char *sso_snapshot_string(const sso_snapshot_t *s, uint32_t offset) {
+    if (!s || offset == SSO_SNAPSHOT_NONE || offset >= s->header->heap_size)
+        return NULL;
+    return s->heap + offset;
+}
+
+SSO_API int sso_snapshot_find(const sso_snapshot_t *s, const char *key, size_t len, uint32_t *out) {
+    if (!s || !key || !out)
+        return 1;
+
+    const uint32_t hash = sso_hash32(key, len);
+    const uint32_t mask = s->header->table_slots - 1;
+    const int text = s->header->kind == SSO_SNAPSHOT_TEXT;
+
+    for (uint32_t pos = hash & mask; s->table[pos].index != SSO_SNAPSHOT_EMPTY; pos = (pos + 1) & mask) {
+        const uint32_t index = s->table[pos].index;
+        if (s->table[pos].hash != hash || index >= s->header->entry_count)
+            continue;
+
+        uint32_t offset, length;
+        if (text) {
+            const sso_snapshot_text_record_t *r = (const sso_snapshot_text_record_t *) s->records + index;
+            offset = r->key;
+            length = r->key_length;
+        } else {
+            const sso_snapshot_vf_record_t *r = (const sso_snapshot_vf_record_t *) s->records + index;
+            offset = r->path;
+            length = r->path_length;
+        }
+        const char *str = sso_snapshot_string(s, offset);
+        if (str && length == len && memcmp(str, key, len) == 0) {
+            *out = index;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+SSO_API text_entry_t *sso_snapshot_clone_text_entry(const sso_snapshot_t *s, uint32_t index) {
+    const sso_snapshot_text_record_t *r = sso_snapshot_text_record(s, index);
+    if (!r)
+        return NULL;
+
+    text_entry_t *e = text_entry_create();
+    if (!e)
+        return NULL;
+
+    const char *key = sso_snapshot_string(s, r->key);
+    const char *value = sso_snapshot_string(s, r->value);
+    if (key && !(e->key = (char *) sso_malloc((size_t) r->key_length + 1))) {
+        text_entry_free(e);
+        return NULL;
+    }
+    if (key)
+        memcpy(e->key, key, (size_t) r->key_length + 1);
+    if (value && !(e->value = (char *) sso_malloc(r->value_length ? r->value_length : 1))) {
+        text_entry_free(e);
+        return NULL;
+    }
+    if (value)
+        memcpy(e->value, value, r->value_length);
+
+    memcpy(e->unknown, r->unknown, 2);
+    e->key_offset = r->key_offset;
+    memcpy(e->unknown2, r->unknown2, 4);
+    memcpy(e->unknown3, r->unknown3, 4);
+    e->value_length = r->value_length;
+    e->unknown4 = r->unknown4;
+    e->unknown5 = r->unknown5;
+    e->unknown6 = r->unknown6;
+    e->value_offset = r->value_offset;
+    return e;
+}
+
+SSO_API vf_entry_t *sso_snapshot_clone_vf_entry(const sso_snapshot_t *s, uint32_t index) {
+    const sso_snapshot_vf_record_t *r = sso_snapshot_vf_record(s, index);
+    if (!r)
+        return NULL;
+
+    vf_entry_t *e = vf_entry_create();
+    if (!e)
+        return NULL;
+
+    const char *name = sso_snapshot_string(s, r->name);
+    const char *path = sso_snapshot_string(s, r->path);
+    if (name)
+        vf_entry_set_name(e, name);
+    if (path)
+        vf_entry_set_path(e, path);
+    if ((name && !e->file_name) || (path && !e->file_path)) {
+        vf_entry_free(e);
+        return NULL;
+    }
+
+    memcpy(e->unknown1, r->unknown1, 8);
+    memcpy(e->original_crc, r->original_crc, 4);
+    memcpy(e->exported_crc, r->exported_crc, 4);
+    memcpy(e->unknown2, r->unknown2, 4);
+    e->file_size = r->file_size;
+    memcpy(e->unknown4, r->unknown4, 8);
+    e->source_file_number = r->source_file_number;
+    memcpy(e->unknown5, r->unknown5, 4);
+    return e;
+}
@@ -0,0 +1,176 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#define SSO_BUILD_DLL
+#include "stats.h"
+#include "stats_internal.h"
+
+#include <string.h>
+
+#ifdef SSO_STATS
+
+#include "tls.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/* ================== INTERNAL HELPERS ================== */
+
+typedef struct {
+    sso_stats_t total;
+    sso_stats_t last;
+    uint32_t    flags;
+    uint32_t    depth;   /* nesting of instrumented operations */
+} sso_stats_thread_t;
+
+static SSO_TLS sso_stats_thread_t sso_stats_tls;
+
+static sso_trace_begin_fn sso_trace_begin;
+static sso_trace_end_fn   sso_trace_end;
+static void              *sso_trace_user;
+
+static uint64_t sso_stats_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t) ((double) now.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+/* ================== PROBES ================== */
+
+void sso_stats_op_begin(sso_stats_op_t *op, const char *name) {
+    sso_stats_thread_t *t = &sso_stats_tls;
+    op->name = name;
+    op->start = t->total;
+    t->depth++;
+    if (sso_trace_begin)
+        sso_trace_begin(sso_trace_user, name);
+}
+
+void sso_stats_op_end(sso_stats_op_t *op) {
+    sso_stats_thread_t *t = &sso_stats_tls;
+    const sso_stats_t *a = &t->total, *b = &op->start;
+
+    sso_stats_t delta;
+    delta.calls = 0;
+    delta.bytes_read = a->bytes_read - b->bytes_read;
+    delta.entries_parsed = a->entries_parsed - b->entries_parsed;
+    delta.alloc_count = a->alloc_count - b->alloc_count;
+    delta.alloc_bytes = a->alloc_bytes - b->alloc_bytes;
+    delta.io_ns = a->io_ns - b->io_ns;
+    delta.decode_ns = a->decode_ns - b->decode_ns;
+    delta.alloc_ns = a->alloc_ns - b->alloc_ns;
+    delta.index_ns = a->index_ns - b->index_ns;
+
+    /* Only the outermost operation is a call; nested ones are already inside its figures. */
+    if (t->depth > 0 && --t->depth == 0) {
+        delta.calls = 1;
+        t->total.calls++;
+        t->last = delta;
+    }
+
+    if (sso_trace_end)
+        sso_trace_end(sso_trace_user, op->name, &delta);
+}
+
+uint64_t sso_stats_time_begin(void) {
+    return (sso_stats_tls.flags & SSO_STATS_TIMING) ? sso_stats_now() : 0;
+}
+
+void sso_stats_time_end(sso_stats_phase_t phase, uint64_t start) {
+    if (!start)
+        return;
+    const uint64_t ns = sso_stats_now() - start;
+    sso_stats_t *s = &sso_stats_tls.total;
+    switch (phase) {
+    case SSO_STATS_PHASE_IO:     s->io_ns += ns; break;
+    case SSO_STATS_PHASE_DECODE: s->decode_ns += ns; break;
+    case SSO_STATS_PHASE_ALLOC:  s->alloc_ns += ns; break;
+    case SSO_STATS_PHASE_INDEX:  s->index_ns += ns; break;
+    }
+}
+
+void sso_stats_count_read(size_t bytes) {
+    sso_stats_tls.total.bytes_read += bytes;
+}
+
+void sso_stats_count_alloc(size_t bytes) {
+    sso_stats_tls.total.alloc_count++;
+    sso_stats_tls.total.alloc_bytes += bytes;
+}
+
+void sso_stats_count_entries(uint32_t n) {
+    sso_stats_tls.total.entries_parsed += n;
+}
+
+/* ================== PUBLIC API ================== */
+
+SSO_API int sso_stats_compiled_in(void) {
+    return 1;
+}
+
+SSO_API void sso_stats_set_flags(uint32_t flags) {
+    sso_stats_tls.flags = flags;
+}
+
+SSO_API void sso_stats_thread_get(sso_stats_t *out) {
+    if (out)
+        *out = sso_stats_tls.total;
+}
+
+SSO_API void sso_stats_thread_reset(void) {
+    memset(&sso_stats_tls.total, 0, sizeof(sso_stats_t));
+    memset(&sso_stats_tls.last, 0, sizeof(sso_stats_t));
+}
+
+SSO_API void sso_stats_last_call(sso_stats_t *out) {
+    if (out)
+        *out = sso_stats_tls.last;
+}
+
+SSO_API void sso_stats_set_hooks(sso_trace_begin_fn begin, sso_trace_end_fn end, void *user) {
+    sso_trace_begin = begin;
+    sso_trace_end = end;
+    sso_trace_user = user;
+}
+
+#else /* !SSO_STATS */
+
+SSO_API int sso_stats_compiled_in(void) {
+    return 0;
+}
+
+SSO_API void sso_stats_set_flags(uint32_t flags) {
+    (void) flags;
+}
+
+SSO_API void sso_stats_thread_get(sso_stats_t *out) {
+    if (out)
+        memset(out, 0, sizeof(*out));
+}
+
+SSO_API void sso_stats_thread_reset(void) {
+}
+
+SSO_API void sso_stats_last_call(sso_stats_t *out) {
+    if (out)
+        memset(out, 0, sizeof(*out));
+}
+
+SSO_API void sso_stats_set_hooks(sso_trace_begin_fn begin, sso_trace_end_fn end, void *user) {
+    (void) begin;
+    (void) end;
+    (void) user;
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SSO_STATS_INTERNAL_H
+#define SSO_STATS_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stats.h"
+#include "io.h"
+
+/*
+ * Probes for the load paths. Without SSO_STATS they expand to nothing (or to
+ * the plain call they wrap), so an ordinary build carries no trace of them.
+ */
+
+typedef enum {
+    SSO_STATS_PHASE_IO = 0,
+    SSO_STATS_PHASE_DECODE,
+    SSO_STATS_PHASE_ALLOC,
+    SSO_STATS_PHASE_INDEX
+} sso_stats_phase_t;
+
+#ifdef SSO_STATS
+
+/* State of one instrumented operation, kept on the caller's stack. */
+typedef struct {
+    const char *name;
+    sso_stats_t start;
+} sso_stats_op_t;
+
+void     sso_stats_op_begin(sso_stats_op_t *op, const char *name);
+void     sso_stats_op_end(sso_stats_op_t *op);
+
+/* 0 unless SSO_STATS_TIMING is set on this thread; sso_stats_time_end ignores a 0 start. */
+uint64_t sso_stats_time_begin(void);
+void     sso_stats_time_end(sso_stats_phase_t phase, uint64_t start);
+
+void     sso_stats_count_read(size_t bytes);
+void     sso_stats_count_alloc(size_t bytes);
+void     sso_stats_count_entries(uint32_t n);
+
+static inline int sso_stats_read_exact(sso_reader_t *r, void *buf, size_t n) {
+    const uint64_t t = sso_stats_time_begin();
+    const int rc = sso_reader_read(r, buf, n);
+    sso_stats_time_end(SSO_STATS_PHASE_IO, t);
+    if (rc == 0)
+        sso_stats_count_read(n);
+    return rc;
+}
+
+#define SSO_STATS_OP(var)                 sso_stats_op_t var
+#define SSO_STATS_OP_BEGIN(var, name)     sso_stats_op_begin(&(var), (name))
+#define SSO_STATS_OP_END(var)             sso_stats_op_end(&(var))
+#define SSO_STATS_TIME(var)               const uint64_t var = sso_stats_time_begin()
+#define SSO_STATS_TIME_END(var, phase)    sso_stats_time_end((phase), (var))
+#define SSO_STATS_ALLOC(bytes)            sso_stats_count_alloc(bytes)
+#define SSO_STATS_READ(bytes)             sso_stats_count_read(bytes)
+#define SSO_STATS_ENTRIES(n)              sso_stats_count_entries(n)
+#define SSO_STATS_READ_EXACT(r, buf, n)   sso_stats_read_exact((r), (buf), (n))
+
+#else
+
+#define SSO_STATS_OP(var)
+#define SSO_STATS_OP_BEGIN(var, name)     ((void) 0)
+#define SSO_STATS_OP_END(var)             ((void) 0)
+#define SSO_STATS_TIME(var)
+#define SSO_STATS_TIME_END(var, phase)    ((void) 0)
+#define SSO_STATS_ALLOC(bytes)            ((void) 0)
+#define SSO_STATS_READ(bytes)             ((void) 0)
+#define SSO_STATS_ENTRIES(n)              ((void) 0)
+#define SSO_STATS_READ_EXACT(r, buf, n)   sso_reader_read((r), (buf), (n))
+
+#endif
+
+#endif /* SSO_STATS_INTERNAL_H */
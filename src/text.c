@@ -1,50 +1,114 @@
 #define TEXT_BUILD_DLL
+#define SSO_BUILD_DLL
 #include "text.h"
+#include "codec.h"
+#include "write.h"
+#include "arena.h"
+#include "text_internal.h"
+#include "stats_internal.h"
+#include "alloc.h"
 
 #include <stdlib.h>
 #include <string.h>
 
 /* ================== INTERNAL HELPERS ================== */
 
-#pragma pack(push, 1)
-typedef struct {
-    uint8_t key_length;
-    uint8_t unknown[2];
-    uint8_t key_offset;
-} entry_fixed_1_t;
-
-typedef struct {
-    uint8_t unknown2[4];
-    uint8_t unknown3[4];
-    uint32_t raw_value_length;
-    uint8_t  unknown4;
-    uint8_t  unknown5;
-    uint8_t  unknown6;
-} entry_fixed_2_t;
-
-#pragma pack(pop)
-
 static inline char *dup_string(const char *s) {
     if (!s) return NULL;
     size_t len = strlen(s);
-    char *out = (char *)malloc(len + 1);
+    char *out = (char *)sso_malloc(len + 1);
     if (!out) return NULL;
     memcpy(out, s, len + 1);
     return out;
 }
 
-static void shift_bytes(uint8_t *buf, size_t len, int shift) {
-    for (size_t i = 0; i < len; i++)
-        buf[i] = (uint8_t)((buf[i] + shift) & 0xFF);
+/* Values are UTF-16 and contain zero bytes, so they are copied by length. */
+static inline char *dup_value(const char *v, uint32_t len) {
+    if (!v) return NULL;
+    char *out = (char *)sso_malloc(len ? len : 1);
+    if (!out) return NULL;
+    memcpy(out, v, len);
+    return out;
+}
+
+/* Frees the strings an entry owns; arena-backed strings are left to the arena. */
+static void text_entry_release(text_entry_t *e) {
+    if (!(e->flags & TEXT_ENTRY_KEY_BORROWED))
+        sso_free(e->key);
+    if (!(e->flags & TEXT_ENTRY_VALUE_BORROWED))
+        sso_free(e->value);
+    e->key = NULL;
+    e->value = NULL;
+    e->flags = 0;
+}
+
+static void *text_string_alloc(sso_arena_t *arena, size_t size) {
+    return arena ? sso_arena_alloc(arena, size, 2) : sso_malloc(size);
+}
+
+/* On-disk size of one entry, or 0 if the entry cannot be encoded. */
+static size_t text_entry_encoded_size(const text_entry_t *e) {
+    const size_t key_len = e->key ? strlen(e->key) : 0;
+    if (key_len > UINT8_MAX)
+        return 0;
+
+    size_t value_len = 2;
+    if (e->value) {
+        if (e->value_length < 2)
+            return 0;
+        value_len = e->value_length;
+    }
+
+    return sizeof(entry_fixed_1_t) + key_len + sizeof(entry_fixed_2_t) + value_len;
+}
+
+/* Serialises one entry at `out`, which must hold text_entry_encoded_size(e) bytes. */
+static uint8_t *text_entry_encode(uint8_t *out, const text_entry_t *e) {
+    const size_t key_len = e->key ? strlen(e->key) : 0;
+
+    entry_fixed_1_t prefix;
+    prefix.key_length = (uint8_t)key_len;
+    memcpy(prefix.unknown, e->unknown, sizeof(prefix.unknown));
+    prefix.key_offset = e->key_offset;
+    memcpy(out, &prefix, sizeof(prefix));
+    out += sizeof(prefix);
+
+    sso_shift_encode(out, e->key, key_len, e->key_offset);
+    out += key_len;
+
+    entry_fixed_2_t mid;
+    memcpy(mid.unknown2, e->unknown2, 4);
+    memcpy(mid.unknown3, e->unknown3, 4);
+    mid.raw_value_length = e->value ? e->value_length : 2;
+    mid.unknown4 = e->unknown4;
+    mid.unknown5 = e->unknown5;
+    mid.unknown6 = e->unknown6;
+    memcpy(out, &mid, sizeof(mid));
+    out += sizeof(mid);
+
+    if (!e->value) {
+        out[0] = 0;
+        out[1] = 0;
+        return out + 2;
+    }
+
+    /* The UTF-16 terminator is stored plain, everything before it is shifted. */
+    sso_shift_encode(out, e->value, e->value_length - 2, e->value_offset);
+    memcpy(out + e->value_length - 2, e->value + e->value_length - 2, 2);
+    return out + e->value_length;
 }
 
 /* ================== STRUCT I/O ================== */
 
+static int text_header_read_from(sso_reader_t *r, text_header_t *h) {
+    return SSO_STATS_READ_EXACT(r, h, sizeof(text_header_t));
+}
+
 int text_header_read(FILE *f, text_header_t *h) {
     if (!f || !h) return 1;
-    if (io_read_exact(f, h, sizeof(text_header_t)) != 0)
-        return 1;
-    return 0;
+    sso_reader_t r;
+    sso_reader_init_stdio(&r, f);
+    return text_header_read_from(&r, h);
 }
 
 int text_header_write(FILE *f, const text_header_t *h) {
@@ -57,46 +121,43 @@ int text_header_write(FILE *f, const text_header_t *h) {
     return 0;
 }
 
-int text_entry_read(FILE *f, text_entry_t *e) {
-    if (!f || !e) return 1;
+static int text_entry_read_fail(text_entry_t *e) {
+    text_entry_release(e);
+    return 1;
+}
+
+int text_entry_read_from(sso_reader_t *r, text_entry_t *e, sso_arena_t *arena) {
     memset(e, 0, sizeof(*e));
+    if (arena)
+        e->flags = TEXT_ENTRY_KEY_BORROWED | TEXT_ENTRY_VALUE_BORROWED;
 
     entry_fixed_1_t prefix;
-    if (io_read_exact(f, &prefix, sizeof(prefix)) != 0)
-        return 1;
+    if (SSO_STATS_READ_EXACT(r, &prefix, sizeof(prefix)) != 0)
+        return text_entry_read_fail(e);
 
     const uint32_t key_len = prefix.key_length;
     memcpy(e->unknown, prefix.unknown, sizeof(e->unknown));
     e->key_offset = prefix.key_offset;
 
     if (key_len > 0) {
-        uint8_t *encoded_key = (uint8_t *)malloc(key_len);
-        if (!encoded_key) return 1;
+        e->key = (char *)text_string_alloc(arena, key_len + 1);
+        if (!e->key) return text_entry_read_fail(e);
 
-        if (io_read_exact(f, encoded_key, key_len)) {
-            free(encoded_key);
-            return 1;
-        }
-
-        shift_bytes(encoded_key, key_len, (int)e->key_offset);
+        if (SSO_STATS_READ_EXACT(r, e->key, key_len))
+            return text_entry_read_fail(e);
 
-        e->key = (char *)malloc(key_len + 1);
-        if (!e->key) {
-            free(encoded_key);
-            return 1;
-        }
-        memcpy(e->key, encoded_key, key_len);
+        SSO_STATS_TIME(t);
+        sso_shift_decode(e->key, e->key, key_len, e->key_offset);
+        SSO_STATS_TIME_END(t, SSO_STATS_PHASE_DECODE);
         e->key[key_len] = '\0';
-
-        free(encoded_key);
     }
 
     entry_fixed_2_t mid;
-    if (io_read_exact(f, &mid, sizeof(mid)))
-        return 1;
+    if (SSO_STATS_READ_EXACT(r, &mid, sizeof(mid)))
+        return text_entry_read_fail(e);
 
     if (mid.raw_value_length < 2)
-        return 1;
+        return text_entry_read_fail(e);
 
     memcpy(e->unknown2, mid.unknown2, 4);
     memcpy(e->unknown3, mid.unknown3, 4);
@@ -105,93 +166,297 @@ int text_entry_read(FILE *f, text_entry_t *e) {
     e->unknown5 = mid.unknown5;
     e->unknown6 = mid.unknown6;
 
-    uint8_t *value_raw = (uint8_t *)malloc(e->value_length);
-    if (!value_raw) return 1;
+    e->value = (char *)text_string_alloc(arena, e->value_length);
+    if (!e->value)
+        return text_entry_read_fail(e);
+
+    if (SSO_STATS_READ_EXACT(r, e->value, e->value_length))
+        return text_entry_read_fail(e);
+
+    e->value_offset = (uint8_t)((256 - (uint8_t)e->value[1]) & 0xFF);
+    SSO_STATS_TIME(t);
+    sso_shift_decode(e->value, e->value, e->value_length - 2, e->value_offset);
+    SSO_STATS_TIME_END(t, SSO_STATS_PHASE_DECODE);
+    SSO_STATS_ENTRIES(1);
+    return 0;
+}
+
+int text_entry_read(FILE *f, text_entry_t *e) {
+    if (!f || !e) return 1;
+    sso_reader_t r;
+    sso_reader_init_stdio(&r, f);
+    return text_entry_read_from(&r, e, NULL);
+}
 
-    if (io_read_exact(f, value_raw, e->value_length)) {
-        free(value_raw);
-        return 1;
-    }
 
-    e->value_offset = (uint8_t)((256 - value_raw[1]) & 0xFF);
-    shift_bytes(value_raw, e->value_length - 2, e->value_offset);
+int text_entry_write(FILE *f, const text_entry_t *e) {
+    if (!f || !e) return 1;
+
+    const size_t size = text_entry_encoded_size(e);
+    if (size == 0) return 1;
+
+    uint8_t stack_buf[512];
+    uint8_t *buf = size <= sizeof(stack_buf) ? stack_buf : (uint8_t *)sso_malloc(size);
+    if (!buf) return 1;
+
+    text_entry_encode(buf, e);
+    const int rc = io_write_exact(f, buf, size);
+
+    if (buf != stack_buf)
+        sso_free(buf);
+    return rc;
+}
+
+/* ================== MEMORY IMAGE PARSING ================== */
+
+int text_scan_entries(const uint8_t *data, size_t size, uint32_t n, text_slot_t *slots) {
+    if (!data || size > UINT32_MAX || (n && !slots)) return 1;
 
-    e->value = malloc(e->value_length);
+    size_t pos = sizeof(text_header_t);
+    if (size < pos) return 1;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        text_slot_t *s = &slots[i];
+
+        if (size - pos < sizeof(entry_fixed_1_t))
+            return 1;
+        const entry_fixed_1_t *prefix = (const entry_fixed_1_t *)(data + pos);
+        s->key_length = prefix->key_length;
+        s->key_offset = prefix->key_offset;
+        s->flags = 0;
+        pos += sizeof(entry_fixed_1_t);
+
+        if (size - pos < (size_t)s->key_length + sizeof(entry_fixed_2_t))
+            return 1;
+        s->key_pos = (uint32_t)pos;
+        pos += s->key_length;
+
+        uint32_t value_length;
+        memcpy(&value_length, data + pos + offsetof(entry_fixed_2_t, raw_value_length), 4);
+        pos += sizeof(entry_fixed_2_t);
+
+        if (value_length < 2 || size - pos < value_length)
+            return 1;
+        s->value_pos = (uint32_t)pos;
+        s->value_length = value_length;
+        pos += value_length;
+    }
 
-    memcpy(e->value, value_raw, e->value_length);
-    free(value_raw);
     return 0;
 }
 
+int text_entry_decode_slot(text_entry_t *e, const uint8_t *data, const text_slot_t *s) {
+    if (!e || !data || !s) return 1;
+    memset(e, 0, sizeof(*e));
 
-int text_entry_write(FILE *f, const text_entry_t *e) {
-    (void)f;
-    (void)e;
-    return 1;
+    const entry_fixed_1_t *prefix =
+        (const entry_fixed_1_t *)(data + s->key_pos - sizeof(entry_fixed_1_t));
+    const entry_fixed_2_t *mid =
+        (const entry_fixed_2_t *)(data + s->value_pos - sizeof(entry_fixed_2_t));
+    const uint8_t *value = data + s->value_pos;
+
+    if (s->key_length > 0) {
+        e->key = (char *)sso_malloc((size_t)s->key_length + 1);
+        if (!e->key) return 1;
+        sso_shift_decode(e->key, data + s->key_pos, s->key_length, prefix->key_offset);
+        e->key[s->key_length] = '\0';
+    }
+
+    e->value = (char *)sso_malloc(s->value_length);
+    if (!e->value)
+        return text_entry_read_fail(e);
+
+    e->value_offset = (uint8_t)((256 - value[1]) & 0xFF);
+    sso_shift_decode(e->value, value, s->value_length - 2, e->value_offset);
+    memcpy(e->value + s->value_length - 2, value + s->value_length - 2, 2);
+
+    memcpy(e->unknown, prefix->unknown, sizeof(e->unknown));
+    e->key_offset = prefix->key_offset;
+    memcpy(e->unknown2, mid->unknown2, 4);
+    memcpy(e->unknown3, mid->unknown3, 4);
+    e->value_length = s->value_length;
+    e->unknown4 = mid->unknown4;
+    e->unknown5 = mid->unknown5;
+    e->unknown6 = mid->unknown6;
+    return 0;
 }
 
 /* ================== CORE PUBLIC API ================== */
 
-TEXT_API text_file_t *text_file_read(const char *filename) {
-    if (!filename) return NULL;
+/* Parses a whole file from `r`, positioned at the header. */
+static text_file_t *text_file_load_from(sso_reader_t *r, int use_arena) {
+    text_file_t *tf = (text_file_t *)sso_calloc(1, sizeof(text_file_t));
+    if (!tf) return NULL;
 
-    FILE *f = fopen(filename, "rb");
-    if (!f) return NULL;
-
-    text_file_t *tf = (text_file_t *)calloc(1, sizeof(text_file_t));
-    if (!tf) {
-        fclose(f);
+    if (text_header_read_from(r, &tf->header)) {
+        sso_free(tf);
         return NULL;
     }
 
-    if (text_header_read(f, &tf->header)) {
-        fclose(f);
-        free(tf);
+    /* Every entry takes at least TEXT_ENTRY_MIN_SIZE bytes, which caps a corrupt count before it is allocated. */
+    uint64_t remaining = 0;
+    const int sized = sso_reader_remaining(r, &remaining) == 0;
+    if (sized && tf->header.entry_count > remaining / TEXT_ENTRY_MIN_SIZE) {
+        sso_free(tf);
         return NULL;
     }
 
+    if (use_arena) {
+        /* Decoded strings never outgrow their encoded form, so the remaining input bounds the arena. */
+        const size_t block = sized && remaining <= SIZE_MAX ? (size_t)remaining : 0;
+        tf->arena = sso_arena_create(block);
+        if (!tf->arena) {
+            sso_free(tf);
+            return NULL;
+        }
+    }
+
     if (tf->header.entry_count > 0) {
-        tf->entries = (text_entry_t *)calloc(tf->header.entry_count, sizeof(text_entry_t));
+        tf->entries = (text_entry_t *)sso_calloc(tf->header.entry_count, sizeof(text_entry_t));
         if (!tf->entries) {
-            fclose(f);
-            free(tf);
+            sso_arena_destroy(tf->arena);
+            sso_free(tf);
             return NULL;
         }
 
         for (uint32_t i = 0; i < tf->header.entry_count; ++i) {
-            if (text_entry_read(f, &tf->entries[i])) {
-                for (uint32_t j = 0; j < i; ++j) {
-                    free(tf->entries[j].key);
-                    free(tf->entries[j].value);
-                }
-                free(tf->entries);
-                free(tf);
-                fclose(f);
+            if (text_entry_read_from(r, &tf->entries[i], tf->arena)) {
+                tf->header.entry_count = i;
+                text_file_free(tf);
                 return NULL;
             }
         }
     }
 
+    return tf;
+}
+
+static text_file_t *text_file_load(const char *filename, int use_arena) {
+    if (!filename) return NULL;
+
+    FILE *f = fopen(filename, "rb");
+    if (!f) return NULL;
+
+    sso_reader_t r;
+    sso_reader_init_stdio(&r, f);
+    text_file_t *tf = text_file_load_from(&r, use_arena);
+
     fclose(f);
     return tf;
 }
 
+/* Encodes the whole file into one buffer from the library allocator. */
+static uint8_t *text_file_encode(const text_file_t *tf, size_t *size) {
+    if (tf->header.entry_count > 0 && !tf->entries) return NULL;
+
+    /* Size everything up front so the whole file is encoded into one buffer and written once. */
+    size_t total = sizeof(text_header_t);
+    for (uint32_t i = 0; i < tf->header.entry_count; ++i) {
+        const size_t entry_size = text_entry_encoded_size(&tf->entries[i]);
+        if (entry_size == 0) return NULL;
+        total += entry_size;
+    }
+
+    uint8_t *buf = (uint8_t *)sso_malloc(total);
+    if (!buf) return NULL;
+
+    memcpy(buf, &tf->header, sizeof(text_header_t));
+    uint8_t *out = buf + sizeof(text_header_t);
+    for (uint32_t i = 0; i < tf->header.entry_count; ++i)
+        out = text_entry_encode(out, &tf->entries[i]);
+
+    *size = total;
+    return buf;
+}
+
+TEXT_API text_file_t *text_file_create(void) {
+    return (text_file_t *)sso_calloc(1, sizeof(text_file_t));
+}
+
+TEXT_API text_file_t *text_file_read(const char *filename) {
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_read");
+    text_file_t *tf = text_file_load(filename, 0);
+    SSO_STATS_OP_END(op);
+    return tf;
+}
+
+TEXT_API text_file_t *text_file_read_arena(const char *filename) {
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_read_arena");
+    text_file_t *tf = text_file_load(filename, 1);
+    SSO_STATS_OP_END(op);
+    return tf;
+}
+
+TEXT_API text_file_t *text_file_read_mem(const void *data, size_t size) {
+    if (!data && size) return NULL;
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_read_mem");
+    sso_reader_t r;
+    sso_reader_init_mem(&r, data, size);
+    text_file_t *tf = text_file_load_from(&r, 1);
+    SSO_STATS_OP_END(op);
+    return tf;
+}
+
+TEXT_API text_file_t *text_file_read_from(sso_reader_t *r) {
+    if (!r || !r->ops) return NULL;
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_read_from");
+    text_file_t *tf = text_file_load_from(r, 1);
+    SSO_STATS_OP_END(op);
+    return tf;
+}
+
 TEXT_API int text_file_write(const char *filename, const text_file_t *tf) {
-    (void)filename;
-    (void)tf;
-    return 1;
+    if (!filename || !tf) return 1;
+
+    size_t total;
+    uint8_t *buf = text_file_encode(tf, &total);
+    if (!buf) return 1;
+
+    const int rc = sso_write_atomic(filename, buf, total, SSO_WRITE_SYNC);
+    sso_free(buf);
+    return rc;
+}
+
+TEXT_API int text_file_write_to(sso_writer_t *w, const text_file_t *tf) {
+    if (!w || !w->ops || !tf) return 1;
+
+    size_t total;
+    uint8_t *buf = text_file_encode(tf, &total);
+    if (!buf) return 1;
+
+    const int rc = sso_writer_write(w, buf, total);
+    sso_free(buf);
+    return rc;
 }
 
 TEXT_API void text_file_free(text_file_t *tf) {
     if (!tf) return;
     if (tf->entries) {
-        for (uint32_t i = 0; i < tf->header.entry_count; ++i) {
-            free(tf->entries[i].key);
-            free(tf->entries[i].value);
-        }
-        free(tf->entries);
+        /* In arena mode this only frees strings that were replaced through the setters. */
+        for (uint32_t i = 0; i < tf->header.entry_count; ++i)
+            text_entry_release(&tf->entries[i]);
+        sso_free(tf->entries);
     }
-    free(tf);
+    text_index_free(tf->index);
+    sso_arena_destroy(tf->arena);
+    sso_free(tf);
+}
+
+TEXT_API text_file_t *text_file_read_with(const char *filename, const sso_allocator_t *a) {
+    const sso_allocator_t *prev = sso_set_thread_allocator(a);
+    text_file_t *tf = text_file_read(filename);
+    sso_set_thread_allocator(prev);
+    return tf;
+}
+
+TEXT_API void text_file_free_with(text_file_t *tf, const sso_allocator_t *a) {
+    const sso_allocator_t *prev = sso_set_thread_allocator(a);
+    text_file_free(tf);
+    sso_set_thread_allocator(prev);
 }
 
 /* ================== FILE ENTRY MANAGEMENT ================== */
@@ -214,20 +479,31 @@ TEXT_API int text_file_resize(text_file_t *tf, uint32_t new_count) {
 
     if (new_count == 0) {
         if (tf->entries) {
-            for (uint32_t i = 0; i < tf->header.entry_count; ++i) {
-                free(tf->entries[i].key);
-                free(tf->entries[i].value);
-            }
-            free(tf->entries);
+            for (uint32_t i = 0; i < tf->header.entry_count; ++i)
+                text_entry_release(&tf->entries[i]);
+            sso_free(tf->entries);
             tf->entries = NULL;
         }
         tf->header.entry_count = 0;
+        text_index_on_truncate(tf, 0);
         return 0;
     }
 
+    if (new_count < tf->header.entry_count)
+        text_index_on_truncate(tf, new_count);
+
+    for (uint32_t i = new_count; i < tf->header.entry_count; ++i)
+        text_entry_release(&tf->entries[i]);
+
     text_entry_t *new_entries =
-        (text_entry_t *)realloc(tf->entries, new_count * sizeof(text_entry_t));
-    if (!new_entries) return 1;
+        (text_entry_t *)sso_realloc(tf->entries, new_count * sizeof(text_entry_t));
+    if (!new_entries) {
+        if (new_count > tf->header.entry_count)
+            return 1;
+        /* Shrinking in place is fine, the old block stays valid. */
+        tf->header.entry_count = new_count;
+        return 0;
+    }
 
     if (new_count > tf->header.entry_count) {
         memset(&new_entries[tf->header.entry_count], 0,
@@ -243,22 +519,22 @@ TEXT_API int text_file_remove_entry(text_file_t *tf, uint32_t index) {
     if (!tf || !tf->entries) return 1;
     if (index >= tf->header.entry_count) return 1;
 
-    free(tf->entries[index].key);
-    free(tf->entries[index].value);
+    text_entry_release(&tf->entries[index]);
 
     for (uint32_t i = index; i < tf->header.entry_count - 1; ++i)
         tf->entries[i] = tf->entries[i + 1];
 
     tf->header.entry_count--;
+    text_index_on_remove(tf, index);
 
     if (tf->header.entry_count == 0) {
-        free(tf->entries);
+        sso_free(tf->entries);
         tf->entries = NULL;
         return 0;
     }
 
     text_entry_t *new_entries =
-        (text_entry_t *)realloc(tf->entries, tf->header.entry_count * sizeof(text_entry_t));
+        (text_entry_t *)sso_realloc(tf->entries, tf->header.entry_count * sizeof(text_entry_t));
     if (new_entries)
         tf->entries = new_entries;
 
@@ -271,7 +547,7 @@ TEXT_API int text_file_add_entry(text_file_t *tf, const text_entry_t *src) {
     uint32_t new_count = tf->header.entry_count + 1;
 
     text_entry_t *new_entries =
-        (text_entry_t *)realloc(tf->entries, new_count * sizeof(text_entry_t));
+        (text_entry_t *)sso_realloc(tf->entries, new_count * sizeof(text_entry_t));
     if (!new_entries) return 1;
 
     tf->entries = new_entries;
@@ -284,7 +560,7 @@ TEXT_API int text_file_add_entry(text_file_t *tf, const text_entry_t *src) {
     }
 
     if (src->value) {
-        dst->value = dup_string(src->value);
+        dst->value = dup_value(src->value, src->value_length);
         dst->value_length = src->value_length;
     }
 
@@ -300,6 +576,7 @@ TEXT_API int text_file_add_entry(text_file_t *tf, const text_entry_t *src) {
     dst->value_offset = src->value_offset;
 
     tf->header.entry_count = new_count;
+    text_index_on_insert(tf, new_count - 1);
     return 0;
 }
 
@@ -312,14 +589,16 @@ TEXT_API const char *text_entry_get_key(const text_entry_t *e) {
 TEXT_API void text_entry_set_key(text_entry_t *e, const char *key) {
     if (!e) return;
 
-    free(e->key);
+    if (!(e->flags & TEXT_ENTRY_KEY_BORROWED))
+        sso_free(e->key);
+    e->flags &= (uint8_t)~TEXT_ENTRY_KEY_BORROWED;
     if (!key) {
         e->key = NULL;
         return;
     }
 
     size_t len = strlen(key);
-    e->key = (char *)malloc(len + 1);
+    e->key = (char *)sso_malloc(len + 1);
     if (!e->key) return;
 
     memcpy(e->key, key, len + 1);
@@ -332,7 +611,9 @@ TEXT_API const char *text_entry_get_value(const text_entry_t *e) {
 TEXT_API void text_entry_set_value(text_entry_t *e, const char *value) {
     if (!e) return;
 
-    free(e->value);
+    if (!(e->flags & TEXT_ENTRY_VALUE_BORROWED))
+        sso_free(e->value);
+    e->flags &= (uint8_t)~TEXT_ENTRY_VALUE_BORROWED;
     if (!value) {
         e->value = NULL;
         e->value_length = 0;
@@ -340,7 +621,7 @@ TEXT_API void text_entry_set_value(text_entry_t *e, const char *value) {
     }
 
     size_t len = strlen(value);
-    e->value = (char *)malloc(len + 1);
+    e->value = (char *)sso_malloc(len + 1);
     if (!e->value) return;
 
     memcpy(e->value, value, len + 1);
@@ -350,15 +631,14 @@ TEXT_API void text_entry_set_value(text_entry_t *e, const char *value) {
 /* ================== ENTRY LIFECYCLE ================== */
 
 TEXT_API text_entry_t *text_entry_create(void) {
-    text_entry_t *e = (text_entry_t *)calloc(1, sizeof(text_entry_t));
+    text_entry_t *e = (text_entry_t *)sso_calloc(1, sizeof(text_entry_t));
     return e;
 }
 
 TEXT_API void text_entry_free(text_entry_t *e) {
     if (!e) return;
-    free(e->key);
-    free(e->value);
-    free(e);
+    text_entry_release(e);
+    sso_free(e);
 }
 
 /* ================== FIELD GETTERS / SETTERS ================== */
@@ -449,7 +729,7 @@ TEXT_API void text_entry_set_unknown6(text_entry_t *e, uint8_t v) {
 TEXT_API text_entry_t *text_entry_clone(const text_entry_t *src) {
     if (!src) return NULL;
 
-    text_entry_t *e = (text_entry_t *)calloc(1, sizeof(text_entry_t));
+    text_entry_t *e = (text_entry_t *)sso_calloc(1, sizeof(text_entry_t));
     if (!e) return NULL;
 
     if (src->key) {
@@ -457,7 +737,7 @@ TEXT_API text_entry_t *text_entry_clone(const text_entry_t *src) {
     }
 
     if (src->value) {
-        e->value = dup_string(src->value);
+        e->value = dup_value(src->value, src->value_length);
         e->value_length = src->value_length;
     }
 
@@ -0,0 +1,203 @@
+#define TEXT_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "text.h"
+#include "text_internal.h"
+#include "cache.h"
+#include "map.h"
+#include "alloc.h"
+#include "stats_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+/* One offset table record in the sidecar; mirrors text_slot_t without the decode flags. */
+typedef struct {
+    uint32_t key_pos;
+    uint32_t value_pos;
+    uint32_t value_length;
+    uint8_t  key_length;
+    uint8_t  key_offset;
+    uint8_t  reserved[2];
+} text_cache_record_t;
+
+/*
+ * Records must describe exactly the back-to-back layout a scan would produce,
+ * so a cache that slipped past the identity checks still cannot point outside
+ * the image.
+ */
+static int text_cache_read_records(const text_cache_record_t *records, size_t size, uint32_t n,
+                                   text_slot_t *slots) {
+    uint64_t pos = sizeof(text_header_t);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const text_cache_record_t *r = &records[i];
+        text_slot_t *s = &slots[i];
+
+        pos += sizeof(entry_fixed_1_t);
+        if (r->key_pos != pos)
+            return 1;
+        pos += (uint64_t) r->key_length + sizeof(entry_fixed_2_t);
+        if (r->value_pos != pos || r->value_length < 2)
+            return 1;
+        pos += r->value_length;
+        if (pos > size)
+            return 1;
+
+        s->key_pos = r->key_pos;
+        s->value_pos = r->value_pos;
+        s->value_length = r->value_length;
+        s->key_length = r->key_length;
+        s->key_offset = r->key_offset;
+        s->value_offset = 0;
+        s->flags = 0;
+    }
+    return 0;
+}
+
+static int text_cache_store(const char *filename, const sso_cache_key_t *key, uint32_t n,
+                            const text_slot_t *slots, const text_file_t *tf) {
+    text_cache_record_t *records = (text_cache_record_t *) sso_calloc(n, sizeof(text_cache_record_t));
+    if (!records)
+        return 1;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        records[i].key_pos = slots[i].key_pos;
+        records[i].value_pos = slots[i].value_pos;
+        records[i].value_length = slots[i].value_length;
+        records[i].key_length = slots[i].key_length;
+        records[i].key_offset = slots[i].key_offset;
+    }
+
+    const void *table = NULL;
+    uint32_t cap = 0;
+    if (tf && text_index_export(tf, &table, &cap))
+        cap = 0;
+
+    const int rc = sso_cache_store(filename, key, SSO_CACHE_KIND_TEXT, n, sizeof(text_cache_record_t),
+                                   records, TEXT_INDEX_SLOT_SIZE, cap, table);
+    sso_free(records);
+    return rc;
+}
+
+/* Loads the slots from a matching cache, leaving it open so the caller can adopt its table. */
+static int text_cache_open_slots(const char *filename, const sso_cache_key_t *key, size_t size,
+                                 uint32_t n, text_slot_t *slots, sso_cache_t *cache) {
+    if (sso_cache_open(filename, key, SSO_CACHE_KIND_TEXT, n, sizeof(text_cache_record_t),
+                       TEXT_INDEX_SLOT_SIZE, cache))
+        return 1;
+    if (text_cache_read_records((const text_cache_record_t *) cache->records, size, n, slots)) {
+        sso_cache_close(cache);
+        return 1;
+    }
+    return 0;
+}
+
+int text_cache_slots(const char *filename, const uint8_t *data, size_t size, uint32_t n, text_slot_t *slots) {
+    sso_cache_key_t key;
+    if (sso_cache_key_compute(filename, data, size, &key))
+        return text_scan_entries(data, size, n, slots);
+
+    sso_cache_t cache;
+    if (text_cache_open_slots(filename, &key, size, n, slots, &cache) == 0) {
+        sso_cache_close(&cache);
+        return 0;
+    }
+
+    if (text_scan_entries(data, size, n, slots))
+        return 1;
+    text_cache_store(filename, &key, n, slots, NULL);
+    return 0;
+}
+
+static text_file_t *text_cache_load(const char *filename) {
+    sso_map_t map;
+    if (sso_map_open(filename, 0, &map))
+        return NULL;
+
+    if (map.size < sizeof(text_header_t) || map.size > UINT32_MAX) {
+        sso_map_close(&map);
+        return NULL;
+    }
+
+    text_file_t *tf = (text_file_t *) sso_calloc(1, sizeof(text_file_t));
+    if (!tf) {
+        sso_map_close(&map);
+        return NULL;
+    }
+    memcpy(&tf->header, map.data, sizeof(text_header_t));
+    SSO_STATS_READ(map.size);
+
+    const uint32_t n = tf->header.entry_count;
+    if (n == 0) {
+        sso_map_close(&map);
+        return tf;
+    }
+
+    text_slot_t *slots = NULL;
+    if (n <= (map.size - sizeof(text_header_t)) / TEXT_ENTRY_MIN_SIZE)
+        slots = (text_slot_t *) sso_malloc((size_t) n * sizeof(text_slot_t));
+    tf->entries = (text_entry_t *) sso_calloc(n, sizeof(text_entry_t));
+    if (!slots || !tf->entries) {
+        sso_free(slots);
+        sso_map_close(&map);
+        text_file_free(tf);
+        return NULL;
+    }
+
+    sso_cache_key_t key;
+    sso_cache_t cache;
+    const int keyed = sso_cache_key_compute(filename, map.data, map.size, &key) == 0;
+    int hit = keyed && text_cache_open_slots(filename, &key, map.size, n, slots, &cache) == 0;
+
+    if (!hit && text_scan_entries(map.data, map.size, n, slots)) {
+        sso_free(slots);
+        sso_map_close(&map);
+        text_file_free(tf);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        if (text_entry_decode_slot(&tf->entries[i], map.data, &slots[i])) {
+            if (hit)
+                sso_cache_close(&cache);
+            sso_free(slots);
+            sso_map_close(&map);
+            text_file_free(tf);
+            return NULL;
+        }
+    }
+
+    SSO_STATS_ENTRIES(n);
+
+    /* A cached table replaces hashing every key; a cache without one gets it added. */
+    int stale = !hit;
+    if (hit) {
+        if (!cache.table || text_index_adopt(tf, cache.table, cache.table_slots))
+            stale = 1;
+        sso_cache_close(&cache);
+    }
+    if (stale) {
+        if (!tf->index)
+            text_file_build_index(tf);
+        if (keyed)
+            text_cache_store(filename, &key, n, slots, tf);
+    }
+
+    sso_free(slots);
+    sso_map_close(&map);
+    return tf;
+}
+
+/* ================== CACHED READER ================== */
+
+TEXT_API text_file_t *text_file_read_cached(const char *filename) {
+    if (!filename)
+        return NULL;
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_read_cached");
+    text_file_t *tf = text_cache_load(filename);
+    SSO_STATS_OP_END(op);
+    return tf;
+}
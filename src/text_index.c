@@ -0,0 +1,269 @@
+#define TEXT_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "text.h"
+#include "text_internal.h"
+#include "hash.h"
+#include "stats_internal.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define TEXT_INDEX_EMPTY    UINT32_MAX
+#define TEXT_INDEX_MIN_CAP  16u
+
+/* Hash and entry index inline, so a probe touches one cache line and no key. */
+typedef struct {
+    uint32_t hash;
+    uint32_t index;
+} text_index_slot_t;
+
+struct text_index {
+    text_index_slot_t *slots;
+    uint32_t           mask;
+    uint32_t           count;
+};
+
+static uint32_t text_index_capacity_for(uint32_t n) {
+    /* Keep the load factor at or below 1/2 so probe chains stay short. */
+    uint64_t cap = TEXT_INDEX_MIN_CAP;
+    while (cap < (uint64_t) n * 2)
+        cap <<= 1;
+    return cap > 0x80000000u ? 0x80000000u : (uint32_t) cap;
+}
+
+static text_index_slot_t *text_index_alloc_slots(uint32_t cap) {
+    text_index_slot_t *slots = (text_index_slot_t *) sso_malloc((size_t) cap * sizeof(text_index_slot_t));
+    if (!slots)
+        return NULL;
+    /* Empty slots get a zero hash too: the table is written to the sidecar as-is. */
+    for (uint32_t i = 0; i < cap; ++i) {
+        slots[i].hash = 0;
+        slots[i].index = TEXT_INDEX_EMPTY;
+    }
+    return slots;
+}
+
+static void text_index_place(text_index_slot_t *slots, uint32_t mask, uint32_t hash, uint32_t index) {
+    uint32_t pos = hash & mask;
+    while (slots[pos].index != TEXT_INDEX_EMPTY)
+        pos = (pos + 1) & mask;
+    slots[pos].hash = hash;
+    slots[pos].index = index;
+}
+
+/*
+ * Re-lays the table into `cap` slots from the stored hashes, dropping entry
+ * `removed` and every index >= `limit` and closing the gap left by `removed`.
+ * No key is rehashed.
+ */
+static int text_index_relayout(struct text_index *ix, uint32_t cap, uint32_t removed, uint32_t limit) {
+    text_index_slot_t *slots = text_index_alloc_slots(cap);
+    if (!slots)
+        return 1;
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i <= ix->mask; ++i) {
+        uint32_t index = ix->slots[i].index;
+        if (index == TEXT_INDEX_EMPTY || index == removed || index >= limit)
+            continue;
+        if (removed != TEXT_INDEX_EMPTY && index > removed)
+            index--;
+        text_index_place(slots, cap - 1, ix->slots[i].hash, index);
+        count++;
+    }
+
+    sso_free(ix->slots);
+    ix->slots = slots;
+    ix->mask = cap - 1;
+    ix->count = count;
+    return 0;
+}
+
+/* Stops at the entry key's terminator, so a shorter key is never read past. */
+static inline int text_key_equals(const char *entry_key, const char *key, size_t len) {
+    if (!entry_key)
+        return 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (entry_key[i] != key[i] || entry_key[i] == '\0')
+            return 0;
+    }
+    return entry_key[len] == '\0';
+}
+
+void text_index_free(struct text_index *ix) {
+    if (!ix)
+        return;
+    sso_free(ix->slots);
+    sso_free(ix);
+}
+
+/* An index that cannot follow an edit is dropped; lookups then fall back to scanning. */
+static void text_index_drop(text_file_t *tf) {
+    text_index_free(tf->index);
+    tf->index = NULL;
+}
+
+void text_index_on_insert(text_file_t *tf, uint32_t index) {
+    struct text_index *ix = tf->index;
+    if (!ix)
+        return;
+
+    const char *key = tf->entries[index].key;
+    if (!key)
+        return;
+
+    if ((uint64_t) (ix->count + 1) * 2 > (uint64_t) ix->mask + 1) {
+        if (text_index_relayout(ix, (ix->mask + 1) * 2, TEXT_INDEX_EMPTY, UINT32_MAX)) {
+            text_index_drop(tf);
+            return;
+        }
+    }
+
+    text_index_place(ix->slots, ix->mask, sso_hash32(key, strlen(key)), index);
+    ix->count++;
+}
+
+void text_index_on_remove(text_file_t *tf, uint32_t index) {
+    struct text_index *ix = tf->index;
+    if (!ix)
+        return;
+    if (text_index_relayout(ix, ix->mask + 1, index, UINT32_MAX))
+        text_index_drop(tf);
+}
+
+void text_index_on_truncate(text_file_t *tf, uint32_t count) {
+    struct text_index *ix = tf->index;
+    if (!ix)
+        return;
+    if (text_index_relayout(ix, ix->mask + 1, TEXT_INDEX_EMPTY, count))
+        text_index_drop(tf);
+}
+
+int text_index_export(const text_file_t *tf, const void **slots, uint32_t *cap) {
+    const struct text_index *ix = tf->index;
+    if (!ix)
+        return 1;
+    *slots = ix->slots;
+    *cap = ix->mask + 1;
+    return 0;
+}
+
+int text_index_adopt(text_file_t *tf, const void *slots, uint32_t cap) {
+    const uint32_t n = tf->header.entry_count;
+    if (cap < TEXT_INDEX_MIN_CAP || (cap & (cap - 1)) != 0 || cap < text_index_capacity_for(n))
+        return 1;
+
+    struct text_index *ix = (struct text_index *) sso_calloc(1, sizeof(struct text_index));
+    if (!ix)
+        return 1;
+    ix->slots = (text_index_slot_t *) sso_malloc((size_t) cap * sizeof(text_index_slot_t));
+    if (!ix->slots) {
+        sso_free(ix);
+        return 1;
+    }
+    memcpy(ix->slots, slots, (size_t) cap * sizeof(text_index_slot_t));
+    ix->mask = cap - 1;
+
+    /* Out-of-range indices or a table too full to terminate a probe mean a bad cache. */
+    for (uint32_t i = 0; i < cap; ++i) {
+        const uint32_t index = ix->slots[i].index;
+        if (index == TEXT_INDEX_EMPTY)
+            continue;
+        if (index >= n || ++ix->count > cap / 2) {
+            text_index_free(ix);
+            return 1;
+        }
+    }
+
+    text_index_free(tf->index);
+    tf->index = ix;
+    return 0;
+}
+
+/* ================== KEY INDEX ================== */
+
+/* Builds the table for text_file_build_index; the public wrapper only adds stats. */
+static int text_index_build(text_file_t *tf) {
+    const uint32_t n = tf->header.entry_count;
+    struct text_index *ix = (struct text_index *) sso_calloc(1, sizeof(struct text_index));
+    if (!ix)
+        return 1;
+
+    const uint32_t cap = text_index_capacity_for(n);
+    ix->slots = text_index_alloc_slots(cap);
+    if (!ix->slots) {
+        sso_free(ix);
+        return 1;
+    }
+    ix->mask = cap - 1;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const char *key = tf->entries[i].key;
+        if (!key)
+            continue;
+        text_index_place(ix->slots, ix->mask, sso_hash32(key, strlen(key)), i);
+        ix->count++;
+    }
+
+    text_index_free(tf->index);
+    tf->index = ix;
+    return 0;
+}
+
+TEXT_API int text_file_build_index(text_file_t *tf) {
+    if (!tf)
+        return 1;
+
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_build_index");
+    SSO_STATS_TIME(t);
+    const int rc = text_index_build(tf);
+    SSO_STATS_TIME_END(t, SSO_STATS_PHASE_INDEX);
+    SSO_STATS_OP_END(op);
+    return rc;
+}
+
+TEXT_API void text_file_drop_index(text_file_t *tf) {
+    if (!tf)
+        return;
+    text_index_drop(tf);
+}
+
+TEXT_API int text_file_find_index(const text_file_t *tf, const char *key, size_t len, uint32_t *out) {
+    if (!tf || !key || !out)
+        return 1;
+
+    const struct text_index *ix = tf->index;
+    if (!ix) {
+        for (uint32_t i = 0; i < tf->header.entry_count; ++i) {
+            if (text_key_equals(tf->entries[i].key, key, len)) {
+                *out = i;
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    const uint32_t hash = sso_hash32(key, len);
+    uint32_t pos = hash & ix->mask;
+    for (;;) {
+        const text_index_slot_t *s = &ix->slots[pos];
+        if (s->index == TEXT_INDEX_EMPTY)
+            return 1;
+        if (s->hash == hash && text_key_equals(tf->entries[s->index].key, key, len)) {
+            *out = s->index;
+            return 0;
+        }
+        pos = (pos + 1) & ix->mask;
+    }
+}
+
+TEXT_API text_entry_t *text_file_find(text_file_t *tf, const char *key, size_t len) {
+    uint32_t index;
+    if (text_file_find_index(tf, key, len, &index))
+        return NULL;
+    return &tf->entries[index];
+}
@@ -0,0 +1,79 @@
+#ifndef TEXT_INTERNAL_H
+#define TEXT_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "text.h"
+
+/* On-disk fixed blocks of a text entry, shared by the stdio and mapped readers. */
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t key_length;
+    uint8_t unknown[2];
+    uint8_t key_offset;
+} entry_fixed_1_t;
+
+typedef struct {
+    uint8_t unknown2[4];
+    uint8_t unknown3[4];
+    uint32_t raw_value_length;
+    uint8_t  unknown4;
+    uint8_t  unknown5;
+    uint8_t  unknown6;
+} entry_fixed_2_t;
+
+#pragma pack(pop)
+
+/* Smallest possible encoded entry: both fixed blocks, empty key, 00 00 value. */
+#define TEXT_ENTRY_MIN_SIZE (sizeof(entry_fixed_1_t) + sizeof(entry_fixed_2_t) + 2)
+
+#define TEXT_SLOT_KEY_DECODED   0x01
+#define TEXT_SLOT_VALUE_DECODED 0x02
+
+/* Offset table record: where an entry's key and value live inside an in-memory file image. */
+typedef struct {
+    uint32_t key_pos;
+    uint32_t value_pos;
+    uint32_t value_length;
+    uint8_t  key_length;
+    uint8_t  key_offset;
+    uint8_t  value_offset;
+    uint8_t  flags;
+} text_slot_t;
+
+/*
+ * Walks the length fields of `n` entries following the header of an image of
+ * `size` (<= UINT32_MAX) bytes and fills `slots`. Every length is validated,
+ * nothing is decoded.
+ */
+int text_scan_entries(const uint8_t *data, size_t size, uint32_t n, text_slot_t *slots);
+
+/*
+ * Reads and decodes one entry from `r`. With an arena the strings live in it
+ * and the entry is marked borrowed; without one they are heap-owned.
+ */
+int text_entry_read_from(sso_reader_t *r, text_entry_t *e, struct sso_arena *arena);
+
+/* Builds a heap-owned entry from the still-encoded bytes a slot points at. */
+int text_entry_decode_slot(text_entry_t *e, const uint8_t *data, const text_slot_t *s);
+
+/* Key index maintenance, called by the entry management functions in text.c. */
+void text_index_free(struct text_index *ix);
+void text_index_on_insert(text_file_t *tf, uint32_t index);
+void text_index_on_remove(text_file_t *tf, uint32_t index);
+void text_index_on_truncate(text_file_t *tf, uint32_t count);
+
+/* Index tables in their sidecar cache layout: `cap` {hash, index} uint32 pairs. */
+#define TEXT_INDEX_SLOT_SIZE 8u
+int  text_index_export(const text_file_t *tf, const void **slots, uint32_t *cap);
+int  text_index_adopt(text_file_t *tf, const void *slots, uint32_t cap);
+
+/*
+ * Fills `slots` for the `n` entries of a mapped image from its sidecar cache,
+ * or scans the image and refreshes the cache when it is missing or stale.
+ */
+int  text_cache_slots(const char *filename, const uint8_t *data, size_t size, uint32_t n, text_slot_t *slots);
+
+#endif /* TEXT_INTERNAL_H */
@@ -0,0 +1,178 @@
+#define TEXT_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "text.h"
+#include "codec.h"
+#include "text_internal.h"
+#include "map.h"
+#include "alloc.h"
+#include "stats_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+struct text_mapped {
+    sso_map_t     map;
+    text_header_t header;
+    text_slot_t  *slots;
+};
+
+static void text_mapped_discard(text_mapped_t *tm) {
+    sso_map_close(&tm->map);
+    sso_free(tm->slots);
+    sso_free(tm);
+}
+
+static int text_mapped_scan(text_mapped_t *tm, const char *cache_source) {
+    const uint32_t n = tm->header.entry_count;
+    if (n == 0)
+        return 0;
+    if (n > (tm->map.size - sizeof(text_header_t)) / TEXT_ENTRY_MIN_SIZE)
+        return 1;
+
+    tm->slots = (text_slot_t *) sso_calloc(n, sizeof(text_slot_t));
+    if (!tm->slots)
+        return 1;
+
+    if (cache_source)
+        return text_cache_slots(cache_source, tm->map.data, tm->map.size, n, tm->slots);
+    return text_scan_entries(tm->map.data, tm->map.size, n, tm->slots);
+}
+
+static text_mapped_t *text_mapped_open(const char *filename, int use_cache) {
+    if (!filename)
+        return NULL;
+
+    text_mapped_t *tm = (text_mapped_t *) sso_calloc(1, sizeof(text_mapped_t));
+    if (!tm)
+        return NULL;
+
+    if (sso_map_open(filename, 1, &tm->map)) {
+        sso_free(tm);
+        return NULL;
+    }
+
+    /* Slot positions are 32-bit; larger tables have to go through text_file_read. */
+    if (tm->map.size < sizeof(text_header_t) || tm->map.size > UINT32_MAX) {
+        text_mapped_discard(tm);
+        return NULL;
+    }
+
+    memcpy(&tm->header, tm->map.data, sizeof(text_header_t));
+    SSO_STATS_READ(tm->map.size);
+
+    if (text_mapped_scan(tm, use_cache ? filename : NULL)) {
+        text_mapped_discard(tm);
+        return NULL;
+    }
+
+    SSO_STATS_ENTRIES(tm->header.entry_count);
+    return tm;
+}
+
+/* ================== MAPPED READER ================== */
+
+TEXT_API text_mapped_t *text_file_open_mapped(const char *filename) {
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_open_mapped");
+    text_mapped_t *tm = text_mapped_open(filename, 0);
+    SSO_STATS_OP_END(op);
+    return tm;
+}
+
+TEXT_API text_mapped_t *text_file_open_mapped_cached(const char *filename) {
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_open_mapped_cached");
+    text_mapped_t *tm = text_mapped_open(filename, 1);
+    SSO_STATS_OP_END(op);
+    return tm;
+}
+
+TEXT_API void text_mapped_close(text_mapped_t *tm) {
+    if (!tm)
+        return;
+    text_mapped_discard(tm);
+}
+
+TEXT_API const text_header_t *text_mapped_header(const text_mapped_t *tm) {
+    return tm ? &tm->header : NULL;
+}
+
+TEXT_API uint32_t text_mapped_entry_count(const text_mapped_t *tm) {
+    return tm ? tm->header.entry_count : 0;
+}
+
+TEXT_API int text_mapped_get_key(text_mapped_t *tm, uint32_t index, text_view_t *out) {
+    if (!tm || !out || index >= tm->header.entry_count)
+        return 1;
+
+    text_slot_t *s = &tm->slots[index];
+    uint8_t *key = tm->map.data + s->key_pos;
+
+    if (!(s->flags & TEXT_SLOT_KEY_DECODED)) {
+        sso_shift_decode(key, key, s->key_length, s->key_offset);
+        s->flags |= TEXT_SLOT_KEY_DECODED;
+    }
+
+    out->data = (const char *) key;
+    out->length = s->key_length;
+    return 0;
+}
+
+TEXT_API int text_mapped_get_value(text_mapped_t *tm, uint32_t index, text_view_t *out) {
+    if (!tm || !out || index >= tm->header.entry_count)
+        return 1;
+
+    text_slot_t *s = &tm->slots[index];
+    uint8_t *value = tm->map.data + s->value_pos;
+
+    if (!(s->flags & TEXT_SLOT_VALUE_DECODED)) {
+        s->value_offset = (uint8_t) ((256 - value[1]) & 0xFF);
+        sso_shift_decode(value, value, s->value_length - 2, s->value_offset);
+        s->flags |= TEXT_SLOT_VALUE_DECODED;
+    }
+
+    out->data = (const char *) value;
+    out->length = s->value_length;
+    return 0;
+}
+
+TEXT_API text_entry_t *text_mapped_clone_entry(text_mapped_t *tm, uint32_t index) {
+    text_view_t key, value;
+    if (text_mapped_get_key(tm, index, &key) || text_mapped_get_value(tm, index, &value))
+        return NULL;
+
+    const text_slot_t *s = &tm->slots[index];
+    const entry_fixed_1_t *prefix =
+        (const entry_fixed_1_t *) (tm->map.data + s->key_pos - sizeof(entry_fixed_1_t));
+    const entry_fixed_2_t *mid =
+        (const entry_fixed_2_t *) (tm->map.data + s->value_pos - sizeof(entry_fixed_2_t));
+
+    text_entry_t *e = text_entry_create();
+    if (!e)
+        return NULL;
+
+    e->key = (char *) sso_malloc(key.length + 1u);
+    e->value = (char *) sso_malloc(value.length);
+    if (!e->key || !e->value) {
+        text_entry_free(e);
+        return NULL;
+    }
+    memcpy(e->key, key.data, key.length);
+    e->key[key.length] = '\0';
+    memcpy(e->value, value.data, value.length);
+
+    memcpy(e->unknown, prefix->unknown, sizeof(e->unknown));
+    memcpy(e->unknown2, mid->unknown2, sizeof(e->unknown2));
+    memcpy(e->unknown3, mid->unknown3, sizeof(e->unknown3));
+    e->unknown4 = mid->unknown4;
+    e->unknown5 = mid->unknown5;
+    e->unknown6 = mid->unknown6;
+
+    e->key_offset   = s->key_offset;
+    e->value_offset = s->value_offset;
+    e->value_length = s->value_length;
+
+    return e;
+}
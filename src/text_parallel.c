@@ -0,0 +1,113 @@
+#define TEXT_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "text.h"
+#include "text_internal.h"
+#include "map.h"
+#include "pool.h"
+#include "alloc.h"
+#include "stats_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+/* Entries handed to a worker per claim; large enough to amortise the shared counter. */
+#define TEXT_PARALLEL_GRAIN 256
+
+typedef struct {
+    const uint8_t     *data;
+    const text_slot_t *slots;
+    text_entry_t      *entries;
+    volatile int       failed;
+} text_parallel_job_t;
+
+static void text_parallel_decode(void *ctx, size_t begin, size_t end, unsigned worker) {
+    text_parallel_job_t *job = (text_parallel_job_t *) ctx;
+    (void) worker;
+
+    for (size_t i = begin; i < end && !job->failed; ++i) {
+        if (text_entry_decode_slot(&job->entries[i], job->data, &job->slots[i]))
+            job->failed = 1;
+    }
+}
+
+static text_file_t *text_parallel_load(const char *filename, unsigned nthreads) {
+    sso_map_t map;
+    if (sso_map_open(filename, 0, &map))
+        return NULL;
+
+    if (map.size < sizeof(text_header_t)) {
+        sso_map_close(&map);
+        return NULL;
+    }
+
+    /* Slot positions are 32-bit; larger files are decoded sequentially instead. */
+    if (map.size > UINT32_MAX) {
+        sso_map_close(&map);
+        return text_file_read(filename);
+    }
+
+    text_file_t *tf = (text_file_t *) sso_calloc(1, sizeof(text_file_t));
+    if (!tf) {
+        sso_map_close(&map);
+        return NULL;
+    }
+    memcpy(&tf->header, map.data, sizeof(text_header_t));
+
+    const uint32_t n = tf->header.entry_count;
+    SSO_STATS_READ(map.size);
+    if (n == 0) {
+        sso_map_close(&map);
+        return tf;
+    }
+
+    /* Phase 1: sequential length scan. A truncated file fails here, before any worker starts. */
+    text_slot_t *slots = NULL;
+    if (n <= (map.size - sizeof(text_header_t)) / TEXT_ENTRY_MIN_SIZE)
+        slots = (text_slot_t *) sso_malloc((size_t) n * sizeof(text_slot_t));
+    if (!slots || text_scan_entries(map.data, map.size, n, slots)) {
+        sso_free(slots);
+        sso_free(tf);
+        sso_map_close(&map);
+        return NULL;
+    }
+
+    tf->entries = (text_entry_t *) sso_calloc(n, sizeof(text_entry_t));
+    if (!tf->entries) {
+        sso_free(slots);
+        sso_free(tf);
+        sso_map_close(&map);
+        return NULL;
+    }
+
+    /* Phase 2: allocation, unshifting and copying are independent per entry. */
+    text_parallel_job_t job;
+    job.data = map.data;
+    job.slots = slots;
+    job.entries = tf->entries;
+    job.failed = 0;
+    sso_parallel_for(nthreads, n, TEXT_PARALLEL_GRAIN, text_parallel_decode, &job);
+
+    sso_free(slots);
+    sso_map_close(&map);
+
+    if (job.failed) {
+        text_file_free(tf);
+        return NULL;
+    }
+    SSO_STATS_ENTRIES(n);
+    return tf;
+}
+
+/* ================== PARALLEL READER ================== */
+
+TEXT_API text_file_t *text_file_read_parallel(const char *filename, unsigned nthreads) {
+    if (!filename)
+        return NULL;
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "text_file_read_parallel");
+    text_file_t *tf = text_parallel_load(filename, nthreads);
+    SSO_STATS_OP_END(op);
+    return tf;
+}
@@ -0,0 +1,95 @@
+#define TEXT_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "text.h"
+#include "text_internal.h"
+#include "arena.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define TEXT_READER_DEFAULT_BUFFER (1u << 16)
+
+struct text_reader {
+    FILE         *f;
+    char         *io_buf;
+    sso_reader_t  in;
+    text_header_t header;
+    uint32_t      next;
+    int           failed;
+
+    /* Holds the current entry's strings; reset per entry, so it settles at one block. */
+    sso_arena_t  *strings;
+    text_entry_t  entry;
+};
+
+static int text_reader_fail(text_reader_t *r) {
+    r->failed = 1;
+    return 1;
+}
+
+/* ================== STREAMING READER ================== */
+
+TEXT_API text_reader_t *text_reader_open(const char *filename, size_t buffer_size) {
+    if (!filename)
+        return NULL;
+
+    text_reader_t *r = (text_reader_t *) sso_calloc(1, sizeof(text_reader_t));
+    if (!r)
+        return NULL;
+
+    r->f = fopen(filename, "rb");
+    if (!r->f) {
+        sso_free(r);
+        return NULL;
+    }
+
+    if (buffer_size == 0)
+        buffer_size = TEXT_READER_DEFAULT_BUFFER;
+    r->io_buf = (char *) sso_malloc(buffer_size);
+    r->strings = sso_arena_create(0);
+    if (!r->io_buf || !r->strings || setvbuf(r->f, r->io_buf, _IOFBF, buffer_size) != 0 ||
+        text_header_read(r->f, &r->header)) {
+        text_reader_close(r);
+        return NULL;
+    }
+
+    sso_reader_init_stdio(&r->in, r->f);
+    return r;
+}
+
+TEXT_API void text_reader_close(text_reader_t *r) {
+    if (!r)
+        return;
+    if (r->f)
+        fclose(r->f);
+    sso_free(r->io_buf);
+    sso_arena_destroy(r->strings);
+    sso_free(r);
+}
+
+TEXT_API const text_header_t *text_reader_header(const text_reader_t *r) {
+    return r ? &r->header : NULL;
+}
+
+TEXT_API int text_reader_failed(const text_reader_t *r) {
+    return r ? r->failed : 1;
+}
+
+TEXT_API int text_reader_next(text_reader_t *r, const text_entry_t **out) {
+    if (!r || !out)
+        return 1;
+    *out = NULL;
+    if (r->failed || r->next >= r->header.entry_count)
+        return 1;
+
+    sso_arena_reset(r->strings);
+    if (text_entry_read_from(&r->in, &r->entry, r->strings))
+        return text_reader_fail(r);
+
+    r->next++;
+    *out = &r->entry;
+    return 0;
+}
@@ -0,0 +1,236 @@
+#define TEXT_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "text.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+/*
+ * One record per key in sorted order. `head` holds the first 8 key bytes
+ * big-endian, so most comparisons during a search never leave this array.
+ */
+typedef struct {
+    uint64_t head;
+    uint32_t index;
+    uint32_t length;
+} text_sorted_rec_t;
+
+struct text_sorted {
+    const text_file_t *tf;
+    text_sorted_rec_t *recs;
+    uint8_t           *lcp;   /* common prefix with the previous key, capped at 255 */
+    uint32_t           count;
+};
+
+static uint64_t key_head(const char *key, size_t len) {
+    uint64_t h = 0;
+    for (size_t i = 0; i < 8; ++i)
+        h = (h << 8) | (i < len ? (uint8_t) key[i] : 0);
+    return h;
+}
+
+static int key_compare(const char *a, size_t alen, const char *b, size_t blen) {
+    const int c = memcmp(a, b, alen < blen ? alen : blen);
+    if (c)
+        return c;
+    return alen < blen ? -1 : alen > blen;
+}
+
+static inline const char *rec_key(const text_sorted_t *ts, const text_sorted_rec_t *r) {
+    return ts->tf->entries[r->index].key;
+}
+
+/*
+ * With equal heads, a key of at most 8 bytes is wholly inside its head, so
+ * it is a prefix of the other key and the lengths decide. Only keys both
+ * longer than 8 bytes have a tail to compare.
+ */
+static int rec_compare(const text_sorted_t *ts, const text_sorted_rec_t *a, const text_sorted_rec_t *b) {
+    if (a->head != b->head)
+        return a->head < b->head ? -1 : 1;
+    if (a->length <= 8 || b->length <= 8)
+        return a->length < b->length ? -1 : a->length > b->length;
+    return key_compare(rec_key(ts, a) + 8, a->length - 8, rec_key(ts, b) + 8, b->length - 8);
+}
+
+/* Probe against a record: same head shortcut as rec_compare. */
+static int probe_compare(const text_sorted_t *ts, const text_sorted_rec_t *r,
+                         uint64_t head, const char *key, size_t len) {
+    if (r->head != head)
+        return r->head < head ? -1 : 1;
+    if (r->length <= 8 || len <= 8)
+        return r->length < len ? -1 : r->length > len;
+    return key_compare(rec_key(ts, r) + 8, r->length - 8, key + 8, len - 8);
+}
+
+/* Bottom-up merge sort; stable, so duplicate keys keep their file order. */
+static int sort_records(const text_sorted_t *ts, text_sorted_rec_t *recs, uint32_t n) {
+    text_sorted_rec_t *tmp = (text_sorted_rec_t *) sso_malloc((size_t) n * sizeof(text_sorted_rec_t));
+    if (!tmp)
+        return 1;
+
+    text_sorted_rec_t *src = recs, *dst = tmp;
+    for (uint32_t width = 1; width < n; width *= 2) {
+        for (uint32_t lo = 0; lo < n; lo += 2 * width) {
+            uint32_t mid = lo + width < n ? lo + width : n;
+            uint32_t hi = lo + 2 * width < n ? lo + 2 * width : n;
+            uint32_t i = lo, j = mid, k = lo;
+            while (i < mid && j < hi)
+                dst[k++] = rec_compare(ts, &src[j], &src[i]) < 0 ? src[j++] : src[i++];
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < hi)
+                dst[k++] = src[j++];
+        }
+        text_sorted_rec_t *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != recs)
+        memcpy(recs, src, (size_t) n * sizeof(text_sorted_rec_t));
+    sso_free(tmp);
+    return 0;
+}
+
+static uint32_t lower_bound(const text_sorted_t *ts, const char *key, size_t len) {
+    const uint64_t head = key_head(key, len);
+    uint32_t lo = 0, hi = ts->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (probe_compare(ts, &ts->recs[mid], head, key, len) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static uint32_t upper_bound(const text_sorted_t *ts, const char *key, size_t len) {
+    const uint64_t head = key_head(key, len);
+    uint32_t lo = 0, hi = ts->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (probe_compare(ts, &ts->recs[mid], head, key, len) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* ================== SORTED KEY INDEX ================== */
+
+TEXT_API text_sorted_t *text_sorted_build(const text_file_t *tf) {
+    if (!tf)
+        return NULL;
+
+    text_sorted_t *ts = (text_sorted_t *) sso_calloc(1, sizeof(text_sorted_t));
+    if (!ts)
+        return NULL;
+    ts->tf = tf;
+
+    const uint32_t n = tf->header.entry_count;
+    if (n == 0)
+        return ts;
+
+    ts->recs = (text_sorted_rec_t *) sso_malloc((size_t) n * sizeof(text_sorted_rec_t));
+    ts->lcp = (uint8_t *) sso_malloc(n);
+    if (!ts->recs || !ts->lcp) {
+        text_sorted_free(ts);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const char *key = tf->entries[i].key;
+        if (!key)
+            continue;
+        const size_t len = strlen(key);
+        text_sorted_rec_t *r = &ts->recs[ts->count++];
+        r->head = key_head(key, len);
+        r->index = i;
+        r->length = (uint32_t) len;
+    }
+
+    if (sort_records(ts, ts->recs, ts->count)) {
+        text_sorted_free(ts);
+        return NULL;
+    }
+
+    /* Front coding of neighbours: a prefix scan only has to look at these bytes. */
+    ts->lcp[0] = 0;
+    for (uint32_t r = 1; r < ts->count; ++r) {
+        const char *a = rec_key(ts, &ts->recs[r - 1]);
+        const char *b = rec_key(ts, &ts->recs[r]);
+        uint32_t max = ts->recs[r - 1].length < ts->recs[r].length
+                           ? ts->recs[r - 1].length : ts->recs[r].length;
+        if (max > UINT8_MAX)
+            max = UINT8_MAX;
+        uint32_t l = 0;
+        while (l < max && a[l] == b[l])
+            l++;
+        ts->lcp[r] = (uint8_t) l;
+    }
+
+    return ts;
+}
+
+TEXT_API void text_sorted_free(text_sorted_t *ts) {
+    if (!ts)
+        return;
+    sso_free(ts->recs);
+    sso_free(ts->lcp);
+    sso_free(ts);
+}
+
+TEXT_API uint32_t text_sorted_count(const text_sorted_t *ts) {
+    return ts ? ts->count : 0;
+}
+
+TEXT_API uint32_t text_sorted_entry(const text_sorted_t *ts, uint32_t rank) {
+    if (!ts || rank >= ts->count)
+        return UINT32_MAX;
+    return ts->recs[rank].index;
+}
+
+TEXT_API uint32_t text_sorted_lower_bound(const text_sorted_t *ts, const char *key, size_t len) {
+    if (!ts || !key)
+        return 0;
+    return lower_bound(ts, key, len);
+}
+
+TEXT_API uint32_t text_sorted_upper_bound(const text_sorted_t *ts, const char *key, size_t len) {
+    if (!ts || !key)
+        return 0;
+    return upper_bound(ts, key, len);
+}
+
+TEXT_API int text_sorted_prefix_range(const text_sorted_t *ts, const char *prefix, size_t len,
+                                      uint32_t *first, uint32_t *last) {
+    if (!ts || !prefix || !first || !last)
+        return 1;
+
+    const uint32_t lo = lower_bound(ts, prefix, len);
+    uint32_t hi = lo;
+
+    if (lo < ts->count && ts->recs[lo].length >= len &&
+        memcmp(rec_key(ts, &ts->recs[lo]), prefix, len) == 0) {
+        hi = lo + 1;
+        if (len <= UINT8_MAX) {
+            /* Neighbours sharing >= len bytes with their predecessor still carry the prefix. */
+            while (hi < ts->count && ts->lcp[hi] >= len)
+                hi++;
+        } else {
+            while (hi < ts->count && ts->recs[hi].length >= len &&
+                   memcmp(rec_key(ts, &ts->recs[hi]), prefix, len) == 0)
+                hi++;
+        }
+    }
+
+    *first = lo;
+    *last = hi;
+    return 0;
+}
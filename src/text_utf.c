@@ -0,0 +1,126 @@
+#define TEXT_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "text.h"
+#include "utf.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+/* UTF-16 code units of a value, without the 00 00 terminator. */
+static size_t text_value_units(const text_entry_t *e) {
+    if (!e->value)
+        return 0;
+    size_t units = e->value_length / 2;
+    if (units && e->value[2 * units - 2] == 0 && e->value[2 * units - 1] == 0)
+        units--;
+    return units;
+}
+
+/* ================== UTF-8 TRANSCODING ================== */
+
+TEXT_API int text_entry_get_value_utf8(const text_entry_t *e, char *out, size_t out_size, size_t *out_len) {
+    if (!e)
+        return 1;
+
+    const size_t units = text_value_units(e);
+    const size_t need = sso_utf16le_to_utf8_length(e->value, units);
+    if (out_len)
+        *out_len = need;
+    if (!out || out_size <= need)
+        return 1;
+
+    if (sso_utf16le_to_utf8(e->value, units, out, need) != need)
+        return 1;
+    out[need] = '\0';
+    return 0;
+}
+
+TEXT_API int text_entry_set_value_utf8(text_entry_t *e, const char *utf8, size_t len) {
+    if (!e || (!utf8 && len))
+        return 1;
+
+    const size_t units = sso_utf8_to_utf16le_length(utf8, len);
+    if (units >= UINT32_MAX / 2)
+        return 1;
+
+    char *value = (char *) sso_malloc((units + 1) * 2);
+    if (!value)
+        return 1;
+    if (units && sso_utf8_to_utf16le(utf8, len, value, units) != units) {
+        sso_free(value);
+        return 1;
+    }
+    value[2 * units] = 0;
+    value[2 * units + 1] = 0;
+
+    if (!(e->flags & TEXT_ENTRY_VALUE_BORROWED))
+        sso_free(e->value);
+    e->flags &= (uint8_t) ~TEXT_ENTRY_VALUE_BORROWED;
+    e->value = value;
+    e->value_length = (uint32_t) ((units + 1) * 2);
+    return 0;
+}
+
+TEXT_API int text_file_transcode_all(const text_file_t *tf, text_utf8_table_t *out) {
+    if (!tf || !out)
+        return 1;
+    memset(out, 0, sizeof(*out));
+
+    const uint32_t n = tf->header.entry_count;
+
+    /* Exact sizing pass so offsets and every value share one allocation. */
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const text_entry_t *e = &tf->entries[i];
+        total += sso_utf16le_to_utf8_length(e->value, text_value_units(e)) + 1;
+    }
+    if (total > UINT32_MAX)
+        return 1;
+
+    const size_t offsets_size = ((size_t) n + 1) * sizeof(uint32_t);
+    uint8_t *block = (uint8_t *) sso_malloc(offsets_size + (size_t) total);
+    if (!block)
+        return 1;
+
+    uint32_t *offsets = (uint32_t *) block;
+    char *data = (char *) (block + offsets_size);
+    size_t pos = 0;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const text_entry_t *e = &tf->entries[i];
+        offsets[i] = (uint32_t) pos;
+        const size_t written = sso_utf16le_to_utf8(e->value, text_value_units(e), data + pos,
+                                                   (size_t) total - pos);
+        if (written == SIZE_MAX) {
+            sso_free(block);
+            return 1;
+        }
+        pos += written;
+        data[pos++] = '\0';
+    }
+    offsets[n] = (uint32_t) pos;
+
+    out->data = data;
+    out->offsets = offsets;
+    out->count = n;
+    return 0;
+}
+
+TEXT_API const char *text_utf8_table_get(const text_utf8_table_t *t, uint32_t index, size_t *len) {
+    if (!t || !t->offsets || index >= t->count)
+        return NULL;
+    if (len)
+        *len = t->offsets[index + 1] - t->offsets[index] - 1;
+    return t->data + t->offsets[index];
+}
+
+TEXT_API void text_utf8_table_free(text_utf8_table_t *t) {
+    if (!t)
+        return;
+    /* Offsets head the single block that also holds the data. */
+    sso_free(t->offsets);
+    memset(t, 0, sizeof(*t));
+}
@@ -0,0 +1,11 @@
+#ifndef SSO_TLS_H
+#define SSO_TLS_H
+
+/* Thread-local storage class; C99 has no keyword for it. */
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define SSO_TLS __declspec(thread)
+#else
+    #define SSO_TLS __thread
+#endif
+
+#endif /* SSO_TLS_H */
@@ -0,0 +1,372 @@
+#define SSO_BUILD_DLL
+#include "utf.h"
+#include "cpu.h"
+#include "once.h"
+
+#include <string.h>
+
+#ifdef SSO_X86
+#include <immintrin.h>
+#endif
+
+/* ================== SCALAR CORE ================== */
+
+static inline uint32_t load_unit(const uint8_t *p, size_t i) {
+    return (uint32_t) p[2 * i] | ((uint32_t) p[2 * i + 1] << 8);
+}
+
+static inline void store_unit(uint8_t *p, size_t i, uint32_t u) {
+    p[2 * i] = (uint8_t) u;
+    p[2 * i + 1] = (uint8_t) (u >> 8);
+}
+
+/* Decodes one code point at src[*i], advancing *i by one or two units. */
+static inline uint32_t next_code_point(const uint8_t *src, size_t units, size_t *i) {
+    const uint32_t u = load_unit(src, *i);
+    *i += 1;
+    if (u < 0xD800 || u > 0xDFFF)
+        return u;
+    if (u <= 0xDBFF && *i < units) {
+        const uint32_t lo = load_unit(src, *i);
+        if (lo >= 0xDC00 && lo <= 0xDFFF) {
+            *i += 1;
+            return 0x10000 + ((u - 0xD800) << 10) + (lo - 0xDC00);
+        }
+    }
+    return 0xFFFD;
+}
+
+static inline size_t utf8_size_of(uint32_t cp) {
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+static inline uint8_t *put_utf8(uint8_t *d, uint32_t cp) {
+    if (cp < 0x80) {
+        *d++ = (uint8_t) cp;
+    } else if (cp < 0x800) {
+        *d++ = (uint8_t) (0xC0 | (cp >> 6));
+        *d++ = (uint8_t) (0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *d++ = (uint8_t) (0xE0 | (cp >> 12));
+        *d++ = (uint8_t) (0x80 | ((cp >> 6) & 0x3F));
+        *d++ = (uint8_t) (0x80 | (cp & 0x3F));
+    } else {
+        *d++ = (uint8_t) (0xF0 | (cp >> 18));
+        *d++ = (uint8_t) (0x80 | ((cp >> 12) & 0x3F));
+        *d++ = (uint8_t) (0x80 | ((cp >> 6) & 0x3F));
+        *d++ = (uint8_t) (0x80 | (cp & 0x3F));
+    }
+    return d;
+}
+
+/* Decodes one UTF-8 sequence at src[*i]; malformed input yields U+FFFD and consumes one byte. */
+static inline uint32_t next_utf8(const uint8_t *s, size_t len, size_t *i) {
+    const uint32_t b0 = s[*i];
+    if (b0 < 0x80) {
+        *i += 1;
+        return b0;
+    }
+
+    size_t need;
+    uint32_t cp, min;
+    if ((b0 & 0xE0) == 0xC0) {
+        need = 1; cp = b0 & 0x1F; min = 0x80;
+    } else if ((b0 & 0xF0) == 0xE0) {
+        need = 2; cp = b0 & 0x0F; min = 0x800;
+    } else if ((b0 & 0xF8) == 0xF0) {
+        need = 3; cp = b0 & 0x07; min = 0x10000;
+    } else {
+        *i += 1;
+        return 0xFFFD;
+    }
+
+    if (len - *i <= need) {
+        *i += 1;
+        return 0xFFFD;
+    }
+    for (size_t k = 1; k <= need; ++k) {
+        const uint32_t b = s[*i + k];
+        if ((b & 0xC0) != 0x80) {
+            *i += 1;
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        *i += 1;
+        return 0xFFFD;
+    }
+    *i += need + 1;
+    return cp;
+}
+
+/* ================== KERNELS ================== */
+
+/*
+ * A kernel converts as much as it can and reports progress through in and out;
+ * the scalar loop behind it always finishes the job. Kernels only touch
+ * complete 8-unit blocks with enough output room for a full vector store.
+ */
+typedef void (*u16_to_u8_fn)(const uint8_t *src, size_t units, size_t *in,
+                             uint8_t *dst, size_t dst_size, size_t *out);
+typedef size_t (*u16_len_fn)(const uint8_t *src, size_t units, size_t *in);
+typedef void (*u8_to_u16_fn)(const uint8_t *src, size_t len, size_t *in,
+                             uint8_t *dst, size_t dst_units, size_t *out);
+
+#ifdef SSO_X86
+
+static inline unsigned popcount16(unsigned x) {
+    x = x - ((x >> 1) & 0x5555u);
+    x = (x & 0x3333u) + ((x >> 2) & 0x3333u);
+    x = (x + (x >> 4)) & 0x0F0Fu;
+    return (x + (x >> 8)) & 0x1Fu;
+}
+
+/* Shuffle per 8-bit "lane k is ASCII" mask, compacting 1- and 2-byte lanes. */
+static uint8_t two_byte_shuffle[256][16];
+static uint8_t two_byte_length[256];
+
+/* Called once, from utf_kernels_build. */
+static void two_byte_tables_init(void) {
+    for (unsigned m = 0; m < 256; ++m) {
+        unsigned n = 0;
+        for (unsigned k = 0; k < 8; ++k) {
+            two_byte_shuffle[m][n++] = (uint8_t) (2 * k);
+            if (!(m & (1u << k)))
+                two_byte_shuffle[m][n++] = (uint8_t) (2 * k + 1);
+        }
+        two_byte_length[m] = (uint8_t) n;
+        while (n < 16)
+            two_byte_shuffle[m][n++] = 0x80;
+    }
+}
+
+SSO_TARGET("sse4.1")
+static inline int block_two_byte(__m128i v, uint8_t *d) {
+    const __m128i ascii = _mm_cmplt_epi16(v, _mm_set1_epi16(0x80));
+    const __m128i lead = _mm_or_si128(_mm_srli_epi16(v, 6), _mm_set1_epi16(0xC0));
+    const __m128i cont = _mm_or_si128(_mm_and_si128(v, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+    const __m128i pair = _mm_or_si128(lead, _mm_slli_epi16(cont, 8));
+    const __m128i lanes = _mm_blendv_epi8(pair, v, ascii);
+    const unsigned mask = (unsigned) _mm_movemask_epi8(_mm_packs_epi16(ascii, _mm_setzero_si128())) & 0xFF;
+    const __m128i shuf = _mm_loadu_si128((const __m128i *) two_byte_shuffle[mask]);
+    _mm_storeu_si128((__m128i *) d, _mm_shuffle_epi8(lanes, shuf));
+    return two_byte_length[mask];
+}
+
+SSO_TARGET("sse4.1")
+static void u16_to_u8_sse41(const uint8_t *src, size_t units, size_t *in,
+                            uint8_t *dst, size_t dst_size, size_t *out) {
+    size_t i = *in, o = *out;
+    const __m128i not_ascii = _mm_set1_epi16((short) 0xFF80);
+    const __m128i not_two = _mm_set1_epi16((short) 0xF800);
+
+    while (i + 8 <= units && dst_size - o >= 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (src + 2 * i));
+        if (_mm_testz_si128(v, not_ascii)) {
+            _mm_storel_epi64((__m128i *) (dst + o), _mm_packus_epi16(v, v));
+            o += 8;
+        } else if (_mm_testz_si128(v, not_two)) {
+            o += (size_t) block_two_byte(v, dst + o);
+        } else {
+            break;
+        }
+        i += 8;
+    }
+    *in = i;
+    *out = o;
+}
+
+SSO_TARGET("avx2")
+static void u16_to_u8_avx2(const uint8_t *src, size_t units, size_t *in,
+                           uint8_t *dst, size_t dst_size, size_t *out) {
+    size_t i = *in, o = *out;
+    const __m256i not_ascii = _mm256_set1_epi16((short) 0xFF80);
+
+    /* 16 ASCII units per step; anything else drops to the 8-unit blocks. */
+    while (i + 16 <= units && dst_size - o >= 16) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *) (src + 2 * i));
+        if (!_mm256_testz_si256(v, not_ascii))
+            break;
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+        _mm_storeu_si128((__m128i *) (dst + o), _mm256_castsi256_si128(packed));
+        i += 16;
+        o += 16;
+    }
+    *in = i;
+    *out = o;
+    u16_to_u8_sse41(src, units, in, dst, dst_size, out);
+}
+
+SSO_TARGET("sse4.1")
+static size_t u16_len_sse41(const uint8_t *src, size_t units, size_t *in) {
+    size_t i = *in, total = 0;
+    const __m128i ge80 = _mm_set1_epi16((short) 0xFF80);
+    const __m128i ge800 = _mm_set1_epi16((short) 0xF800);
+    const __m128i sur = _mm_set1_epi16((short) 0xD800);
+
+    while (i + 8 <= units) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (src + 2 * i));
+        /* Surrogates need pairing logic, leave those blocks to the scalar loop. */
+        if (!_mm_testz_si128(_mm_cmpeq_epi16(_mm_and_si128(v, ge800), sur), _mm_set1_epi8(-1)))
+            break;
+        const __m128i a = _mm_cmpeq_epi16(_mm_and_si128(v, ge80), _mm_setzero_si128());
+        const __m128i b = _mm_cmpeq_epi16(_mm_and_si128(v, ge800), _mm_setzero_si128());
+        const unsigned ascii = popcount16((unsigned) _mm_movemask_epi8(a)) / 2;
+        const unsigned below800 = popcount16((unsigned) _mm_movemask_epi8(b)) / 2;
+        total += 8 + (8 - ascii) + (8 - below800);
+        i += 8;
+    }
+    *in = i;
+    return total;
+}
+
+SSO_TARGET("sse2")
+static void u8_to_u16_sse2(const uint8_t *src, size_t len, size_t *in,
+                           uint8_t *dst, size_t dst_units, size_t *out) {
+    size_t i = *in, o = *out;
+    const __m128i zero = _mm_setzero_si128();
+
+    while (i + 16 <= len && dst_units - o >= 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        if (_mm_movemask_epi8(v))
+            break;
+        _mm_storeu_si128((__m128i *) (dst + 2 * o), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i *) (dst + 2 * o + 16), _mm_unpackhi_epi8(v, zero));
+        i += 16;
+        o += 16;
+    }
+    *in = i;
+    *out = o;
+}
+
+#endif
+
+/* ================== DISPATCH ================== */
+
+typedef struct {
+    u16_to_u8_fn to_u8;
+    u16_len_fn   u8_len;
+    u8_to_u16_fn to_u16;
+} utf_kernels_t;
+
+static utf_kernels_t kernels;
+static sso_once_t kernels_once = SSO_ONCE_INIT;
+
+static void utf_kernels_build(void) {
+    utf_kernels_t k = { NULL, NULL, NULL };
+#ifdef SSO_X86
+    const uint32_t features = sso_cpu_features();
+    if (features & SSO_CPU_SSE2)
+        k.to_u16 = u8_to_u16_sse2;
+    if (features & SSO_CPU_SSE41) {
+        two_byte_tables_init();
+        k.to_u8 = (features & SSO_CPU_AVX2) ? u16_to_u8_avx2 : u16_to_u8_sse41;
+        k.u8_len = u16_len_sse41;
+    }
+#endif
+    kernels = k;
+}
+
+static const utf_kernels_t *utf_kernels(void) {
+    sso_once(&kernels_once, utf_kernels_build);
+    return &kernels;
+}
+
+/* ================== TRANSCODING ================== */
+
+SSO_API size_t sso_utf16le_to_utf8_length(const void *src, size_t units) {
+    if (!src)
+        return 0;
+
+    const uint8_t *s = (const uint8_t *) src;
+    const utf_kernels_t *k = utf_kernels();
+    size_t i = 0, total = 0;
+
+    while (i < units) {
+        if (k->u8_len)
+            total += k->u8_len(s, units, &i);
+        /* Scalar catch-up: one block or the tail, then try the kernel again. */
+        const size_t stop = i + 8 < units ? i + 8 : units;
+        while (i < stop)
+            total += utf8_size_of(next_code_point(s, units, &i));
+    }
+    return total;
+}
+
+SSO_API size_t sso_utf16le_to_utf8(const void *src, size_t units, char *dst, size_t dst_size) {
+    if ((!src && units) || (!dst && dst_size))
+        return SIZE_MAX;
+
+    const uint8_t *s = (const uint8_t *) src;
+    uint8_t *d = (uint8_t *) dst;
+    const utf_kernels_t *k = utf_kernels();
+    size_t i = 0, o = 0;
+
+    while (i < units) {
+        if (k->to_u8)
+            k->to_u8(s, units, &i, d, dst_size, &o);
+
+        const size_t stop = i + 8 < units ? i + 8 : units;
+        while (i < stop) {
+            const uint32_t cp = next_code_point(s, units, &i);
+            if (dst_size - o < utf8_size_of(cp))
+                return SIZE_MAX;
+            o = (size_t) (put_utf8(d + o, cp) - d);
+        }
+    }
+    return o;
+}
+
+SSO_API size_t sso_utf8_to_utf16le_length(const char *src, size_t len) {
+    if (!src)
+        return 0;
+
+    const uint8_t *s = (const uint8_t *) src;
+    size_t i = 0, units = 0;
+    while (i < len) {
+        /* Runs of ASCII map 1:1, skip them eight bytes at a time. */
+        if (i + 8 <= len) {
+            uint64_t w;
+            memcpy(&w, s + i, 8);
+            if (!(w & 0x8080808080808080ull)) {
+                i += 8;
+                units += 8;
+                continue;
+            }
+        }
+        units += next_utf8(s, len, &i) >= 0x10000 ? 2 : 1;
+    }
+    return units;
+}
+
+SSO_API size_t sso_utf8_to_utf16le(const char *src, size_t len, void *dst, size_t dst_units) {
+    if ((!src && len) || (!dst && dst_units))
+        return SIZE_MAX;
+
+    const uint8_t *s = (const uint8_t *) src;
+    uint8_t *d = (uint8_t *) dst;
+    const utf_kernels_t *k = utf_kernels();
+    size_t i = 0, o = 0;
+
+    while (i < len) {
+        if (k->to_u16)
+            k->to_u16(s, len, &i, d, dst_units, &o);
+
+        const size_t stop = i + 16 < len ? i + 16 : len;
+        while (i < stop) {
+            const uint32_t cp = next_utf8(s, len, &i);
+            if (cp >= 0x10000) {
+                if (dst_units - o < 2)
+                    return SIZE_MAX;
+                store_unit(d, o++, 0xD800 + ((cp - 0x10000) >> 10));
+                store_unit(d, o++, 0xDC00 + ((cp - 0x10000) & 0x3FF));
+            } else {
+                if (dst_units - o < 1)
+                    return SIZE_MAX;
+                store_unit(d, o++, cp);
+            }
+        }
+    }
+    return o;
+}
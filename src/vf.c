@@ -1,29 +1,45 @@
 #define VF_BUILD_DLL
+#define SSO_BUILD_DLL
 #include "vf.h"
+#include "vf_internal.h"
+#include "stats_internal.h"
+#include "arena.h"
+#include "write.h"
+#include "alloc.h"
 
 #include <stdlib.h>
 #include <string.h>
 
 /* ================== INTERNAL HELPERS ================== */
 
-#pragma pack(push, 1)
-typedef struct {
-    uint8_t unknown1[8];
-    uint8_t original_crc[4];
-    uint8_t exported_crc[4];
-    uint8_t unknown2[4];
-    uint32_t file_size;
-    uint8_t unknown4[8];
-    uint32_t source_file_number;
-    uint8_t unknown5[4];
-    uint32_t path_len;
-} vf_entry_fixed_t;
-#pragma pack(pop)
+/* stdio read-ahead for whole-file loads, allocated per call. */
+#define VF_IO_BUFFER_SIZE (1 << 16)
+
+/* Frees the strings an entry owns; arena-backed strings are left to the arena. */
+static void vf_entry_release(vf_entry_t *e) {
+    if (!(e->flags & VF_ENTRY_NAME_BORROWED))
+        sso_free(e->file_name);
+    if (!(e->flags & VF_ENTRY_PATH_BORROWED))
+        sso_free(e->file_path);
+    e->file_name = NULL;
+    e->file_path = NULL;
+    e->flags = 0;
+}
+
+static char *vf_string_alloc(sso_arena_t *arena, size_t size) {
+    return (char *) (arena ? sso_arena_alloc(arena, size, 1) : sso_malloc(size));
+}
+
+static int vf_header_read_from(sso_reader_t *r, vf_header_t *h) {
+    return SSO_STATS_READ_EXACT(r, h, sizeof(vf_header_t));
+}
 
 int vf_header_read(FILE *f, vf_header_t *h) {
     if (!f || !h)
         return 1;
-    return io_read_exact(f, h, sizeof(vf_header_t));
+    sso_reader_t r;
+    sso_reader_init_stdio(&r, f);
+    return vf_header_read_from(&r, h);
 }
 
 int vf_header_write(FILE *f, const vf_header_t *h) {
@@ -32,28 +48,29 @@ int vf_header_write(FILE *f, const vf_header_t *h) {
     return io_write_exact(f, h, sizeof(vf_header_t));
 }
 
-int vf_entry_read(FILE *f, vf_entry_t *e) {
-    if (!f || !e)
-        return 1;
+int vf_entry_read_from(sso_reader_t *r, vf_entry_t *e, sso_arena_t *arena) {
+    if (arena)
+        e->flags = VF_ENTRY_NAME_BORROWED | VF_ENTRY_PATH_BORROWED;
 
     uint32_t name_len;
 
-    if (io_read_exact(f, &name_len, 4))
+    if (SSO_STATS_READ_EXACT(r, &name_len, 4))
         return 1;
 
-    e->file_name = (char *) malloc(name_len + 1);
+    e->file_name = vf_string_alloc(arena, (size_t) name_len + 1);
     if (!e->file_name)
         return 1;
-    if (io_read_exact(f, e->file_name, name_len)) {
-        free(e->file_name);
-        e->file_name = NULL;
+    if (SSO_STATS_READ_EXACT(r, e->file_name, name_len)) {
+        vf_entry_release(e);
         return 1;
     }
     e->file_name[name_len] = '\0';
 
     vf_entry_fixed_t blk;
-    if (io_read_exact(f, &blk, sizeof(blk)))
+    if (SSO_STATS_READ_EXACT(r, &blk, sizeof(blk))) {
+        vf_entry_release(e);
         return 1;
+    }
 
     memcpy(e->unknown1, blk.unknown1, 8);
     memcpy(e->original_crc, blk.original_crc, 4);
@@ -64,32 +81,45 @@ int vf_entry_read(FILE *f, vf_entry_t *e) {
     e->source_file_number = blk.source_file_number;
     memcpy(e->unknown5, blk.unknown5, 4);
 
-    e->file_path = (char *) malloc(blk.path_len + 1);
-    if (!e->file_path)
+    e->file_path = vf_string_alloc(arena, (size_t) blk.path_len + 1);
+    if (!e->file_path) {
+        vf_entry_release(e);
         return 1;
-    if (io_read_exact(f, e->file_path, blk.path_len)) {
-        free(e->file_path);
-        e->file_path = NULL;
+    }
+    if (SSO_STATS_READ_EXACT(r, e->file_path, blk.path_len)) {
+        vf_entry_release(e);
         return 1;
     }
     e->file_path[blk.path_len] = '\0';
+    SSO_STATS_ENTRIES(1);
 
     return 0;
 }
 
-int vf_entry_write(FILE *f, const vf_entry_t *e) {
+int vf_entry_read(FILE *f, vf_entry_t *e) {
     if (!f || !e)
         return 1;
+    sso_reader_t r;
+    sso_reader_init_stdio(&r, f);
+    return vf_entry_read_from(&r, e, NULL);
+}
 
+/* Encoded size of one entry, or 0 if it has no name or path. */
+static size_t vf_entry_encoded_size(const vf_entry_t *e) {
     if (!e->file_name || !e->file_path)
-        return 1;
+        return 0;
+    return 4 + strlen(e->file_name) + sizeof(vf_entry_fixed_t) + strlen(e->file_path);
+}
+
+/* Serialises one entry at `out`, which must hold vf_entry_encoded_size(e) bytes. */
+static uint8_t *vf_entry_encode(uint8_t *out, const vf_entry_t *e) {
     const uint32_t name_len = (uint32_t) strlen(e->file_name);
     const uint32_t path_len = (uint32_t) strlen(e->file_path);
 
-    if (io_write_exact(f, &name_len, 4))
-        return 1;
-    if (io_write_exact(f, e->file_name, name_len))
-        return 1;
+    memcpy(out, &name_len, 4);
+    out += 4;
+    memcpy(out, e->file_name, name_len);
+    out += name_len;
 
     vf_entry_fixed_t blk;
 
@@ -103,91 +133,273 @@ int vf_entry_write(FILE *f, const vf_entry_t *e) {
     memcpy(blk.unknown5, e->unknown5, 4);
     blk.path_len = path_len;
 
-    if (io_write_exact(f, &blk, sizeof(blk)))
+    memcpy(out, &blk, sizeof(blk));
+    out += sizeof(blk);
+    memcpy(out, e->file_path, path_len);
+    return out + path_len;
+}
+
+int vf_entry_write(FILE *f, const vf_entry_t *e) {
+    if (!f || !e)
+        return 1;
+
+    const size_t size = vf_entry_encoded_size(e);
+    if (size == 0)
         return 1;
 
-    if (io_write_exact(f, e->file_path, path_len))
+    /* Typical entries fit on the stack; one fwrite per entry either way. */
+    uint8_t stack_buf[512];
+    uint8_t *buf = size <= sizeof(stack_buf) ? stack_buf : (uint8_t *) sso_malloc(size);
+    if (!buf)
         return 1;
 
+    vf_entry_encode(buf, e);
+    const int rc = io_write_exact(f, buf, size);
+    if (buf != stack_buf)
+        sso_free(buf);
+    return rc;
+}
+
+/* ================== MEMORY IMAGE PARSING ================== */
+
+int vf_scan_entries(const uint8_t *data, size_t size, uint32_t n, vf_slot_t *slots) {
+    if (!data || size > UINT32_MAX || (n && !slots))
+        return 1;
+
+    size_t pos = sizeof(vf_header_t);
+    if (size < pos)
+        return 1;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        vf_slot_t *s = &slots[i];
+        s->entry_pos = (uint32_t) pos;
+
+        if (size - pos < 4)
+            return 1;
+        memcpy(&s->name_len, data + pos, 4);
+        pos += 4;
+
+        if (size - pos < sizeof(vf_entry_fixed_t) || size - pos - sizeof(vf_entry_fixed_t) < s->name_len)
+            return 1;
+        pos += s->name_len;
+        memcpy(&s->path_len, data + pos + offsetof(vf_entry_fixed_t, path_len), 4);
+        pos += sizeof(vf_entry_fixed_t);
+
+        if (size - pos < s->path_len)
+            return 1;
+        pos += s->path_len;
+    }
+
     return 0;
 }
 
-/* ================== CORE PUBLIC API ================== */
+int vf_entry_decode_slot(vf_entry_t *e, const uint8_t *data, const vf_slot_t *s, sso_arena_t *arena) {
+    if (!e || !data || !s)
+        return 1;
+    memset(e, 0, sizeof(*e));
+    if (arena)
+        e->flags = VF_ENTRY_NAME_BORROWED | VF_ENTRY_PATH_BORROWED;
 
-VF_API vf_file_t *vf_file_read(const char *filename) {
-    if (!filename)
-        return NULL;
+    const uint8_t *name = data + s->entry_pos + 4;
+    vf_entry_fixed_t blk;
+    memcpy(&blk, name + s->name_len, sizeof(blk));
+    const uint8_t *path = name + s->name_len + sizeof(blk);
 
-    FILE *f = fopen(filename, "rb");
-    if (!f)
-        return NULL;
+    e->file_name = vf_string_alloc(arena, (size_t) s->name_len + 1);
+    e->file_path = vf_string_alloc(arena, (size_t) s->path_len + 1);
+    if (!e->file_name || !e->file_path) {
+        vf_entry_release(e);
+        return 1;
+    }
+    memcpy(e->file_name, name, s->name_len);
+    e->file_name[s->name_len] = '\0';
+    memcpy(e->file_path, path, s->path_len);
+    e->file_path[s->path_len] = '\0';
 
-    static char io_buf[1 << 16];
-    setvbuf(f, io_buf, _IOFBF, sizeof(io_buf));
+    memcpy(e->unknown1, blk.unknown1, 8);
+    memcpy(e->original_crc, blk.original_crc, 4);
+    memcpy(e->exported_crc, blk.exported_crc, 4);
+    memcpy(e->unknown2, blk.unknown2, 4);
+    e->file_size = blk.file_size;
+    memcpy(e->unknown4, blk.unknown4, 8);
+    e->source_file_number = blk.source_file_number;
+    memcpy(e->unknown5, blk.unknown5, 4);
+    return 0;
+}
 
-    vf_file_t *vf = (vf_file_t *) calloc(1, sizeof(vf_file_t));
-    if (!vf) {
-        fclose(f);
+/* ================== CORE PUBLIC API ================== */
+
+/* Parses a whole manifest from `r`, positioned at the header. */
+static vf_file_t *vf_file_load_from(sso_reader_t *r, int use_arena) {
+    vf_file_t *vf = (vf_file_t *) sso_calloc(1, sizeof(vf_file_t));
+    if (!vf)
         return NULL;
-    }
 
-    if (vf_header_read(f, &vf->header)) {
-        fclose(f);
-        free(vf);
+    if (vf_header_read_from(r, &vf->header)) {
+        sso_free(vf);
         return NULL;
     }
 
     uint32_t n = vf->header.entry_count;
     if (n == 0) {
         vf->entries = NULL;
-        fclose(f);
         return vf;
     }
 
-    vf->entries = (vf_entry_t *) calloc(n, sizeof(vf_entry_t));
+    /* Every entry takes at least VF_ENTRY_MIN_SIZE bytes, which caps a corrupt count before it is allocated. */
+    uint64_t remaining = 0;
+    const int sized = sso_reader_remaining(r, &remaining) == 0;
+    if (sized && n > remaining / VF_ENTRY_MIN_SIZE) {
+        sso_free(vf);
+        return NULL;
+    }
+
+    if (use_arena) {
+        /* Names and paths plus their terminators always fit in the remaining input. */
+        const size_t block = sized && remaining <= SIZE_MAX ? (size_t) remaining : 0;
+        vf->arena = sso_arena_create(block);
+        if (!vf->arena) {
+            sso_free(vf);
+            return NULL;
+        }
+    }
+
+    vf->entries = (vf_entry_t *) sso_calloc(n, sizeof(vf_entry_t));
     if (!vf->entries) {
-        fclose(f);
-        free(vf);
+        vf_file_free(vf);
         return NULL;
     }
+    vf->capacity = n;
 
     for (uint32_t i = 0; i < n; ++i) {
-        if (vf_entry_read(f, &vf->entries[i])) {
-            fclose(f);
+        if (vf_entry_read_from(r, &vf->entries[i], vf->arena)) {
             vf_file_free(vf);
             return NULL;
         }
     }
 
+    return vf;
+}
+
+static vf_file_t *vf_file_load(const char *filename, int use_arena) {
+    if (!filename)
+        return NULL;
+
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return NULL;
+
+    /* Per-call read-ahead keeps concurrent loads independent; stdio's default is the fallback. */
+    char *io_buf = (char *) sso_malloc(VF_IO_BUFFER_SIZE);
+    if (io_buf && setvbuf(f, io_buf, _IOFBF, VF_IO_BUFFER_SIZE) != 0) {
+        sso_free(io_buf);
+        io_buf = NULL;
+    }
+
+    sso_reader_t r;
+    sso_reader_init_stdio(&r, f);
+    vf_file_t *vf = vf_file_load_from(&r, use_arena);
+
     fclose(f);
+    sso_free(io_buf);
+    return vf;
+}
+
+VF_API vf_file_t *vf_file_create(void) {
+    return (vf_file_t *) sso_calloc(1, sizeof(vf_file_t));
+}
+
+VF_API vf_file_t *vf_file_read(const char *filename) {
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "vf_file_read");
+    vf_file_t *vf = vf_file_load(filename, 0);
+    SSO_STATS_OP_END(op);
+    return vf;
+}
+
+VF_API vf_file_t *vf_file_read_arena(const char *filename) {
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "vf_file_read_arena");
+    vf_file_t *vf = vf_file_load(filename, 1);
+    SSO_STATS_OP_END(op);
     return vf;
 }
 
+VF_API vf_file_t *vf_file_read_mem(const void *data, size_t size) {
+    if (!data && size)
+        return NULL;
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "vf_file_read_mem");
+    sso_reader_t r;
+    sso_reader_init_mem(&r, data, size);
+    vf_file_t *vf = vf_file_load_from(&r, 1);
+    SSO_STATS_OP_END(op);
+    return vf;
+}
+
+VF_API vf_file_t *vf_file_read_from(sso_reader_t *r) {
+    if (!r || !r->ops)
+        return NULL;
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "vf_file_read_from");
+    vf_file_t *vf = vf_file_load_from(r, 1);
+    SSO_STATS_OP_END(op);
+    return vf;
+}
+
+/* Encodes the whole manifest into one buffer from the library allocator. */
+static uint8_t *vf_file_encode(const vf_file_t *vf, size_t *size) {
+    if (vf->header.entry_count > 0 && !vf->entries)
+        return NULL;
+
+    /* Size everything up front so the whole file is encoded into one buffer and written once. */
+    size_t total = sizeof(vf_header_t);
+    for (uint32_t i = 0; i < vf->header.entry_count; ++i) {
+        const size_t entry_size = vf_entry_encoded_size(&vf->entries[i]);
+        if (entry_size == 0)
+            return NULL;
+        total += entry_size;
+    }
+
+    uint8_t *buf = (uint8_t *) sso_malloc(total);
+    if (!buf)
+        return NULL;
+
+    memcpy(buf, &vf->header, sizeof(vf_header_t));
+    uint8_t *out = buf + sizeof(vf_header_t);
+    for (uint32_t i = 0; i < vf->header.entry_count; ++i)
+        out = vf_entry_encode(out, &vf->entries[i]);
+
+    *size = total;
+    return buf;
+}
+
 VF_API int vf_file_write(const char *filename, const vf_file_t *vf) {
     if (!filename || !vf)
         return 1;
 
-    FILE *f = fopen(filename, "wb");
-    if (!f)
+    size_t total;
+    uint8_t *buf = vf_file_encode(vf, &total);
+    if (!buf)
         return 1;
 
-    static char io_buf[1 << 16];
-    setvbuf(f, io_buf, _IOFBF, sizeof(io_buf));
+    const int rc = sso_write_atomic(filename, buf, total, SSO_WRITE_SYNC);
+    sso_free(buf);
+    return rc;
+}
 
-    if (vf_header_write(f, &vf->header)) {
-        fclose(f);
+VF_API int vf_file_write_to(sso_writer_t *w, const vf_file_t *vf) {
+    if (!w || !w->ops || !vf)
         return 1;
-    }
 
-    for (uint32_t i = 0; i < vf->header.entry_count; ++i) {
-        if (vf_entry_write(f, &vf->entries[i])) {
-            fclose(f);
-            return 1;
-        }
-    }
+    size_t total;
+    uint8_t *buf = vf_file_encode(vf, &total);
+    if (!buf)
+        return 1;
 
-    fclose(f);
-    return 0;
+    const int rc = sso_writer_write(w, buf, total);
+    sso_free(buf);
+    return rc;
 }
 
 VF_API void vf_file_free(vf_file_t *vf) {
@@ -195,14 +407,28 @@ VF_API void vf_file_free(vf_file_t *vf) {
         return;
 
     if (vf->entries) {
-        for (uint32_t i = 0; i < vf->header.entry_count; ++i) {
-            free(vf->entries[i].file_name);
-            free(vf->entries[i].file_path);
-        }
+        /* In arena mode this only frees strings that were replaced through the setters. */
+        for (uint32_t i = 0; i < vf->header.entry_count; ++i)
+            vf_entry_release(&vf->entries[i]);
     }
 
-    free(vf->entries);
-    free(vf);
+    sso_free(vf->entries);
+    vf_index_free(vf->index);
+    sso_arena_destroy(vf->arena);
+    sso_free(vf);
+}
+
+VF_API vf_file_t *vf_file_read_with(const char *filename, const sso_allocator_t *a) {
+    const sso_allocator_t *prev = sso_set_thread_allocator(a);
+    vf_file_t *vf = vf_file_read(filename);
+    sso_set_thread_allocator(prev);
+    return vf;
+}
+
+VF_API void vf_file_free_with(vf_file_t *vf, const sso_allocator_t *a) {
+    const sso_allocator_t *prev = sso_set_thread_allocator(a);
+    vf_file_free(vf);
+    sso_set_thread_allocator(prev);
 }
 
 /* ================== STRING ACCESSORS ================== */
@@ -212,11 +438,13 @@ VF_API void vf_entry_set_name(vf_entry_t *e, const char *name) {
         return;
 
     size_t len = strlen(name);
-    char *buf = (char *) malloc(len + 1);
+    char *buf = (char *) sso_malloc(len + 1);
     if (!buf)
         return;
     memcpy(buf, name, len + 1);
-    free(e->file_name);
+    if (!(e->flags & VF_ENTRY_NAME_BORROWED))
+        sso_free(e->file_name);
+    e->flags &= (uint8_t) ~VF_ENTRY_NAME_BORROWED;
     e->file_name = buf;
 }
 
@@ -225,11 +453,13 @@ VF_API void vf_entry_set_path(vf_entry_t *e, const char *path) {
         return;
 
     size_t len = strlen(path);
-    char *buf = (char *) malloc(len + 1);
+    char *buf = (char *) sso_malloc(len + 1);
     if (!buf)
         return;
     memcpy(buf, path, len + 1);
-    free(e->file_path);
+    if (!(e->flags & VF_ENTRY_PATH_BORROWED))
+        sso_free(e->file_path);
+    e->flags &= (uint8_t) ~VF_ENTRY_PATH_BORROWED;
     e->file_path = buf;
 }
 
@@ -248,7 +478,7 @@ VF_API const char *vf_entry_get_path(const vf_entry_t *e) {
 /* ================== ENTRY LIFECYCLE ================== */
 
 VF_API vf_entry_t *vf_entry_create(void) {
-    vf_entry_t *e = (vf_entry_t *) calloc(1, sizeof(vf_entry_t));
+    vf_entry_t *e = (vf_entry_t *) sso_calloc(1, sizeof(vf_entry_t));
     if (!e)
         return NULL;
 
@@ -261,9 +491,8 @@ VF_API void vf_entry_free(vf_entry_t *e) {
     if (!e)
         return;
 
-    free(e->file_name);
-    free(e->file_path);
-    free(e);
+    vf_entry_release(e);
+    sso_free(e);
 }
 
 /* ================== FILE ENTRY MANAGEMENT ================== */
@@ -280,51 +509,106 @@ VF_API vf_entry_t *vf_file_get_entry(vf_file_t *vf, uint32_t index) {
     return &vf->entries[index];
 }
 
-VF_API int vf_file_resize(vf_file_t *vf, uint32_t new_count) {
-    if (!vf)
+#define VF_FILE_MIN_CAPACITY 16u
+
+/* Reallocates the entry array to exactly `capacity` slots (>= entry_count). */
+static int vf_file_set_capacity(vf_file_t *vf, uint32_t capacity) {
+    if (capacity == 0) {
+        sso_free(vf->entries);
+        vf->entries = NULL;
+        vf->capacity = 0;
+        return 0;
+    }
+
+    vf_entry_t *new_entries = (vf_entry_t *) sso_realloc(vf->entries, (size_t) capacity * sizeof(vf_entry_t));
+    if (!new_entries)
         return 1;
+    vf->entries = new_entries;
+    vf->capacity = capacity;
+    return 0;
+}
 
+/* Makes room for `needed` entries, doubling so a run of appends costs amortised O(1) each. */
+static int vf_file_grow(vf_file_t *vf, uint32_t needed) {
+    /* Files built elsewhere (readers, the cache) start with an array sized exactly to entry_count. */
+    uint32_t cap = vf->capacity > vf->header.entry_count ? vf->capacity : vf->header.entry_count;
+    if (needed <= cap)
+        return 0;
+
+    if (cap < VF_FILE_MIN_CAPACITY)
+        cap = VF_FILE_MIN_CAPACITY;
+    while (cap < needed)
+        cap = cap > UINT32_MAX / 2 ? needed : cap * 2;
+    return vf_file_set_capacity(vf, cap);
+}
+
+/* Resizes the entry array without touching the index; callers keep it in step. */
+static int vf_file_set_count(vf_file_t *vf, uint32_t new_count) {
     uint32_t old_count = vf->header.entry_count;
 
     if (new_count == old_count)
         return 0;
 
     if (new_count == 0) {
-        for (uint32_t i = 0; i < old_count; ++i) {
-            free(vf->entries[i].file_name);
-            free(vf->entries[i].file_path);
-        }
-        free(vf->entries);
-        vf->entries = NULL;
+        for (uint32_t i = 0; i < old_count; ++i)
+            vf_entry_release(&vf->entries[i]);
+        vf_file_set_capacity(vf, 0);
         vf->header.entry_count = 0;
         return 0;
     }
 
-    vf_entry_t *new_entries = (vf_entry_t *) realloc(vf->entries, new_count * sizeof(vf_entry_t));
-    if (!new_entries)
-        return 1;
-
-    vf->entries = new_entries;
+    /* Shrinking keeps the slots for later appends; vf_file_shrink_to_fit returns them. */
+    for (uint32_t i = new_count; i < old_count; ++i)
+        vf_entry_release(&vf->entries[i]);
 
     if (new_count > old_count) {
+        if (vf_file_grow(vf, new_count))
+            return 1;
         memset(&vf->entries[old_count], 0, (new_count - old_count) * sizeof(vf_entry_t));
-    } else {
-        for (uint32_t i = new_count; i < old_count; ++i) {
-            free(vf->entries[i].file_name);
-            free(vf->entries[i].file_path);
-        }
     }
 
     vf->header.entry_count = new_count;
     return 0;
 }
 
+VF_API int vf_file_resize(vf_file_t *vf, uint32_t new_count) {
+    if (!vf)
+        return 1;
+
+    const uint32_t old_count = vf->header.entry_count;
+    if (new_count < old_count)
+        vf_index_on_truncate(vf, new_count);
+
+    if (vf_file_set_count(vf, new_count))
+        return 1;
+
+    for (uint32_t i = old_count; i < new_count; ++i)
+        vf_index_on_insert(vf, i);
+    return 0;
+}
+
+VF_API int vf_file_reserve(vf_file_t *vf, uint32_t capacity) {
+    if (!vf)
+        return 1;
+    if (capacity <= vf->capacity || capacity <= vf->header.entry_count)
+        return 0;
+    return vf_file_set_capacity(vf, capacity);
+}
+
+VF_API int vf_file_shrink_to_fit(vf_file_t *vf) {
+    if (!vf)
+        return 1;
+    if (vf->capacity <= vf->header.entry_count)
+        return 0;
+    return vf_file_set_capacity(vf, vf->header.entry_count);
+}
+
 VF_API int vf_file_add_entry(vf_file_t *vf, const vf_entry_t *src) {
     if (!vf || !src)
         return 1;
 
     uint32_t old_count = vf->header.entry_count;
-    if (vf_file_resize(vf, old_count + 1))
+    if (vf_file_set_count(vf, old_count + 1))
         return 1;
 
     vf_entry_t *dst = &vf->entries[old_count];
@@ -344,6 +628,23 @@ VF_API int vf_file_add_entry(vf_file_t *vf, const vf_entry_t *src) {
     dst->source_file_number = src->source_file_number;
     memcpy(dst->unknown5, src->unknown5, 4);
 
+    vf_index_on_insert(vf, old_count);
+    return 0;
+}
+
+VF_API int vf_file_append_take(vf_file_t *vf, vf_entry_t *e) {
+    if (!vf || !e)
+        return 1;
+
+    const uint32_t old_count = vf->header.entry_count;
+    if (old_count == UINT32_MAX || vf_file_grow(vf, old_count + 1))
+        return 1;
+
+    vf->entries[old_count] = *e;
+    memset(e, 0, sizeof(*e));
+    vf->header.entry_count = old_count + 1;
+
+    vf_index_on_insert(vf, old_count);
     return 0;
 }
 
@@ -355,8 +656,9 @@ VF_API int vf_file_remove_entry(vf_file_t *vf, uint32_t index) {
     if (index >= count)
         return 1;
 
-    free(vf->entries[index].file_name);
-    free(vf->entries[index].file_path);
+    /* The index needs the entry's keys to find its chains, so it goes first. */
+    vf_index_on_remove(vf, index);
+    vf_entry_release(&vf->entries[index]);
 
     if (index < count - 1) {
         memmove(&vf->entries[index],
@@ -364,7 +666,41 @@ VF_API int vf_file_remove_entry(vf_file_t *vf, uint32_t index) {
                 (count - index - 1) * sizeof(vf_entry_t));
     }
 
-    return vf_file_resize(vf, count - 1);
+    /* The last slot now duplicates its neighbour; clear it so shrinking does not free those strings again. */
+    memset(&vf->entries[count - 1], 0, sizeof(vf_entry_t));
+    return vf_file_set_count(vf, count - 1);
+}
+
+VF_API uint32_t vf_file_remove_if(vf_file_t *vf, vf_entry_pred_fn pred, void *ctx) {
+    if (!vf || !pred)
+        return 0;
+
+    /* Survivors slide down over the removed entries as the scan goes, so every entry moves at most once. */
+    const uint32_t count = vf->header.entry_count;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        vf_entry_t *e = &vf->entries[i];
+        if (pred(ctx, e, i)) {
+            vf_entry_release(e);
+            continue;
+        }
+        if (kept != i)
+            vf->entries[kept] = *e;
+        kept++;
+    }
+
+    const uint32_t removed = count - kept;
+    if (removed == 0)
+        return 0;
+
+    /* Everything past `kept` is released or moved; zero it so truncating frees nothing twice. */
+    memset(&vf->entries[kept], 0, (size_t) removed * sizeof(vf_entry_t));
+    vf_file_set_count(vf, kept);
+
+    /* Renumbering the chains entry by entry would be quadratic; one rebuild is linear. */
+    if (vf->index && vf_index_build_hashed(vf, NULL))
+        vf_index_drop(vf);
+    return removed;
 }
 
 /* ================== FIELD GETTERS / SETTERS ================== */
@@ -0,0 +1,49 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "pool.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+typedef struct {
+    const char *const *paths;
+    vf_file_t        **files;
+} vf_batch_job_t;
+
+/* One manifest per claim: sizes vary too much for larger grains to balance. */
+static void vf_batch_load(void *ctx, size_t begin, size_t end, unsigned worker) {
+    vf_batch_job_t *job = (vf_batch_job_t *) ctx;
+    (void) worker;
+
+    for (size_t i = begin; i < end; ++i)
+        job->files[i] = job->paths[i] ? vf_file_read(job->paths[i]) : NULL;
+}
+
+/* ================== BATCH LOADING ================== */
+
+VF_API vf_file_t **vf_files_read_many(const char *const *paths, size_t n, unsigned nthreads) {
+    if (!paths || n == 0)
+        return NULL;
+
+    vf_file_t **files = (vf_file_t **) sso_calloc(n, sizeof(vf_file_t *));
+    if (!files)
+        return NULL;
+
+    vf_batch_job_t job;
+    job.paths = paths;
+    job.files = files;
+    sso_parallel_for(nthreads, n, 1, vf_batch_load, &job);
+
+    return files;
+}
+
+VF_API void vf_files_free(vf_file_t **files, size_t n) {
+    if (!files)
+        return;
+    for (size_t i = 0; i < n; ++i)
+        vf_file_free(files[i]);
+    sso_free(files);
+}
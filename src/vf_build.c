@@ -0,0 +1,451 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "crc32.h"
+#include "pool.h"
+#include "alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define VF_BUILD_DEFAULT_READ (1u << 20)
+
+/* One regular file found by the walk, path relative to the root with '/' separators. */
+typedef struct {
+    char          *path;
+    vf_file_stat_t st;
+    uint32_t       crc;
+    uint8_t        cached;
+} vf_build_file_t;
+
+typedef struct {
+    char  **items;
+    size_t  count;
+    size_t  cap;
+} vf_build_dirs_t;
+
+typedef struct {
+    vf_build_file_t *items;
+    size_t           count;
+    size_t           cap;
+} vf_build_files_t;
+
+/* Scratch owned by one pool worker. */
+typedef struct {
+    vf_build_dirs_t  dirs;   /* subdirectories found at the current level */
+    vf_build_files_t files;
+    char            *path;
+    size_t           path_cap;
+    uint8_t         *buf;
+    int              failed;
+} vf_build_worker_t;
+
+typedef struct {
+    const char         *root;
+    size_t              root_len;
+    vf_build_opts_t     opts;
+    vf_build_worker_t  *workers;
+    char              **level;   /* directories being listed in this round */
+    vf_build_file_t    *files;   /* every file, once the walk is done */
+} vf_build_job_t;
+
+static int vf_build_push_dir(vf_build_dirs_t *l, char *dir) {
+    if (l->count == l->cap) {
+        const size_t cap = l->cap ? l->cap * 2 : 16;
+        char **items = (char **) sso_realloc(l->items, cap * sizeof(char *));
+        if (!items)
+            return 1;
+        l->items = items;
+        l->cap = cap;
+    }
+    l->items[l->count++] = dir;
+    return 0;
+}
+
+static int vf_build_push_file(vf_build_files_t *l, char *path, const vf_file_stat_t *st) {
+    if (l->count == l->cap) {
+        const size_t cap = l->cap ? l->cap * 2 : 64;
+        vf_build_file_t *items = (vf_build_file_t *) sso_realloc(l->items, cap * sizeof(vf_build_file_t));
+        if (!items)
+            return 1;
+        l->items = items;
+        l->cap = cap;
+    }
+    vf_build_file_t *f = &l->items[l->count++];
+    memset(f, 0, sizeof(*f));
+    f->path = path;
+    f->st = *st;
+    return 0;
+}
+
+/* `rel` + '/' + `name` (just `name` at the root), heap-allocated. */
+static char *vf_build_child(const char *rel, const char *name) {
+    const size_t rel_len = strlen(rel);
+    const size_t name_len = strlen(name);
+    char *p = (char *) sso_malloc(rel_len + 1 + name_len + 1);
+    if (!p)
+        return NULL;
+    size_t pos = 0;
+    if (rel_len) {
+        memcpy(p, rel, rel_len);
+        p[rel_len] = '/';
+        pos = rel_len + 1;
+    }
+    memcpy(p + pos, name, name_len + 1);
+    return p;
+}
+
+/* root + native separator + rel, in the worker's path buffer. */
+static const char *vf_build_join(vf_build_worker_t *w, const char *root, size_t root_len, const char *rel) {
+    const size_t rel_len = strlen(rel);
+    const size_t need = root_len + 1 + rel_len + 1;
+    if (need > w->path_cap) {
+        char *p = (char *) sso_realloc(w->path, need);
+        if (!p)
+            return NULL;
+        w->path = p;
+        w->path_cap = need;
+    }
+
+    size_t pos = root_len;
+    memcpy(w->path, root, root_len);
+    if (rel_len && root_len && root[root_len - 1] != '/' && root[root_len - 1] != '\\')
+        w->path[pos++] = '/';
+    for (size_t i = 0; i < rel_len; ++i) {
+#ifdef _WIN32
+        w->path[pos++] = rel[i] == '/' ? '\\' : rel[i];
+#else
+        w->path[pos++] = rel[i];
+#endif
+    }
+    w->path[pos] = '\0';
+    return w->path;
+}
+
+/* Files go to the worker's file list, subdirectories to the next level. */
+static int vf_build_found(vf_build_worker_t *w, const char *rel, const char *name, int is_dir,
+                          const vf_file_stat_t *st) {
+    char *child = vf_build_child(rel, name);
+    if (!child)
+        return 1;
+    const int rc = is_dir ? vf_build_push_dir(&w->dirs, child) : vf_build_push_file(&w->files, child, st);
+    if (rc)
+        sso_free(child);
+    return rc;
+}
+
+/*
+ * Lists one directory. Symlinks to files are taken as files; symlinked
+ * directories are skipped so a link cycle cannot make the walk endless.
+ */
+static int vf_build_list_dir(vf_build_job_t *job, vf_build_worker_t *w, const char *rel) {
+#ifdef _WIN32
+    const char *dir = vf_build_join(w, job->root, job->root_len, rel);
+    if (!dir)
+        return 1;
+    const size_t dir_len = strlen(dir);
+    char *pattern = (char *) sso_malloc(dir_len + 3);
+    if (!pattern)
+        return 1;
+    memcpy(pattern, dir, dir_len);
+    memcpy(pattern + dir_len, dir_len && dir[dir_len - 1] != '\\' ? "\\*" : "*", 3);
+
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA(pattern, &fd);
+    sso_free(pattern);
+    if (h == INVALID_HANDLE_VALUE)
+        return 1;
+
+    int rc = 0;
+    do {
+        const char *name = fd.cFileName;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+            continue;
+        const int is_dir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        if (is_dir && (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+            continue;
+
+        vf_file_stat_t st;
+        memset(&st, 0, sizeof(st));
+        if (!is_dir) {
+            char *rel_child = vf_build_child(rel, name);
+            const char *path = rel_child ? vf_build_join(w, job->root, job->root_len, rel_child) : NULL;
+            sso_free(rel_child);
+            if (!path) {
+                rc = 1;
+                break;
+            }
+            if (vf_file_stat(path, &st))
+                continue;
+        }
+        rc = vf_build_found(w, rel, name, is_dir, &st);
+    } while (rc == 0 && FindNextFileA(h, &fd));
+    FindClose(h);
+    return rc;
+#else
+    const char *dir = vf_build_join(w, job->root, job->root_len, rel);
+    if (!dir)
+        return 1;
+    DIR *d = opendir(*dir ? dir : ".");
+    if (!d)
+        return 1;
+
+    int rc = 0;
+    struct dirent *de;
+    while (rc == 0 && (de = readdir(d)) != NULL) {
+        const char *name = de->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+            continue;
+
+        char *rel_child = vf_build_child(rel, name);
+        const char *path = rel_child ? vf_build_join(w, job->root, job->root_len, rel_child) : NULL;
+        sso_free(rel_child);
+        if (!path) {
+            rc = 1;
+            break;
+        }
+
+        struct stat lst;
+        if (lstat(path, &lst))
+            continue;
+        if (S_ISDIR(lst.st_mode)) {
+            rc = vf_build_found(w, rel, name, 1, NULL);
+            continue;
+        }
+
+        /* Regular files, or symlinks resolving to one; the identity is that of the target. */
+        vf_file_stat_t st;
+        if (vf_file_stat(path, &st))
+            continue;
+        rc = vf_build_found(w, rel, name, 0, &st);
+    }
+    closedir(d);
+    return rc;
+#endif
+}
+
+static void vf_build_walk_range(void *ctx, size_t begin, size_t end, unsigned worker) {
+    vf_build_job_t *job = (vf_build_job_t *) ctx;
+    vf_build_worker_t *w = &job->workers[worker];
+
+    for (size_t i = begin; i < end && !w->failed; ++i)
+        w->failed = vf_build_list_dir(job, w, job->level[i]);
+}
+
+static void vf_build_hash_range(void *ctx, size_t begin, size_t end, unsigned worker) {
+    vf_build_job_t *job = (vf_build_job_t *) ctx;
+    vf_build_worker_t *w = &job->workers[worker];
+
+    for (size_t i = begin; i < end && !w->failed; ++i) {
+        vf_build_file_t *f = &job->files[i];
+        const char *path = vf_build_join(w, job->root, job->root_len, f->path);
+        if (!path) {
+            w->failed = 1;
+            break;
+        }
+
+        if (job->opts.cache && vf_verify_cache_lookup(job->opts.cache, path, &f->st, &f->crc) == 0) {
+            f->cached = 1;
+        } else if (job->opts.use_mmap) {
+            w->failed = vf_file_crc_mapped(path, f->st.size, &f->crc);
+        } else {
+            uint64_t got;
+            if (!w->buf && !(w->buf = (uint8_t *) sso_malloc(job->opts.read_size)))
+                w->failed = 1;
+            /* A file that changed size since the walk would get a CRC that no longer fits its size. */
+            else if (vf_file_crc_read(path, w->buf, job->opts.read_size, &f->crc, &got) || got != f->st.size)
+                w->failed = 1;
+        }
+    }
+}
+
+static int vf_build_path_cmp(const void *a, const void *b) {
+    return strcmp(((const vf_build_file_t *) a)->path, ((const vf_build_file_t *) b)->path);
+}
+
+/*
+ * Breadth-first walk, one pool round per tree level: each worker lists some
+ * of the level's directories and collects files and the next level's
+ * directories in its own lists.
+ */
+static int vf_build_walk(vf_build_job_t *job, unsigned threads, vf_build_files_t *all) {
+    vf_build_dirs_t level;
+    memset(&level, 0, sizeof(level));
+    char *root_rel = (char *) sso_calloc(1, 1);
+    if (!root_rel || vf_build_push_dir(&level, root_rel)) {
+        sso_free(root_rel);
+        return 1;
+    }
+
+    int failed = 0;
+    while (level.count > 0 && !failed) {
+        job->level = level.items;
+        sso_parallel_for(sso_pool_threads(threads, level.count, 1), level.count, 1, vf_build_walk_range, job);
+
+        vf_build_dirs_t next;
+        memset(&next, 0, sizeof(next));
+        for (unsigned t = 0; t < threads; ++t) {
+            vf_build_worker_t *w = &job->workers[t];
+            failed |= w->failed;
+            for (size_t i = 0; i < w->dirs.count; ++i) {
+                if (failed || vf_build_push_dir(&next, w->dirs.items[i])) {
+                    sso_free(w->dirs.items[i]);
+                    failed = 1;
+                }
+            }
+            w->dirs.count = 0;
+            for (size_t i = 0; i < w->files.count; ++i) {
+                if (failed || vf_build_push_file(all, w->files.items[i].path, &w->files.items[i].st)) {
+                    sso_free(w->files.items[i].path);
+                    failed = 1;
+                }
+            }
+            w->files.count = 0;
+        }
+
+        for (size_t i = 0; i < level.count; ++i)
+            sso_free(level.items[i]);
+        sso_free(level.items);
+        level = next;
+    }
+
+    for (size_t i = 0; i < level.count; ++i)
+        sso_free(level.items[i]);
+    sso_free(level.items);
+    return failed;
+}
+
+static void vf_crc_store(uint8_t out[4], uint32_t crc) {
+    out[0] = (uint8_t) crc;
+    out[1] = (uint8_t) (crc >> 8);
+    out[2] = (uint8_t) (crc >> 16);
+    out[3] = (uint8_t) (crc >> 24);
+}
+
+static vf_file_t *vf_build_assemble(const vf_build_job_t *job, const vf_build_file_t *files, uint32_t n) {
+    vf_file_t *vf = (vf_file_t *) sso_calloc(1, sizeof(vf_file_t));
+    if (!vf)
+        return NULL;
+    vf->header = job->opts.header;
+    vf->header.entry_count = n;
+    if (n == 0)
+        return vf;
+
+    vf->entries = (vf_entry_t *) sso_calloc(n, sizeof(vf_entry_t));
+    if (!vf->entries) {
+        vf_file_free(vf);
+        return NULL;
+    }
+    vf->capacity = n;
+
+    const char sep = job->opts.separator ? job->opts.separator : '\\';
+    for (uint32_t i = 0; i < n; ++i) {
+        const vf_build_file_t *f = &files[i];
+        vf_entry_t *e = &vf->entries[i];
+
+        const size_t len = strlen(f->path);
+        const char *slash = strrchr(f->path, '/');
+        const char *name = slash ? slash + 1 : f->path;
+        e->file_path = (char *) sso_malloc(len + 1);
+        e->file_name = (char *) sso_malloc(strlen(name) + 1);
+        if (!e->file_path || !e->file_name) {
+            vf_file_free(vf);
+            return NULL;
+        }
+        for (size_t k = 0; k <= len; ++k)
+            e->file_path[k] = f->path[k] == '/' ? sep : f->path[k];
+        memcpy(e->file_name, name, strlen(name) + 1);
+
+        e->file_size = (uint32_t) f->st.size;
+        vf_crc_store(e->original_crc, f->crc);
+        vf_crc_store(e->exported_crc, f->crc);
+        e->source_file_number = job->opts.first_source_number + i;
+    }
+    return vf;
+}
+
+/* ================== MANIFEST BUILDING ================== */
+
+VF_API vf_file_t *vf_file_build_from_dir(const char *root_dir, const vf_build_opts_t *opts) {
+    if (!root_dir)
+        return NULL;
+
+    vf_build_job_t job;
+    memset(&job, 0, sizeof(job));
+    if (opts)
+        job.opts = *opts;
+    if (job.opts.read_size == 0)
+        job.opts.read_size = VF_BUILD_DEFAULT_READ;
+    job.root = root_dir;
+    job.root_len = strlen(root_dir);
+
+    /* Sized for the widest round; each round and the hashing pass use a prefix of the workers. */
+    const unsigned threads = sso_pool_threads(job.opts.nthreads, (size_t) -1, 1);
+    job.workers = (vf_build_worker_t *) sso_calloc(threads, sizeof(vf_build_worker_t));
+    if (!job.workers)
+        return NULL;
+
+    const int64_t start_ns = vf_now_ns();
+    vf_build_files_t all;
+    memset(&all, 0, sizeof(all));
+    int failed = vf_build_walk(&job, threads, &all);
+
+    /* The manifest's order is path order, whatever order the threads listed things in. */
+    if (!failed)
+        qsort(all.items, all.count, sizeof(vf_build_file_t), vf_build_path_cmp);
+    for (size_t i = 0; i < all.count && !failed; ++i)
+        failed = all.items[i].st.size > UINT32_MAX;
+    failed |= all.count > UINT32_MAX;
+
+    if (!failed && all.count > 0) {
+        /* Files vary from bytes to gigabytes, so workers claim one at a time. */
+        job.files = all.items;
+        /* The CRC tables and kernel choice are set up lazily; do it here, not racing in every worker. */
+        sso_crc32_active_kernel();
+        sso_parallel_for(sso_pool_threads(threads, all.count, 1), all.count, 1, vf_build_hash_range, &job);
+        for (unsigned t = 0; t < threads; ++t)
+            failed |= job.workers[t].failed;
+    }
+
+    vf_file_t *vf = failed ? NULL : vf_build_assemble(&job, all.items, (uint32_t) all.count);
+
+    /* Same rule as verification: only files old enough for their timestamps to be trusted are cached. */
+    if (vf && job.opts.cache) {
+        for (size_t i = 0; i < all.count; ++i) {
+            const vf_build_file_t *f = &all.items[i];
+            if (f->cached || f->st.mtime_ns >= start_ns - VF_CACHE_RACY_NS || f->st.ctime_ns >= start_ns - VF_CACHE_RACY_NS)
+                continue;
+            const char *path = vf_build_join(&job.workers[0], job.root, job.root_len, f->path);
+            if (path)
+                vf_verify_cache_store(job.opts.cache, path, &f->st, f->crc);
+        }
+    }
+
+    for (size_t i = 0; i < all.count; ++i)
+        sso_free(all.items[i].path);
+    sso_free(all.items);
+    for (unsigned t = 0; t < threads; ++t) {
+        sso_free(job.workers[t].dirs.items);
+        sso_free(job.workers[t].files.items);
+        sso_free(job.workers[t].path);
+        sso_free(job.workers[t].buf);
+    }
+    sso_free(job.workers);
+    return vf;
+}
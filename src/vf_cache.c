@@ -0,0 +1,192 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "cache.h"
+#include "hash.h"
+#include "map.h"
+#include "arena.h"
+#include "alloc.h"
+#include "stats_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+/* One offset table record in the sidecar, with the path hash lookups are keyed on. */
+typedef struct {
+    uint32_t entry_pos;
+    uint32_t name_len;
+    uint32_t path_len;
+    uint32_t path_hash;
+} vf_cache_record_t;
+
+/* Records must tile the image exactly as a scan would, so they cannot point outside it. */
+static int vf_cache_read_records(const vf_cache_record_t *records, size_t size, uint32_t n, vf_slot_t *slots,
+                                 uint32_t *path_hashes) {
+    uint64_t pos = sizeof(vf_header_t);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const vf_cache_record_t *r = &records[i];
+        if (r->entry_pos != pos)
+            return 1;
+        pos += 4 + (uint64_t) r->name_len + sizeof(vf_entry_fixed_t) + r->path_len;
+        if (pos > size)
+            return 1;
+
+        slots[i].entry_pos = r->entry_pos;
+        slots[i].name_len = r->name_len;
+        slots[i].path_len = r->path_len;
+        path_hashes[i] = r->path_hash;
+    }
+    return 0;
+}
+
+static void vf_cache_hash_paths(const uint8_t *data, uint32_t n, const vf_slot_t *slots, uint32_t *path_hashes) {
+    for (uint32_t i = 0; i < n; ++i) {
+        const vf_slot_t *s = &slots[i];
+        const uint8_t *path = data + s->entry_pos + 4 + s->name_len + sizeof(vf_entry_fixed_t);
+        path_hashes[i] = sso_hash32(path, s->path_len);
+    }
+}
+
+static int vf_cache_store(const char *filename, const sso_cache_key_t *key, uint32_t n, const vf_slot_t *slots,
+                          const uint32_t *path_hashes, const vf_file_t *vf) {
+    vf_cache_record_t *records = (vf_cache_record_t *) sso_malloc((size_t) n * sizeof(vf_cache_record_t));
+    if (!records)
+        return 1;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        records[i].entry_pos = slots[i].entry_pos;
+        records[i].name_len = slots[i].name_len;
+        records[i].path_len = slots[i].path_len;
+        records[i].path_hash = path_hashes[i];
+    }
+
+    void *table = NULL;
+    uint32_t table_slots = 0;
+    if (vf && vf_index_export(vf, &table, &table_slots))
+        table_slots = 0;
+
+    const int rc = sso_cache_store(filename, key, SSO_CACHE_KIND_VF, n, sizeof(vf_cache_record_t),
+                                   records, VF_INDEX_SLOT_SIZE, table_slots, table);
+    sso_free(table);
+    sso_free(records);
+    return rc;
+}
+
+static vf_file_t *vf_cache_load(const char *filename) {
+    sso_map_t map;
+    if (sso_map_open(filename, 0, &map))
+        return NULL;
+
+    if (map.size < sizeof(vf_header_t) || map.size > UINT32_MAX) {
+        sso_map_close(&map);
+        return NULL;
+    }
+
+    vf_file_t *vf = (vf_file_t *) sso_calloc(1, sizeof(vf_file_t));
+    if (!vf) {
+        sso_map_close(&map);
+        return NULL;
+    }
+    memcpy(&vf->header, map.data, sizeof(vf_header_t));
+    SSO_STATS_READ(map.size);
+
+    const uint32_t n = vf->header.entry_count;
+    if (n == 0) {
+        sso_map_close(&map);
+        return vf;
+    }
+
+    /* Every entry is at least its name length, fixed block and nothing else. */
+    const size_t min_entry = 4 + sizeof(vf_entry_fixed_t);
+    vf_slot_t *slots = NULL;
+    uint32_t *path_hashes = NULL;
+    if (n <= (map.size - sizeof(vf_header_t)) / min_entry) {
+        slots = (vf_slot_t *) sso_malloc((size_t) n * sizeof(vf_slot_t));
+        path_hashes = (uint32_t *) sso_malloc((size_t) n * sizeof(uint32_t));
+    }
+    vf->entries = (vf_entry_t *) sso_calloc(n, sizeof(vf_entry_t));
+    /* Names and paths plus their terminators always fit in the image, so one arena block holds them all. */
+    vf->arena = sso_arena_create(map.size);
+    if (!slots || !path_hashes || !vf->entries || !vf->arena) {
+        sso_free(slots);
+        sso_free(path_hashes);
+        sso_map_close(&map);
+        vf_file_free(vf);
+        return NULL;
+    }
+    vf->capacity = n;
+
+    sso_cache_key_t key;
+    sso_cache_t cache;
+    const int keyed = sso_cache_key_compute(filename, map.data, map.size, &key) == 0;
+    /* A hit leaves the cache open so its index tables can be adopted after decoding. */
+    int hit = 0;
+    if (keyed && sso_cache_open(filename, &key, SSO_CACHE_KIND_VF, n, sizeof(vf_cache_record_t),
+                                VF_INDEX_SLOT_SIZE, &cache) == 0) {
+        hit = vf_cache_read_records((const vf_cache_record_t *) cache.records, map.size, n, slots,
+                                    path_hashes) == 0;
+        if (!hit)
+            sso_cache_close(&cache);
+    }
+
+    if (!hit) {
+        if (vf_scan_entries(map.data, map.size, n, slots)) {
+            sso_free(slots);
+            sso_free(path_hashes);
+            sso_map_close(&map);
+            vf_file_free(vf);
+            return NULL;
+        }
+        vf_cache_hash_paths(map.data, n, slots, path_hashes);
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        if (vf_entry_decode_slot(&vf->entries[i], map.data, &slots[i], vf->arena)) {
+            if (hit)
+                sso_cache_close(&cache);
+            sso_free(slots);
+            sso_free(path_hashes);
+            sso_map_close(&map);
+            vf_file_free(vf);
+            return NULL;
+        }
+    }
+
+    SSO_STATS_ENTRIES(n);
+
+    /* Cached tables replace the index build; a cache without them gets them added. */
+    int stale = !hit;
+    if (hit) {
+        if (!cache.table || vf_index_adopt(vf, cache.table, cache.table_slots))
+            stale = 1;
+        sso_cache_close(&cache);
+    }
+    if (stale) {
+        /* The path hashes spare the build one pass over every path; a failed build just leaves none. */
+        if (!vf->index)
+            vf_index_build_hashed(vf, path_hashes);
+        if (keyed)
+            vf_cache_store(filename, &key, n, slots, path_hashes, vf);
+    }
+
+    sso_free(slots);
+    sso_free(path_hashes);
+    sso_map_close(&map);
+    return vf;
+}
+
+/* ================== CACHED READER ================== */
+
+VF_API vf_file_t *vf_file_read_cached(const char *filename) {
+    if (!filename)
+        return NULL;
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "vf_file_read_cached");
+    vf_file_t *vf = vf_cache_load(filename);
+    SSO_STATS_OP_END(op);
+    return vf;
+}
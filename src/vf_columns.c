@@ -0,0 +1,304 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "cpu.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SSO_X86
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/* ================== INTERNAL HELPERS ================== */
+
+/* Columns start on cache-line boundaries so vector loops never split a line at the front. */
+#define VF_COLUMNS_ALIGN 64u
+
+static size_t vf_columns_round(size_t n) {
+    return (n + VF_COLUMNS_ALIGN - 1) & ~(size_t) (VF_COLUMNS_ALIGN - 1);
+}
+
+static uint32_t vf_crc_field(const uint8_t crc[4]) {
+    return (uint32_t) crc[0] | ((uint32_t) crc[1] << 8) | ((uint32_t) crc[2] << 16) | ((uint32_t) crc[3] << 24);
+}
+
+static inline uint32_t vf_bit_length(uint32_t v) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long bit;
+    return _BitScanReverse(&bit, v) ? (uint32_t) bit + 1 : 0;
+#else
+    return v ? 32u - (uint32_t) __builtin_clz(v) : 0;
+#endif
+}
+
+/* Copies `s` (NULL stored as empty) into the blob and records where it starts. */
+static size_t vf_columns_put(char *strings, size_t pos, const char *s, uint32_t *offset) {
+    *offset = (uint32_t) pos;
+    const size_t len = s ? strlen(s) : 0;
+    if (len)
+        memcpy(strings + pos, s, len);
+    strings[pos + len] = '\0';
+    return pos + len + 1;
+}
+
+/* ================== KERNELS ================== */
+
+/* Comparisons reduce to a base test (==, >, <) whose result may be inverted. */
+typedef enum { VF_TEST_EQ, VF_TEST_GT, VF_TEST_LT } vf_test_t;
+
+static vf_test_t vf_cmp_test(vf_cmp_t op, uint32_t *invert) {
+    *invert = op == VF_CMP_NE || op == VF_CMP_LE || op == VF_CMP_GE;
+    switch (op) {
+        case VF_CMP_GT:
+        case VF_CMP_LE:
+            return VF_TEST_GT;
+        case VF_CMP_LT:
+        case VF_CMP_GE:
+            return VF_TEST_LT;
+        default:
+            return VF_TEST_EQ;
+    }
+}
+
+/* Branch-free: every index is written, only matches advance the cursor. */
+static uint32_t filter_scalar(const uint32_t *col, uint32_t begin, uint32_t end, vf_test_t test, uint32_t invert,
+                              uint32_t value, uint32_t *out, uint32_t n) {
+    for (uint32_t i = begin; i < end; ++i) {
+        const uint32_t x = col[i];
+        uint32_t hit = test == VF_TEST_EQ ? x == value : test == VF_TEST_GT ? x > value : x < value;
+        hit ^= invert;
+        if (out)
+            out[n] = i;
+        n += hit;
+    }
+    return n;
+}
+
+static uint64_t sum_scalar(const uint32_t *col, uint32_t count) {
+    uint64_t s0 = 0, s1 = 0;
+    uint32_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        s0 += col[i];
+        s1 += col[i + 1];
+    }
+    if (i < count)
+        s0 += col[i];
+    return s0 + s1;
+}
+
+#ifdef SSO_X86
+
+SSO_TARGET("avx2")
+static uint32_t filter_avx2(const uint32_t *col, uint32_t count, vf_test_t test, uint32_t invert, uint32_t value,
+                            uint32_t *out) {
+    /* AVX2 only compares signed lanes; flipping the top bit makes that an unsigned order. */
+    const __m256i bias = _mm256_set1_epi32((int) 0x80000000u);
+    const __m256i key = _mm256_set1_epi32((int) value);
+    const __m256i key_biased = _mm256_xor_si256(key, bias);
+    const uint32_t flip = invert ? 0xFFu : 0;
+
+    uint32_t n = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i x = _mm256_loadu_si256((const __m256i *) (col + i));
+        __m256i m;
+        if (test == VF_TEST_EQ)
+            m = _mm256_cmpeq_epi32(x, key);
+        else if (test == VF_TEST_GT)
+            m = _mm256_cmpgt_epi32(_mm256_xor_si256(x, bias), key_biased);
+        else
+            m = _mm256_cmpgt_epi32(key_biased, _mm256_xor_si256(x, bias));
+
+        const uint32_t bits = (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(m)) ^ flip;
+        if (bits == 0)
+            continue;
+        for (uint32_t k = 0; k < 8; ++k) {
+            if (out)
+                out[n] = i + k;
+            n += (bits >> k) & 1u;
+        }
+    }
+    return filter_scalar(col, i, count, test, invert, value, out, n);
+}
+
+SSO_TARGET("avx2")
+static uint64_t sum_avx2(const uint32_t *col, uint32_t count) {
+    __m256i lo = _mm256_setzero_si256();
+    __m256i hi = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i x = _mm256_loadu_si256((const __m256i *) (col + i));
+        lo = _mm256_add_epi64(lo, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(x)));
+        hi = _mm256_add_epi64(hi, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(x, 1)));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, _mm256_add_epi64(lo, hi));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_scalar(col + i, count - i);
+}
+
+#endif
+
+static int vf_columns_avx2(void) {
+#ifdef SSO_X86
+    return (sso_cpu_features() & SSO_CPU_AVX2) != 0;
+#else
+    return 0;
+#endif
+}
+
+/* ================== COLUMNAR VIEW ================== */
+
+VF_API int vf_file_to_columns(const vf_file_t *vf, vf_columns_t *out) {
+    if (!vf || !out)
+        return 1;
+    memset(out, 0, sizeof(*out));
+
+    const uint32_t n = vf->header.entry_count;
+    if (n > 0 && !vf->entries)
+        return 1;
+
+    /* Paths first, then names, each followed by its NUL. */
+    uint64_t strings_size = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const vf_entry_t *e = &vf->entries[i];
+        strings_size += (e->file_path ? strlen(e->file_path) : 0) + 1;
+        strings_size += (e->file_name ? strlen(e->file_name) : 0) + 1;
+    }
+    if (strings_size > UINT32_MAX)
+        return 1;
+
+    const size_t values = vf_columns_round((size_t) n * sizeof(uint32_t));
+    const size_t offsets = vf_columns_round(((size_t) n + 1) * sizeof(uint32_t));
+    const size_t size = 4 * values + 2 * offsets + (size_t) strings_size;
+
+    out->block = sso_malloc(size + VF_COLUMNS_ALIGN - 1);
+    if (!out->block)
+        return 1;
+    uint8_t *p = (uint8_t *) vf_columns_round((size_t) (uintptr_t) out->block);
+
+    out->count = n;
+    out->file_size = (uint32_t *) p;
+    out->original_crc = (uint32_t *) (p + values);
+    out->exported_crc = (uint32_t *) (p + 2 * values);
+    out->source_file_number = (uint32_t *) (p + 3 * values);
+    out->path_offset = (uint32_t *) (p + 4 * values);
+    out->name_offset = (uint32_t *) (p + 4 * values + offsets);
+    out->strings = (char *) (p + 4 * values + 2 * offsets);
+    out->strings_size = (size_t) strings_size;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const vf_entry_t *e = &vf->entries[i];
+        out->file_size[i] = e->file_size;
+        out->original_crc[i] = vf_crc_field(e->original_crc);
+        out->exported_crc[i] = vf_crc_field(e->exported_crc);
+        out->source_file_number[i] = e->source_file_number;
+    }
+
+    size_t pos = 0;
+    for (uint32_t i = 0; i < n; ++i)
+        pos = vf_columns_put(out->strings, pos, vf->entries[i].file_path, &out->path_offset[i]);
+    out->path_offset[n] = (uint32_t) pos;
+    for (uint32_t i = 0; i < n; ++i)
+        pos = vf_columns_put(out->strings, pos, vf->entries[i].file_name, &out->name_offset[i]);
+    out->name_offset[n] = (uint32_t) pos;
+    return 0;
+}
+
+VF_API void vf_columns_free(vf_columns_t *c) {
+    if (!c)
+        return;
+    sso_free(c->block);
+    memset(c, 0, sizeof(*c));
+}
+
+VF_API const char *vf_columns_path(const vf_columns_t *c, uint32_t index, uint32_t *len) {
+    if (!c || index >= c->count)
+        return NULL;
+    if (len)
+        *len = c->path_offset[index + 1] - c->path_offset[index] - 1;
+    return c->strings + c->path_offset[index];
+}
+
+VF_API const char *vf_columns_name(const vf_columns_t *c, uint32_t index, uint32_t *len) {
+    if (!c || index >= c->count)
+        return NULL;
+    if (len)
+        *len = c->name_offset[index + 1] - c->name_offset[index] - 1;
+    return c->strings + c->name_offset[index];
+}
+
+/* ================== FILTERS / AGGREGATES ================== */
+
+VF_API uint32_t vf_columns_filter(const uint32_t *column, uint32_t count, vf_cmp_t op, uint32_t value,
+                                  uint32_t *out) {
+    if (!column || count == 0)
+        return 0;
+
+    uint32_t invert;
+    const vf_test_t test = vf_cmp_test(op, &invert);
+#ifdef SSO_X86
+    if (vf_columns_avx2())
+        return filter_avx2(column, count, test, invert, value, out);
+#endif
+    return filter_scalar(column, 0, count, test, invert, value, out, 0);
+}
+
+VF_API uint32_t vf_columns_filter_prefix(const vf_columns_t *c, const char *prefix, size_t len, uint32_t *out) {
+    if (!c || !prefix)
+        return 0;
+
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < c->count; ++i) {
+        const uint32_t path_len = c->path_offset[i + 1] - c->path_offset[i] - 1;
+        if (path_len < len || memcmp(c->strings + c->path_offset[i], prefix, len) != 0)
+            continue;
+        if (out)
+            out[n] = i;
+        n++;
+    }
+    return n;
+}
+
+VF_API uint64_t vf_columns_sum(const uint32_t *column, uint32_t count) {
+    if (!column || count == 0)
+        return 0;
+#ifdef SSO_X86
+    if (vf_columns_avx2())
+        return sum_avx2(column, count);
+#endif
+    return sum_scalar(column, count);
+}
+
+VF_API uint64_t vf_columns_sum_selected(const uint32_t *column, const uint32_t *indices, uint32_t n) {
+    if (!column || !indices)
+        return 0;
+
+    /* Gathers are bound by the scattered loads, so independent accumulators are all that helps. */
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += column[indices[i]];
+        s1 += column[indices[i + 1]];
+        s2 += column[indices[i + 2]];
+        s3 += column[indices[i + 3]];
+    }
+    for (; i < n; ++i)
+        s0 += column[indices[i]];
+    return s0 + s1 + s2 + s3;
+}
+
+VF_API void vf_columns_histogram_log2(const uint32_t *column, uint32_t count, uint64_t bins[33]) {
+    if (!bins)
+        return;
+    memset(bins, 0, 33 * sizeof(uint64_t));
+    if (!column)
+        return;
+    for (uint32_t i = 0; i < count; ++i)
+        bins[vf_bit_length(column[i])]++;
+}
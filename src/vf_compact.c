@@ -0,0 +1,721 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "hash.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define VF_COMPACT_MIN_CAP  16u
+
+/* Hash and id inline; EMPTY ids mark free slots. */
+typedef struct {
+    uint32_t hash;
+    uint32_t id;
+} vf_compact_slot_t;
+
+typedef struct {
+    vf_compact_slot_t *slots;
+    uint32_t           mask;
+    uint32_t           used;
+} vf_compact_table_t;
+
+/*
+ * Directory node. Once building finishes, ids follow a preorder walk, so the
+ * subtree of `d` is dirs [d, d + subtree) and its entries are one run of the
+ * entry order starting at `first`: the direct entries, then each child's.
+ */
+typedef struct {
+    uint32_t parent;
+    uint32_t name;     /* string id, VF_COMPACT_NONE for the root */
+    uint32_t subtree;
+    uint32_t first;
+    uint32_t direct;
+    uint32_t total;
+    char     sep;      /* separator that followed the name in the path that created the node */
+} vf_compact_dir_t;
+
+/* The opaque fixed-block bytes, interned because manifests repeat a handful of patterns. */
+typedef struct {
+    uint8_t unknown1[8];
+    uint8_t unknown2[4];
+    uint8_t unknown4[8];
+    uint8_t unknown5[4];
+} vf_compact_extra_t;
+
+struct vf_compact {
+    vf_header_t          header;
+
+    vf_compact_record_t *records;
+    uint32_t             count;
+    uint32_t             record_cap;
+    uint32_t            *order;        /* entries with a path, grouped by directory in preorder */
+    uint32_t             order_count;
+
+    char                *strings;      /* NUL-terminated, back to back */
+    uint32_t             strings_size;
+    uint32_t             strings_cap;
+    uint32_t            *string_pos;   /* string_count + 1 offsets into `strings` */
+    uint32_t             string_count;
+    uint32_t             string_cap;
+
+    vf_compact_dir_t    *dirs;
+    uint32_t             dir_count;
+    uint32_t             dir_cap;
+    vf_compact_table_t   dir_table;
+
+    vf_compact_extra_t  *extras;
+    uint32_t             extra_count;
+    uint32_t             extra_cap;
+
+    /* Only needed while entries are added; released by vf_compact_finish. */
+    vf_compact_table_t   string_table;
+    vf_compact_table_t   extra_table;
+};
+
+static int vf_compact_reserve(void **p, uint32_t *cap, uint64_t need, size_t elem) {
+    if (need <= *cap)
+        return 0;
+    if (need > UINT32_MAX)
+        return 1;
+
+    uint64_t cap_new = *cap ? *cap : VF_COMPACT_MIN_CAP;
+    while (cap_new < need)
+        cap_new *= 2;
+    if (cap_new > UINT32_MAX)
+        cap_new = UINT32_MAX;
+
+    void *grown = sso_realloc(*p, (size_t) cap_new * elem);
+    if (!grown)
+        return 1;
+    *p = grown;
+    *cap = (uint32_t) cap_new;
+    return 0;
+}
+
+/* Trims a finished array to its length; keeping the larger block is harmless if realloc refuses. */
+static void vf_compact_shrink(void **p, uint32_t *cap, uint32_t count, size_t elem) {
+    if (count == 0 || count == *cap)
+        return;
+    void *shrunk = sso_realloc(*p, (size_t) count * elem);
+    if (shrunk) {
+        *p = shrunk;
+        *cap = count;
+    }
+}
+
+static int vf_compact_table_init(vf_compact_table_t *t, uint32_t cap) {
+    t->slots = (vf_compact_slot_t *) sso_malloc((size_t) cap * sizeof(vf_compact_slot_t));
+    if (!t->slots)
+        return 1;
+    for (uint32_t i = 0; i < cap; ++i)
+        t->slots[i].id = VF_COMPACT_NONE;
+    t->mask = cap - 1;
+    t->used = 0;
+    return 0;
+}
+
+static void vf_compact_table_place(vf_compact_slot_t *slots, uint32_t mask, uint32_t hash, uint32_t id) {
+    uint32_t pos = hash & mask;
+    while (slots[pos].id != VF_COMPACT_NONE)
+        pos = (pos + 1) & mask;
+    slots[pos].hash = hash;
+    slots[pos].id = id;
+}
+
+/* Makes room for one more id at a load factor of at most 1/2, rehashing from the stored hashes. */
+static int vf_compact_table_room(vf_compact_table_t *t) {
+    if ((uint64_t) (t->used + 1) * 2 <= (uint64_t) t->mask + 1)
+        return 0;
+
+    vf_compact_table_t grown;
+    if (t->mask >= 0x7fffffffu || vf_compact_table_init(&grown, (t->mask + 1) * 2))
+        return 1;
+    for (uint32_t i = 0; i <= t->mask; ++i) {
+        if (t->slots[i].id != VF_COMPACT_NONE)
+            vf_compact_table_place(grown.slots, grown.mask, t->slots[i].hash, t->slots[i].id);
+    }
+    grown.used = t->used;
+    sso_free(t->slots);
+    *t = grown;
+    return 0;
+}
+
+static uint32_t vf_compact_string_len(const vf_compact_t *vc, uint32_t id) {
+    return vc->string_pos[id + 1] - vc->string_pos[id] - 1;
+}
+
+static int vf_compact_string_equals(const vf_compact_t *vc, uint32_t id, const char *s, size_t len) {
+    return vf_compact_string_len(vc, id) == len && memcmp(vc->strings + vc->string_pos[id], s, len) == 0;
+}
+
+/* Id of the interned copy of s[0..len), added on first sight; VF_COMPACT_NONE on failure. */
+static uint32_t vf_compact_intern(vf_compact_t *vc, const char *s, size_t len) {
+    vf_compact_table_t *t = &vc->string_table;
+    if (vf_compact_table_room(t))
+        return VF_COMPACT_NONE;
+
+    const uint32_t hash = sso_hash32(s, len);
+    uint32_t pos = hash & t->mask;
+    while (t->slots[pos].id != VF_COMPACT_NONE) {
+        if (t->slots[pos].hash == hash && vf_compact_string_equals(vc, t->slots[pos].id, s, len))
+            return t->slots[pos].id;
+        pos = (pos + 1) & t->mask;
+    }
+
+    /* Ids must stay below the verbatim flag and offsets within 32 bits. */
+    const uint32_t id = vc->string_count;
+    if (id >= VF_COMPACT_VERBATIM - 1 || (uint64_t) vc->strings_size + len + 1 > UINT32_MAX)
+        return VF_COMPACT_NONE;
+    if (vf_compact_reserve((void **) &vc->strings, &vc->strings_cap, (uint64_t) vc->strings_size + len + 1, 1) ||
+        vf_compact_reserve((void **) &vc->string_pos, &vc->string_cap, (uint64_t) id + 2, sizeof(uint32_t)))
+        return VF_COMPACT_NONE;
+
+    memcpy(vc->strings + vc->strings_size, s, len);
+    vc->strings[vc->strings_size + len] = '\0';
+    vc->strings_size += (uint32_t) len + 1;
+    vc->string_pos[id + 1] = vc->strings_size;
+    vc->string_count++;
+
+    t->slots[pos].hash = hash;
+    t->slots[pos].id = id;
+    t->used++;
+    return id;
+}
+
+static uint32_t vf_compact_dir_hash(uint32_t parent, const char *seg, size_t len) {
+    return (uint32_t) sso_hash_mix(((uint64_t) parent << 32) ^ sso_hash32(seg, len));
+}
+
+static uint32_t vf_compact_find_child(const vf_compact_t *vc, uint32_t parent, const char *seg, size_t len,
+                                      uint32_t hash) {
+    const vf_compact_table_t *t = &vc->dir_table;
+    uint32_t pos = hash & t->mask;
+    while (t->slots[pos].id != VF_COMPACT_NONE) {
+        const vf_compact_dir_t *d = &vc->dirs[t->slots[pos].id];
+        if (t->slots[pos].hash == hash && d->parent == parent && vf_compact_string_equals(vc, d->name, seg, len))
+            return t->slots[pos].id;
+        pos = (pos + 1) & t->mask;
+    }
+    return VF_COMPACT_NONE;
+}
+
+/* Child directory `seg` of `parent`, created with separator `sep` if it does not exist yet. */
+static uint32_t vf_compact_child(vf_compact_t *vc, uint32_t parent, const char *seg, size_t len, char sep) {
+    const uint32_t hash = vf_compact_dir_hash(parent, seg, len);
+    uint32_t id = vf_compact_find_child(vc, parent, seg, len, hash);
+    if (id != VF_COMPACT_NONE)
+        return id;
+
+    const uint32_t name = vf_compact_intern(vc, seg, len);
+    if (name == VF_COMPACT_NONE || vf_compact_table_room(&vc->dir_table) ||
+        vf_compact_reserve((void **) &vc->dirs, &vc->dir_cap, (uint64_t) vc->dir_count + 1, sizeof(vf_compact_dir_t)))
+        return VF_COMPACT_NONE;
+
+    id = vc->dir_count++;
+    memset(&vc->dirs[id], 0, sizeof(vf_compact_dir_t));
+    vc->dirs[id].parent = parent;
+    vc->dirs[id].name = name;
+    vc->dirs[id].sep = sep;
+
+    vf_compact_table_place(vc->dir_table.slots, vc->dir_table.mask, hash, id);
+    vc->dir_table.used++;
+    return id;
+}
+
+static uint32_t vf_compact_intern_extra(vf_compact_t *vc, const vf_entry_t *e) {
+    vf_compact_extra_t x;
+    memcpy(x.unknown1, e->unknown1, 8);
+    memcpy(x.unknown2, e->unknown2, 4);
+    memcpy(x.unknown4, e->unknown4, 8);
+    memcpy(x.unknown5, e->unknown5, 4);
+
+    vf_compact_table_t *t = &vc->extra_table;
+    if (vf_compact_table_room(t))
+        return VF_COMPACT_NONE;
+
+    const uint32_t hash = sso_hash32(&x, sizeof(x));
+    uint32_t pos = hash & t->mask;
+    while (t->slots[pos].id != VF_COMPACT_NONE) {
+        if (t->slots[pos].hash == hash && memcmp(&vc->extras[t->slots[pos].id], &x, sizeof(x)) == 0)
+            return t->slots[pos].id;
+        pos = (pos + 1) & t->mask;
+    }
+
+    if (vf_compact_reserve((void **) &vc->extras, &vc->extra_cap, (uint64_t) vc->extra_count + 1,
+                           sizeof(vf_compact_extra_t)))
+        return VF_COMPACT_NONE;
+
+    const uint32_t id = vc->extra_count++;
+    vc->extras[id] = x;
+    t->slots[pos].hash = hash;
+    t->slots[pos].id = id;
+    t->used++;
+    return id;
+}
+
+static int vf_compact_is_sep(char c) {
+    return c == '/' || c == '\\';
+}
+
+/*
+ * Files the path under its directory chain. The tree ignores which separator
+ * a path uses; a path whose separators differ from the nodes it walks through
+ * is kept whole so it still comes back byte for byte.
+ */
+static int vf_compact_add_path(vf_compact_t *vc, vf_compact_record_t *r, const char *path) {
+    const size_t len = strlen(path);
+    uint32_t dir = 0;
+    int verbatim = 0;
+    size_t start = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        if (!vf_compact_is_sep(path[i]))
+            continue;
+        dir = vf_compact_child(vc, dir, path + start, i - start, path[i]);
+        if (dir == VF_COMPACT_NONE)
+            return 1;
+        verbatim |= vc->dirs[dir].sep != path[i];
+        start = i + 1;
+    }
+
+    const uint32_t leaf = verbatim ? vf_compact_intern(vc, path, len) : vf_compact_intern(vc, path + start, len - start);
+    if (leaf == VF_COMPACT_NONE)
+        return 1;
+
+    r->dir = dir;
+    r->leaf = verbatim ? leaf | VF_COMPACT_VERBATIM : leaf;
+    return 0;
+}
+
+static int vf_compact_add(vf_compact_t *vc, const vf_entry_t *e) {
+    if (vf_compact_reserve((void **) &vc->records, &vc->record_cap, (uint64_t) vc->count + 1,
+                           sizeof(vf_compact_record_t)))
+        return 1;
+
+    vf_compact_record_t *r = &vc->records[vc->count];
+    r->dir = VF_COMPACT_NONE;
+    r->leaf = VF_COMPACT_NONE;
+    r->name = VF_COMPACT_NONE;
+
+    if (e->file_path && vf_compact_add_path(vc, r, e->file_path))
+        return 1;
+    if (e->file_name) {
+        /* Usually the path's last segment, in which case this is a table hit and costs nothing. */
+        r->name = vf_compact_intern(vc, e->file_name, strlen(e->file_name));
+        if (r->name == VF_COMPACT_NONE)
+            return 1;
+    }
+
+    r->extra = vf_compact_intern_extra(vc, e);
+    if (r->extra == VF_COMPACT_NONE)
+        return 1;
+
+    memcpy(r->original_crc, e->original_crc, 4);
+    memcpy(r->exported_crc, e->exported_crc, 4);
+    r->file_size = e->file_size;
+    r->source_file_number = e->source_file_number;
+
+    vc->count++;
+    return 0;
+}
+
+static vf_compact_t *vf_compact_create(const vf_header_t *h) {
+    vf_compact_t *vc = (vf_compact_t *) sso_calloc(1, sizeof(vf_compact_t));
+    if (!vc)
+        return NULL;
+    vc->header = *h;
+
+    /* Root directory: no name, no parent. */
+    vc->dirs = (vf_compact_dir_t *) sso_calloc(VF_COMPACT_MIN_CAP, sizeof(vf_compact_dir_t));
+    vc->string_pos = (uint32_t *) sso_calloc(VF_COMPACT_MIN_CAP, sizeof(uint32_t));
+    if (!vc->dirs || !vc->string_pos || vf_compact_table_init(&vc->dir_table, VF_COMPACT_MIN_CAP) ||
+        vf_compact_table_init(&vc->string_table, VF_COMPACT_MIN_CAP) ||
+        vf_compact_table_init(&vc->extra_table, VF_COMPACT_MIN_CAP)) {
+        vf_compact_free(vc);
+        return NULL;
+    }
+    vc->dir_cap = VF_COMPACT_MIN_CAP;
+    vc->string_cap = VF_COMPACT_MIN_CAP;
+    vc->dirs[0].parent = VF_COMPACT_NONE;
+    vc->dirs[0].name = VF_COMPACT_NONE;
+    vc->dir_count = 1;
+    return vc;
+}
+
+/*
+ * Renumbers directories in preorder (children in order of first appearance),
+ * lays out the per-directory entry runs and drops the build-only tables.
+ */
+static int vf_compact_finish(vf_compact_t *vc) {
+    const uint32_t n = vc->dir_count;
+    uint32_t *first_child = (uint32_t *) sso_malloc((size_t) n * sizeof(uint32_t));
+    uint32_t *last_child = (uint32_t *) sso_malloc((size_t) n * sizeof(uint32_t));
+    uint32_t *next_sibling = (uint32_t *) sso_malloc((size_t) n * sizeof(uint32_t));
+    uint32_t *map = (uint32_t *) sso_malloc((size_t) n * sizeof(uint32_t));
+    vf_compact_dir_t *dirs = (vf_compact_dir_t *) sso_malloc((size_t) n * sizeof(vf_compact_dir_t));
+    vc->order = (uint32_t *) sso_malloc((size_t) (vc->count ? vc->count : 1) * sizeof(uint32_t));
+    if (!first_child || !last_child || !next_sibling || !map || !dirs || !vc->order) {
+        sso_free(first_child);
+        sso_free(last_child);
+        sso_free(next_sibling);
+        sso_free(map);
+        sso_free(dirs);
+        return 1;
+    }
+
+    for (uint32_t d = 0; d < n; ++d) {
+        first_child[d] = VF_COMPACT_NONE;
+        next_sibling[d] = VF_COMPACT_NONE;
+    }
+    for (uint32_t d = 1; d < n; ++d) {
+        const uint32_t p = vc->dirs[d].parent;
+        if (first_child[p] == VF_COMPACT_NONE)
+            first_child[p] = d;
+        else
+            next_sibling[last_child[p]] = d;
+        last_child[p] = d;
+    }
+
+    /* Iterative preorder walk; last_child doubles as the stack. */
+    uint32_t *stack = last_child;
+    uint32_t sp = 0, next_id = 0;
+    stack[sp++] = 0;
+    while (sp > 0) {
+        const uint32_t d = stack[--sp];
+        map[d] = next_id++;
+        const uint32_t base = sp;
+        for (uint32_t c = first_child[d]; c != VF_COMPACT_NONE; c = next_sibling[c])
+            stack[sp++] = c;
+        for (uint32_t i = base, j = sp; i + 1 < j; ++i, --j) {
+            const uint32_t tmp = stack[i];
+            stack[i] = stack[j - 1];
+            stack[j - 1] = tmp;
+        }
+    }
+
+    for (uint32_t d = 0; d < n; ++d) {
+        vf_compact_dir_t *nd = &dirs[map[d]];
+        *nd = vc->dirs[d];
+        nd->parent = d == 0 ? VF_COMPACT_NONE : map[vc->dirs[d].parent];
+        nd->subtree = 1;
+        nd->direct = 0;
+    }
+    sso_free(vc->dirs);
+    vc->dirs = dirs;
+    vc->dir_cap = n;
+
+    /* The child table is keyed on parent ids, so it is re-laid with the new ones. */
+    for (uint32_t i = 0; i <= vc->dir_table.mask; ++i)
+        vc->dir_table.slots[i].id = VF_COMPACT_NONE;
+    for (uint32_t d = 1; d < n; ++d) {
+        const uint32_t name = dirs[d].name;
+        const uint32_t hash = vf_compact_dir_hash(dirs[d].parent, vc->strings + vc->string_pos[name],
+                                                  vf_compact_string_len(vc, name));
+        vf_compact_table_place(vc->dir_table.slots, vc->dir_table.mask, hash, d);
+    }
+    for (uint32_t i = 0; i < vc->count; ++i) {
+        vf_compact_record_t *r = &vc->records[i];
+        if (r->dir == VF_COMPACT_NONE)
+            continue;
+        r->dir = map[r->dir];
+        dirs[r->dir].direct++;
+    }
+
+    /* Parents precede children in preorder, so one backward pass rolls sizes up. */
+    uint32_t acc = 0;
+    for (uint32_t d = 0; d < n; ++d) {
+        dirs[d].first = acc;
+        dirs[d].total = dirs[d].direct;
+        acc += dirs[d].direct;
+    }
+    for (uint32_t d = n - 1; d > 0; --d) {
+        dirs[dirs[d].parent].subtree += dirs[d].subtree;
+        dirs[dirs[d].parent].total += dirs[d].total;
+    }
+
+    uint32_t *cursor = map;
+    for (uint32_t d = 0; d < n; ++d)
+        cursor[d] = dirs[d].first;
+    for (uint32_t i = 0; i < vc->count; ++i) {
+        const uint32_t d = vc->records[i].dir;
+        if (d != VF_COMPACT_NONE)
+            vc->order[cursor[d]++] = i;
+    }
+    vc->order_count = acc;
+
+    sso_free(first_child);
+    sso_free(last_child);
+    sso_free(next_sibling);
+    sso_free(map);
+
+    sso_free(vc->string_table.slots);
+    sso_free(vc->extra_table.slots);
+    vc->string_table.slots = NULL;
+    vc->extra_table.slots = NULL;
+
+    vf_compact_shrink((void **) &vc->records, &vc->record_cap, vc->count, sizeof(vf_compact_record_t));
+    vf_compact_shrink((void **) &vc->strings, &vc->strings_cap, vc->strings_size, 1);
+    vf_compact_shrink((void **) &vc->string_pos, &vc->string_cap, vc->string_count + 1, sizeof(uint32_t));
+    vf_compact_shrink((void **) &vc->extras, &vc->extra_cap, vc->extra_count, sizeof(vf_compact_extra_t));
+    return 0;
+}
+
+/* ================== COMPACT MANIFESTS ================== */
+
+VF_API vf_compact_t *vf_compact_build(const vf_file_t *vf) {
+    if (!vf || (vf->header.entry_count > 0 && !vf->entries))
+        return NULL;
+
+    vf_compact_t *vc = vf_compact_create(&vf->header);
+    if (!vc)
+        return NULL;
+
+    if (vf_compact_reserve((void **) &vc->records, &vc->record_cap, vf->header.entry_count,
+                           sizeof(vf_compact_record_t))) {
+        vf_compact_free(vc);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < vf->header.entry_count; ++i) {
+        if (vf_compact_add(vc, &vf->entries[i])) {
+            vf_compact_free(vc);
+            return NULL;
+        }
+    }
+
+    if (vf_compact_finish(vc)) {
+        vf_compact_free(vc);
+        return NULL;
+    }
+    return vc;
+}
+
+VF_API vf_compact_t *vf_compact_read(const char *filename) {
+    vf_reader_t *r = vf_reader_open(filename, 0);
+    if (!r)
+        return NULL;
+
+    vf_compact_t *vc = vf_compact_create(vf_reader_header(r));
+    if (!vc) {
+        vf_reader_close(r);
+        return NULL;
+    }
+
+    const vf_entry_t *e;
+    int failed = 0;
+    while (!failed && vf_reader_next(r, &e) == 0)
+        failed = vf_compact_add(vc, e);
+    failed |= vf_reader_failed(r);
+    vf_reader_close(r);
+
+    if (failed || vf_compact_finish(vc)) {
+        vf_compact_free(vc);
+        return NULL;
+    }
+    return vc;
+}
+
+VF_API void vf_compact_free(vf_compact_t *vc) {
+    if (!vc)
+        return;
+    sso_free(vc->records);
+    sso_free(vc->order);
+    sso_free(vc->strings);
+    sso_free(vc->string_pos);
+    sso_free(vc->dirs);
+    sso_free(vc->dir_table.slots);
+    sso_free(vc->extras);
+    sso_free(vc->string_table.slots);
+    sso_free(vc->extra_table.slots);
+    sso_free(vc);
+}
+
+VF_API const vf_header_t *vf_compact_header(const vf_compact_t *vc) {
+    return vc ? &vc->header : NULL;
+}
+
+VF_API uint32_t vf_compact_entry_count(const vf_compact_t *vc) {
+    return vc ? vc->count : 0;
+}
+
+VF_API size_t vf_compact_memory(const vf_compact_t *vc) {
+    if (!vc)
+        return 0;
+    return sizeof(vf_compact_t) +
+           (size_t) vc->record_cap * sizeof(vf_compact_record_t) +
+           (size_t) vc->count * sizeof(uint32_t) +
+           (size_t) vc->strings_cap +
+           (size_t) vc->string_cap * sizeof(uint32_t) +
+           (size_t) vc->dir_cap * sizeof(vf_compact_dir_t) +
+           ((size_t) vc->dir_table.mask + 1) * sizeof(vf_compact_slot_t) +
+           (size_t) vc->extra_cap * sizeof(vf_compact_extra_t);
+}
+
+VF_API const vf_compact_record_t *vf_compact_record(const vf_compact_t *vc, uint32_t index) {
+    if (!vc || index >= vc->count)
+        return NULL;
+    return &vc->records[index];
+}
+
+VF_API const char *vf_compact_string(const vf_compact_t *vc, uint32_t id, uint32_t *len) {
+    if (!vc)
+        return NULL;
+    id &= ~VF_COMPACT_VERBATIM;
+    if (id >= vc->string_count)
+        return NULL;
+    if (len)
+        *len = vf_compact_string_len(vc, id);
+    return vc->strings + vc->string_pos[id];
+}
+
+VF_API const char *vf_compact_get_name(const vf_compact_t *vc, uint32_t index) {
+    const vf_compact_record_t *r = vf_compact_record(vc, index);
+    if (!r || r->name == VF_COMPACT_NONE)
+        return NULL;
+    return vc->strings + vc->string_pos[r->name];
+}
+
+VF_API int vf_compact_get_path(const vf_compact_t *vc, uint32_t index, char *out, size_t out_size, size_t *out_len) {
+    const vf_compact_record_t *r = vf_compact_record(vc, index);
+    if (!r || r->leaf == VF_COMPACT_NONE)
+        return 1;
+
+    const uint32_t leaf = r->leaf & ~VF_COMPACT_VERBATIM;
+    const uint32_t leaf_len = vf_compact_string_len(vc, leaf);
+    size_t need = leaf_len;
+    if (!(r->leaf & VF_COMPACT_VERBATIM)) {
+        for (uint32_t d = r->dir; d != 0; d = vc->dirs[d].parent)
+            need += vf_compact_string_len(vc, vc->dirs[d].name) + 1;
+    }
+
+    if (out_len)
+        *out_len = need;
+    if (!out || out_size <= need)
+        return 1;
+
+    /* Filled back to front: leaf first, then each directory up to the root. */
+    size_t pos = need - leaf_len;
+    memcpy(out + pos, vc->strings + vc->string_pos[leaf], leaf_len);
+    out[need] = '\0';
+    if (!(r->leaf & VF_COMPACT_VERBATIM)) {
+        for (uint32_t d = r->dir; d != 0; d = vc->dirs[d].parent) {
+            const vf_compact_dir_t *dir = &vc->dirs[d];
+            const uint32_t len = vf_compact_string_len(vc, dir->name);
+            out[--pos] = dir->sep;
+            pos -= len;
+            memcpy(out + pos, vc->strings + vc->string_pos[dir->name], len);
+        }
+    }
+    return 0;
+}
+
+VF_API vf_entry_t *vf_compact_clone_entry(const vf_compact_t *vc, uint32_t index) {
+    const vf_compact_record_t *r = vf_compact_record(vc, index);
+    if (!r)
+        return NULL;
+
+    vf_entry_t *e = vf_entry_create();
+    if (!e)
+        return NULL;
+
+    if (r->name != VF_COMPACT_NONE) {
+        vf_entry_set_name(e, vc->strings + vc->string_pos[r->name]);
+        if (!e->file_name) {
+            vf_entry_free(e);
+            return NULL;
+        }
+    }
+
+    if (r->leaf != VF_COMPACT_NONE) {
+        size_t path_len = 0;
+        vf_compact_get_path(vc, index, NULL, 0, &path_len);
+        e->file_path = (char *) sso_malloc(path_len + 1);
+        if (!e->file_path || vf_compact_get_path(vc, index, e->file_path, path_len + 1, NULL)) {
+            vf_entry_free(e);
+            return NULL;
+        }
+    }
+
+    const vf_compact_extra_t *x = &vc->extras[r->extra];
+    memcpy(e->unknown1, x->unknown1, 8);
+    memcpy(e->original_crc, r->original_crc, 4);
+    memcpy(e->exported_crc, r->exported_crc, 4);
+    memcpy(e->unknown2, x->unknown2, 4);
+    e->file_size = r->file_size;
+    memcpy(e->unknown4, x->unknown4, 8);
+    e->source_file_number = r->source_file_number;
+    memcpy(e->unknown5, x->unknown5, 4);
+    return e;
+}
+
+/* ================== DIRECTORY QUERIES ================== */
+
+VF_API int vf_compact_find_dir(const vf_compact_t *vc, const char *path, size_t len, uint32_t *out) {
+    if (!vc || (!path && len) || !out)
+        return 1;
+
+    if (len > 0 && vf_compact_is_sep(path[len - 1]))
+        len--;
+
+    uint32_t dir = 0;
+    size_t start = 0;
+    for (size_t i = 0; len > 0 && i <= len; ++i) {
+        if (i < len && !vf_compact_is_sep(path[i]))
+            continue;
+        const char *seg = path + start;
+        dir = vf_compact_find_child(vc, dir, seg, i - start, vf_compact_dir_hash(dir, seg, i - start));
+        if (dir == VF_COMPACT_NONE)
+            return 1;
+        start = i + 1;
+    }
+
+    *out = dir;
+    return 0;
+}
+
+VF_API uint32_t vf_compact_dir_count(const vf_compact_t *vc) {
+    return vc ? vc->dir_count : 0;
+}
+
+VF_API uint32_t vf_compact_dir_parent(const vf_compact_t *vc, uint32_t dir) {
+    if (!vc || dir >= vc->dir_count)
+        return VF_COMPACT_NONE;
+    return vc->dirs[dir].parent;
+}
+
+VF_API const char *vf_compact_dir_name(const vf_compact_t *vc, uint32_t dir, uint32_t *len) {
+    if (!vc || dir >= vc->dir_count)
+        return NULL;
+    if (dir == 0) {
+        if (len)
+            *len = 0;
+        return "";
+    }
+    return vf_compact_string(vc, vc->dirs[dir].name, len);
+}
+
+VF_API uint32_t vf_compact_dir_first_child(const vf_compact_t *vc, uint32_t dir) {
+    if (!vc || dir >= vc->dir_count || vc->dirs[dir].subtree == 1)
+        return VF_COMPACT_NONE;
+    return dir + 1;
+}
+
+VF_API uint32_t vf_compact_dir_next_sibling(const vf_compact_t *vc, uint32_t dir) {
+    if (!vc || dir == 0 || dir >= vc->dir_count)
+        return VF_COMPACT_NONE;
+    const vf_compact_dir_t *p = &vc->dirs[vc->dirs[dir].parent];
+    const uint32_t next = dir + vc->dirs[dir].subtree;
+    return next < vc->dirs[dir].parent + p->subtree ? next : VF_COMPACT_NONE;
+}
+
+VF_API const uint32_t *vf_compact_dir_entries(const vf_compact_t *vc, uint32_t dir, int recursive, uint32_t *count) {
+    if (!vc || dir >= vc->dir_count || !count)
+        return NULL;
+    const vf_compact_dir_t *d = &vc->dirs[dir];
+    *count = recursive ? d->total : d->direct;
+    return vc->order + d->first;
+}
@@ -0,0 +1,256 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "hash.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define VF_DIFF_EMPTY    UINT32_MAX
+#define VF_DIFF_MIN_CAP  16u
+
+typedef struct {
+    uint32_t hash;
+    uint32_t index;
+} vf_diff_slot_t;
+
+/* Build side of the hash join: every old entry with a path, plus which ones found a partner. */
+typedef struct {
+    const vf_file_t *old_vf;
+    vf_diff_slot_t  *slots;
+    uint32_t         mask;
+    uint8_t         *matched;
+} vf_diff_join_t;
+
+static int vf_diff_join_init(vf_diff_join_t *j, const vf_file_t *old_vf) {
+    const uint32_t n = old_vf->header.entry_count;
+
+    uint64_t cap = VF_DIFF_MIN_CAP;
+    while (cap < (uint64_t) n * 2)
+        cap <<= 1;
+    if (cap > 0x80000000u)
+        return 1;
+
+    j->old_vf = old_vf;
+    j->mask = (uint32_t) cap - 1;
+    j->slots = (vf_diff_slot_t *) sso_malloc((size_t) cap * sizeof(vf_diff_slot_t));
+    j->matched = (uint8_t *) sso_calloc(n ? n : 1, 1);
+    if (!j->slots || !j->matched) {
+        sso_free(j->slots);
+        sso_free(j->matched);
+        return 1;
+    }
+    for (uint32_t i = 0; i <= j->mask; ++i)
+        j->slots[i].index = VF_DIFF_EMPTY;
+
+    /* Duplicate paths get a slot each, so they pair up with duplicates on the other side in order. */
+    for (uint32_t i = 0; i < n; ++i) {
+        const char *path = old_vf->entries[i].file_path;
+        if (!path)
+            continue;
+        const uint32_t hash = sso_hash32(path, strlen(path));
+        uint32_t pos = hash & j->mask;
+        while (j->slots[pos].index != VF_DIFF_EMPTY)
+            pos = (pos + 1) & j->mask;
+        j->slots[pos].hash = hash;
+        j->slots[pos].index = i;
+    }
+    return 0;
+}
+
+static void vf_diff_join_free(vf_diff_join_t *j) {
+    sso_free(j->slots);
+    sso_free(j->matched);
+}
+
+/* Lowest-numbered old entry with this path that has not been paired yet, VF_DIFF_NONE if none. */
+static uint32_t vf_diff_join_take(vf_diff_join_t *j, const char *path) {
+    const size_t len = strlen(path);
+    const uint32_t hash = sso_hash32(path, len);
+    uint32_t best = VF_DIFF_NONE;
+
+    for (uint32_t pos = hash & j->mask; j->slots[pos].index != VF_DIFF_EMPTY; pos = (pos + 1) & j->mask) {
+        const uint32_t index = j->slots[pos].index;
+        if (j->slots[pos].hash != hash || j->matched[index] || index >= best)
+            continue;
+        if (strcmp(j->old_vf->entries[index].file_path, path) == 0)
+            best = index;
+    }
+
+    if (best != VF_DIFF_NONE)
+        j->matched[best] = 1;
+    return best;
+}
+
+static uint32_t vf_diff_compare(const vf_entry_t *a, const vf_entry_t *b) {
+    uint32_t changes = 0;
+    if (a->file_size != b->file_size)
+        changes |= VF_DIFF_RESIZED;
+    if (memcmp(a->original_crc, b->original_crc, 4) != 0 || memcmp(a->exported_crc, b->exported_crc, 4) != 0)
+        changes |= VF_DIFF_CRC_CHANGED;
+    return changes;
+}
+
+static void vf_diff_count(vf_diff_t *counts, uint32_t changes) {
+    if (!counts)
+        return;
+    if (changes == 0)
+        counts->unchanged++;
+    if (changes & VF_DIFF_ADDED)
+        counts->added++;
+    if (changes & VF_DIFF_REMOVED)
+        counts->removed++;
+    if (changes & VF_DIFF_RESIZED)
+        counts->resized++;
+    if (changes & VF_DIFF_CRC_CHANGED)
+        counts->crc_changed++;
+}
+
+/*
+ * Probes one new entry against the join and reports it; unchanged pairs are
+ * only counted. Returns the callback's nonzero value to stop early.
+ */
+static int vf_diff_probe(vf_diff_join_t *j, const vf_entry_t *e, uint32_t new_index, vf_diff_fn fn, void *ctx,
+                         vf_diff_t *counts) {
+    vf_diff_change_t c;
+    c.old_index = e->file_path ? vf_diff_join_take(j, e->file_path) : VF_DIFF_NONE;
+    c.new_index = new_index;
+
+    const vf_entry_t *old_e = NULL;
+    if (c.old_index == VF_DIFF_NONE) {
+        c.changes = VF_DIFF_ADDED;
+    } else {
+        old_e = &j->old_vf->entries[c.old_index];
+        c.changes = vf_diff_compare(old_e, e);
+    }
+
+    vf_diff_count(counts, c.changes);
+    return c.changes ? fn(ctx, &c, old_e, e) : 0;
+}
+
+/* Old entries nobody claimed, in old-file order. */
+static int vf_diff_flush_removed(vf_diff_join_t *j, vf_diff_fn fn, void *ctx, vf_diff_t *counts) {
+    for (uint32_t i = 0; i < j->old_vf->header.entry_count; ++i) {
+        if (j->matched[i])
+            continue;
+        vf_diff_change_t c;
+        c.old_index = i;
+        c.new_index = VF_DIFF_NONE;
+        c.changes = VF_DIFF_REMOVED;
+        vf_diff_count(counts, c.changes);
+        const int rc = fn(ctx, &c, &j->old_vf->entries[i], NULL);
+        if (rc)
+            return rc;
+    }
+    return 0;
+}
+
+/* Collector behind vf_diff: appends every reported change to the report's array. */
+static int vf_diff_collect(void *ctx, const vf_diff_change_t *c, const vf_entry_t *old_e, const vf_entry_t *new_e) {
+    (void) old_e;
+    (void) new_e;
+
+    vf_diff_t *out = (vf_diff_t *) ctx;
+    if (out->count == out->capacity) {
+        const uint32_t cap = out->capacity ? out->capacity * 2 : 64;
+        vf_diff_change_t *grown = (vf_diff_change_t *) sso_realloc(out->changes, (size_t) cap * sizeof(vf_diff_change_t));
+        if (!grown)
+            return -1;
+        out->changes = grown;
+        out->capacity = cap;
+    }
+    out->changes[out->count++] = *c;
+    return 0;
+}
+
+/* ================== MANIFEST DIFF ================== */
+
+VF_API int vf_diff_each(const vf_file_t *old_vf, const vf_file_t *new_vf, vf_diff_fn fn, void *ctx,
+                        vf_diff_t *counts) {
+    if (!old_vf || !new_vf || !fn)
+        return 1;
+    if ((old_vf->header.entry_count > 0 && !old_vf->entries) || (new_vf->header.entry_count > 0 && !new_vf->entries))
+        return 1;
+
+    if (counts)
+        memset(counts, 0, sizeof(*counts));
+
+    vf_diff_join_t j;
+    if (vf_diff_join_init(&j, old_vf))
+        return 1;
+
+    int rc = 0;
+    for (uint32_t i = 0; i < new_vf->header.entry_count && rc == 0; ++i)
+        rc = vf_diff_probe(&j, &new_vf->entries[i], i, fn, ctx, counts);
+    if (rc == 0)
+        rc = vf_diff_flush_removed(&j, fn, ctx, counts);
+
+    vf_diff_join_free(&j);
+    return rc < 0 ? 1 : 0;
+}
+
+VF_API int vf_diff_each_file(const vf_file_t *old_vf, const char *new_filename, vf_diff_fn fn, void *ctx,
+                             vf_diff_t *counts) {
+    if (!old_vf || !new_filename || !fn)
+        return 1;
+    if (old_vf->header.entry_count > 0 && !old_vf->entries)
+        return 1;
+
+    vf_reader_t *r = vf_reader_open(new_filename, 0);
+    if (!r)
+        return 1;
+
+    if (counts)
+        memset(counts, 0, sizeof(*counts));
+
+    vf_diff_join_t j;
+    if (vf_diff_join_init(&j, old_vf)) {
+        vf_reader_close(r);
+        return 1;
+    }
+
+    int rc = 0;
+    const vf_entry_t *e;
+    for (uint32_t i = 0; rc == 0 && vf_reader_next(r, &e) == 0; ++i)
+        rc = vf_diff_probe(&j, e, i, fn, ctx, counts);
+
+    /* Removals are only known once the whole new file has been seen, and a truncated one would fake them. */
+    if (rc == 0 && vf_reader_failed(r))
+        rc = -1;
+    if (rc == 0)
+        rc = vf_diff_flush_removed(&j, fn, ctx, counts);
+
+    vf_diff_join_free(&j);
+    vf_reader_close(r);
+    return rc < 0 ? 1 : 0;
+}
+
+VF_API int vf_diff(const vf_file_t *old_vf, const vf_file_t *new_vf, vf_diff_t *out) {
+    if (!out)
+        return 1;
+
+    vf_diff_t report;
+    memset(&report, 0, sizeof(report));
+    vf_diff_t counts;
+    if (vf_diff_each(old_vf, new_vf, vf_diff_collect, &report, &counts)) {
+        sso_free(report.changes);
+        return 1;
+    }
+
+    counts.changes = report.changes;
+    counts.count = report.count;
+    counts.capacity = report.capacity;
+    *out = counts;
+    return 0;
+}
+
+VF_API void vf_diff_free(vf_diff_t *d) {
+    if (!d)
+        return;
+    sso_free(d->changes);
+    memset(d, 0, sizeof(*d));
+}
@@ -0,0 +1,586 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "hash.h"
+#include "stats_internal.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define VF_INDEX_EMPTY    UINT32_MAX        /* free group slot, end of a chain */
+#define VF_INDEX_ABSENT   (UINT32_MAX - 1)  /* entry has no key in this table */
+#define VF_INDEX_MIN_CAP  16u
+
+enum { VF_INDEX_PATH = 0, VF_INDEX_NAME, VF_INDEX_SOURCE, VF_INDEX_TABLES };
+
+/*
+ * One slot per distinct key. Entries sharing the key form a chain through
+ * the per-entry links in ascending entry order, so a lookup costs one probe
+ * sequence no matter how often a name or source number repeats.
+ */
+typedef struct {
+    uint32_t hash;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t count;
+} vf_index_group_t;
+
+/* Per entry: its key hash, kept so edits never rehash a string, and the next entry with the same key. */
+typedef struct {
+    uint32_t hash;
+    uint32_t next;
+} vf_index_link_t;
+
+typedef struct {
+    vf_index_group_t *groups;
+    uint32_t          mask;
+    uint32_t          used;
+    vf_index_link_t  *links;
+} vf_index_table_t;
+
+struct vf_index {
+    vf_index_table_t tables[VF_INDEX_TABLES];
+    uint32_t         count;     /* entries covered, always vf->header.entry_count */
+    uint32_t         capacity;  /* entries the link arrays can hold */
+};
+
+static uint32_t vf_index_capacity_for(uint32_t n) {
+    /* Keep the load factor at or below 1/2 so probe chains stay short. */
+    uint64_t cap = VF_INDEX_MIN_CAP;
+    while (cap < (uint64_t) n * 2)
+        cap <<= 1;
+    return cap > 0x80000000u ? 0x80000000u : (uint32_t) cap;
+}
+
+static vf_index_group_t *vf_index_alloc_groups(uint32_t cap) {
+    vf_index_group_t *groups = (vf_index_group_t *) sso_malloc((size_t) cap * sizeof(vf_index_group_t));
+    if (!groups)
+        return NULL;
+    for (uint32_t i = 0; i < cap; ++i)
+        groups[i].head = VF_INDEX_EMPTY;
+    return groups;
+}
+
+/* Stops at the entry string's terminator, so a shorter string is never read past. */
+static inline int vf_string_equals(const char *entry_str, const char *key, size_t len) {
+    if (!entry_str)
+        return 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (entry_str[i] != key[i] || entry_str[i] == '\0')
+            return 0;
+    }
+    return entry_str[len] == '\0';
+}
+
+/* Source numbers are passed around as their 4 raw bytes so every table shares one probe loop. */
+static int vf_index_key_equals(const vf_entry_t *e, int table, const char *key, size_t len) {
+    switch (table) {
+    case VF_INDEX_PATH:
+        return vf_string_equals(e->file_path, key, len);
+    case VF_INDEX_NAME:
+        return vf_string_equals(e->file_name, key, len);
+    default:
+        return memcmp(&e->source_file_number, key, sizeof(uint32_t)) == 0;
+    }
+}
+
+static uint32_t vf_index_hash_source(uint32_t num) {
+    return (uint32_t) sso_hash_mix(num);
+}
+
+/* Key of entry `e` in `table`; 1 if the entry has none. */
+static int vf_index_entry_key(const vf_entry_t *e, int table, const char **key, size_t *len) {
+    switch (table) {
+    case VF_INDEX_PATH:
+        *key = e->file_path;
+        break;
+    case VF_INDEX_NAME:
+        *key = e->file_name;
+        break;
+    default:
+        *key = (const char *) &e->source_file_number;
+        *len = sizeof(uint32_t);
+        return 0;
+    }
+    if (!*key)
+        return 1;
+    *len = strlen(*key);
+    return 0;
+}
+
+static uint32_t vf_index_entry_hash(const vf_entry_t *e, int table, const char *key, size_t len) {
+    return table == VF_INDEX_SOURCE ? vf_index_hash_source(e->source_file_number) : sso_hash32(key, len);
+}
+
+/* Slot holding the key's group, or the empty slot where it would go. */
+static uint32_t vf_index_probe(const vf_file_t *vf, const vf_index_table_t *t, int table, uint32_t hash,
+                               const char *key, size_t len) {
+    uint32_t pos = hash & t->mask;
+    for (;;) {
+        const vf_index_group_t *g = &t->groups[pos];
+        if (g->head == VF_INDEX_EMPTY)
+            return pos;
+        if (g->hash == hash && vf_index_key_equals(&vf->entries[g->head], table, key, len))
+            return pos;
+        pos = (pos + 1) & t->mask;
+    }
+}
+
+/* Groups hold distinct keys, so they move to a larger table by hash alone. */
+static int vf_index_grow_groups(vf_index_table_t *t) {
+    const uint32_t cap = (t->mask + 1) * 2;
+    vf_index_group_t *groups = vf_index_alloc_groups(cap);
+    if (!groups)
+        return 1;
+
+    for (uint32_t i = 0; i <= t->mask; ++i) {
+        const vf_index_group_t *g = &t->groups[i];
+        if (g->head == VF_INDEX_EMPTY)
+            continue;
+        uint32_t pos = g->hash & (cap - 1);
+        while (groups[pos].head != VF_INDEX_EMPTY)
+            pos = (pos + 1) & (cap - 1);
+        groups[pos] = *g;
+    }
+
+    sso_free(t->groups);
+    t->groups = groups;
+    t->mask = cap - 1;
+    return 0;
+}
+
+/* Backward-shift deletion: later members of the probe run move up so no tombstones are needed. */
+static void vf_index_erase_group(vf_index_table_t *t, uint32_t hole) {
+    uint32_t pos = hole;
+    for (;;) {
+        pos = (pos + 1) & t->mask;
+        const vf_index_group_t *g = &t->groups[pos];
+        if (g->head == VF_INDEX_EMPTY)
+            break;
+        const uint32_t home = g->hash & t->mask;
+        if (((pos - home) & t->mask) >= ((pos - hole) & t->mask)) {
+            t->groups[hole] = *g;
+            hole = pos;
+        }
+    }
+    t->groups[hole].head = VF_INDEX_EMPTY;
+    t->used--;
+}
+
+/* Appends entry `index`, which must be the highest indexed so far, to its key's chain. */
+static int vf_index_table_insert(const vf_file_t *vf, vf_index_table_t *t, int table, uint32_t index,
+                                 const uint32_t *known_hash) {
+    const vf_entry_t *e = &vf->entries[index];
+    const char *key;
+    size_t len;
+    if (vf_index_entry_key(e, table, &key, &len)) {
+        t->links[index].hash = 0;
+        t->links[index].next = VF_INDEX_ABSENT;
+        return 0;
+    }
+
+    const uint32_t hash = known_hash ? *known_hash : vf_index_entry_hash(e, table, key, len);
+    uint32_t pos = vf_index_probe(vf, t, table, hash, key, len);
+
+    if (t->groups[pos].head == VF_INDEX_EMPTY && (uint64_t) (t->used + 1) * 2 > (uint64_t) t->mask + 1) {
+        if (vf_index_grow_groups(t))
+            return 1;
+        pos = vf_index_probe(vf, t, table, hash, key, len);
+    }
+
+    t->links[index].hash = hash;
+    t->links[index].next = VF_INDEX_EMPTY;
+
+    vf_index_group_t *g = &t->groups[pos];
+    if (g->head == VF_INDEX_EMPTY) {
+        g->hash = hash;
+        g->head = index;
+        g->tail = index;
+        g->count = 1;
+        t->used++;
+    } else {
+        t->links[g->tail].next = index;
+        g->tail = index;
+        g->count++;
+    }
+    return 0;
+}
+
+/* Unlinks entry `index` from its chain; the entry itself must still be intact. */
+static void vf_index_table_unlink(const vf_file_t *vf, vf_index_table_t *t, int table, uint32_t index) {
+    const vf_index_link_t *link = &t->links[index];
+    if (link->next == VF_INDEX_ABSENT)
+        return;
+
+    const char *key = NULL;
+    size_t len = 0;
+    vf_index_entry_key(&vf->entries[index], table, &key, &len);
+    const uint32_t pos = vf_index_probe(vf, t, table, link->hash, key, len);
+    vf_index_group_t *g = &t->groups[pos];
+    if (g->head == VF_INDEX_EMPTY)
+        return;
+
+    if (g->head == index) {
+        g->head = link->next;
+    } else {
+        uint32_t prev = g->head;
+        while (t->links[prev].next != index)
+            prev = t->links[prev].next;
+        t->links[prev].next = link->next;
+        if (g->tail == index)
+            g->tail = prev;
+    }
+
+    if (--g->count == 0)
+        vf_index_erase_group(t, pos);
+}
+
+/* Closes the gap left by entry `removed`: every stored index above it moves down by one. */
+static void vf_index_table_shift(vf_index_table_t *t, uint32_t removed, uint32_t count) {
+    /* Popping the last entry leaves nothing above it to renumber. */
+    if (removed + 1 == count)
+        return;
+
+    memmove(&t->links[removed], &t->links[removed + 1], (size_t) (count - removed - 1) * sizeof(vf_index_link_t));
+
+    /* Branch-free so the passes vectorise; the two markers sit above every real index and stay put. */
+    for (uint32_t i = 0; i + 1 < count; ++i) {
+        const uint32_t next = t->links[i].next;
+        t->links[i].next = next - (uint32_t) (next > removed && next < VF_INDEX_ABSENT);
+    }
+    for (uint32_t i = 0; i <= t->mask; ++i) {
+        vf_index_group_t *g = &t->groups[i];
+        g->head -= (uint32_t) (g->head > removed && g->head != VF_INDEX_EMPTY);
+        g->tail -= (uint32_t) (g->tail > removed && g->head != VF_INDEX_EMPTY);
+    }
+}
+
+/*
+ * Drops every entry >= `count`. Chains are ascending, so each keeps a prefix;
+ * surviving groups are re-laid into a fresh table of the same size by hash.
+ */
+static int vf_index_table_truncate(vf_index_table_t *t, uint32_t count) {
+    vf_index_group_t *groups = vf_index_alloc_groups(t->mask + 1);
+    if (!groups)
+        return 1;
+
+    uint32_t used = 0;
+    for (uint32_t i = 0; i <= t->mask; ++i) {
+        vf_index_group_t g = t->groups[i];
+        if (g.head == VF_INDEX_EMPTY || g.head >= count)
+            continue;
+
+        g.count = 1;
+        g.tail = g.head;
+        while (t->links[g.tail].next != VF_INDEX_EMPTY && t->links[g.tail].next < count) {
+            g.tail = t->links[g.tail].next;
+            g.count++;
+        }
+        t->links[g.tail].next = VF_INDEX_EMPTY;
+
+        uint32_t pos = g.hash & t->mask;
+        while (groups[pos].head != VF_INDEX_EMPTY)
+            pos = (pos + 1) & t->mask;
+        groups[pos] = g;
+        used++;
+    }
+
+    sso_free(t->groups);
+    t->groups = groups;
+    t->used = used;
+    return 0;
+}
+
+static int vf_index_reserve(struct vf_index *ix, uint32_t n) {
+    if (n <= ix->capacity)
+        return 0;
+
+    uint32_t cap = ix->capacity ? ix->capacity : VF_INDEX_MIN_CAP;
+    while (cap < n)
+        cap = cap > UINT32_MAX / 2 ? n : cap * 2;
+
+    for (int k = 0; k < VF_INDEX_TABLES; ++k) {
+        vf_index_link_t *links =
+            (vf_index_link_t *) sso_realloc(ix->tables[k].links, (size_t) cap * sizeof(vf_index_link_t));
+        if (!links)
+            return 1;
+        ix->tables[k].links = links;
+    }
+    ix->capacity = cap;
+    return 0;
+}
+
+void vf_index_free(struct vf_index *ix) {
+    if (!ix)
+        return;
+    for (int k = 0; k < VF_INDEX_TABLES; ++k) {
+        sso_free(ix->tables[k].groups);
+        sso_free(ix->tables[k].links);
+    }
+    sso_free(ix);
+}
+
+/* An index that cannot follow an edit is dropped; lookups then fall back to scanning. */
+static void vf_index_drop_from(vf_file_t *vf) {
+    vf_index_free(vf->index);
+    vf->index = NULL;
+}
+
+void vf_index_on_insert(vf_file_t *vf, uint32_t index) {
+    struct vf_index *ix = vf->index;
+    if (!ix)
+        return;
+
+    if (vf_index_reserve(ix, index + 1)) {
+        vf_index_drop_from(vf);
+        return;
+    }
+    for (int k = 0; k < VF_INDEX_TABLES; ++k) {
+        if (vf_index_table_insert(vf, &ix->tables[k], k, index, NULL)) {
+            vf_index_drop_from(vf);
+            return;
+        }
+    }
+    ix->count = index + 1;
+}
+
+void vf_index_on_remove(vf_file_t *vf, uint32_t index) {
+    struct vf_index *ix = vf->index;
+    if (!ix)
+        return;
+
+    for (int k = 0; k < VF_INDEX_TABLES; ++k) {
+        vf_index_table_unlink(vf, &ix->tables[k], k, index);
+        vf_index_table_shift(&ix->tables[k], index, ix->count);
+    }
+    ix->count--;
+}
+
+void vf_index_on_truncate(vf_file_t *vf, uint32_t count) {
+    struct vf_index *ix = vf->index;
+    if (!ix || count >= ix->count)
+        return;
+
+    for (int k = 0; k < VF_INDEX_TABLES; ++k) {
+        if (vf_index_table_truncate(&ix->tables[k], count)) {
+            vf_index_drop_from(vf);
+            return;
+        }
+    }
+    ix->count = count;
+}
+
+/*
+ * Rebuilds one table's groups from adopted links. Every present entry must
+ * have at most one predecessor and point forward, so the chains are the
+ * ascending ones a build produces; their heads become the groups, placed by
+ * hash alone as when growing. The table is sized for the keys actually
+ * present and grows on insert as usual. `has_prev` holds n bytes of scratch.
+ */
+static int vf_index_table_relink(vf_index_table_t *t, uint32_t n, uint8_t *has_prev) {
+    memset(has_prev, 0, n);
+    uint32_t heads = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t next = t->links[i].next;
+        if (next == VF_INDEX_ABSENT)
+            continue;
+        if (!has_prev[i])
+            heads++;
+        if (next == VF_INDEX_EMPTY)
+            continue;
+        if (next <= i || next >= n || has_prev[next] || t->links[next].next == VF_INDEX_ABSENT ||
+            t->links[next].hash != t->links[i].hash)
+            return 1;
+        has_prev[next] = 1;
+    }
+
+    const uint32_t cap = vf_index_capacity_for(heads);
+    t->groups = vf_index_alloc_groups(cap);
+    if (!t->groups)
+        return 1;
+    t->mask = cap - 1;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        if (has_prev[i] || t->links[i].next == VF_INDEX_ABSENT)
+            continue;
+
+        vf_index_group_t g;
+        g.hash = t->links[i].hash;
+        g.head = i;
+        g.tail = i;
+        g.count = 1;
+        while (t->links[g.tail].next != VF_INDEX_EMPTY) {
+            g.tail = t->links[g.tail].next;
+            g.count++;
+        }
+
+        uint32_t pos = g.hash & t->mask;
+        while (t->groups[pos].head != VF_INDEX_EMPTY)
+            pos = (pos + 1) & t->mask;
+        t->groups[pos] = g;
+        t->used++;
+    }
+    return 0;
+}
+
+int vf_index_export(const vf_file_t *vf, void **slots, uint32_t *count) {
+    const struct vf_index *ix = vf->index;
+    const uint32_t n = vf->header.entry_count;
+    if (!ix || ix->count != n || (uint64_t) VF_INDEX_TABLES * n > UINT32_MAX)
+        return 1;
+
+    uint8_t *buf = (uint8_t *) sso_malloc((size_t) VF_INDEX_TABLES * n * sizeof(vf_index_link_t));
+    if (!buf)
+        return 1;
+    for (int k = 0; k < VF_INDEX_TABLES; ++k) {
+        if (n)
+            memcpy(buf + (size_t) k * n * sizeof(vf_index_link_t), ix->tables[k].links,
+                   (size_t) n * sizeof(vf_index_link_t));
+    }
+
+    *slots = buf;
+    *count = VF_INDEX_TABLES * n;
+    return 0;
+}
+
+int vf_index_adopt(vf_file_t *vf, const void *slots, uint32_t count) {
+    const uint32_t n = vf->header.entry_count;
+    if ((uint64_t) count != (uint64_t) VF_INDEX_TABLES * n)
+        return 1;
+
+    struct vf_index *ix = (struct vf_index *) sso_calloc(1, sizeof(struct vf_index));
+    uint8_t *has_prev = (uint8_t *) sso_malloc(n);
+    int failed = !ix || !has_prev || vf_index_reserve(ix, n);
+
+    for (int k = 0; k < VF_INDEX_TABLES && !failed; ++k) {
+        vf_index_table_t *t = &ix->tables[k];
+        if (n)
+            memcpy(t->links, (const uint8_t *) slots + (size_t) k * n * sizeof(vf_index_link_t),
+                   (size_t) n * sizeof(vf_index_link_t));
+        failed = vf_index_table_relink(t, n, has_prev);
+    }
+
+    sso_free(has_prev);
+    if (failed) {
+        vf_index_free(ix);
+        return 1;
+    }
+
+    ix->count = n;
+    vf_index_free(vf->index);
+    vf->index = ix;
+    return 0;
+}
+
+static int vf_index_build_tables(vf_file_t *vf, const uint32_t *path_hashes) {
+    const uint32_t n = vf->header.entry_count;
+    struct vf_index *ix = (struct vf_index *) sso_calloc(1, sizeof(struct vf_index));
+    if (!ix)
+        return 1;
+
+    /* Sized for n distinct keys up front, so building never has to grow a table. */
+    const uint32_t cap = vf_index_capacity_for(n);
+    int failed = vf_index_reserve(ix, n);
+    for (int k = 0; k < VF_INDEX_TABLES && !failed; ++k) {
+        ix->tables[k].groups = vf_index_alloc_groups(cap);
+        ix->tables[k].mask = cap - 1;
+        failed = ix->tables[k].groups == NULL;
+    }
+
+    for (uint32_t i = 0; i < n && !failed; ++i) {
+        for (int k = 0; k < VF_INDEX_TABLES && !failed; ++k) {
+            const uint32_t *known = (k == VF_INDEX_PATH && path_hashes) ? &path_hashes[i] : NULL;
+            failed = vf_index_table_insert(vf, &ix->tables[k], k, i, known);
+        }
+    }
+
+    if (failed) {
+        vf_index_free(ix);
+        return 1;
+    }
+
+    ix->count = n;
+    vf_index_free(vf->index);
+    vf->index = ix;
+    return 0;
+}
+
+int vf_index_build_hashed(vf_file_t *vf, const uint32_t *path_hashes) {
+    SSO_STATS_TIME(t);
+    const int rc = vf_index_build_tables(vf, path_hashes);
+    SSO_STATS_TIME_END(t, SSO_STATS_PHASE_INDEX);
+    return rc;
+}
+
+/* Chain of the group matching `key`, copied into out[0..max); returns the group size. */
+static uint32_t vf_index_collect(const vf_file_t *vf, int table, uint32_t hash, const char *key, size_t len,
+                                 uint32_t *out, uint32_t max) {
+    const struct vf_index *ix = vf->index;
+
+    if (!ix) {
+        uint32_t found = 0;
+        for (uint32_t i = 0; i < vf->header.entry_count; ++i) {
+            if (!vf_index_key_equals(&vf->entries[i], table, key, len))
+                continue;
+            if (found < max)
+                out[found] = i;
+            found++;
+        }
+        return found;
+    }
+
+    const vf_index_table_t *t = &ix->tables[table];
+    const vf_index_group_t *g = &t->groups[vf_index_probe(vf, t, table, hash, key, len)];
+    if (g->head == VF_INDEX_EMPTY)
+        return 0;
+
+    uint32_t index = g->head;
+    for (uint32_t i = 0; i < max && index != VF_INDEX_EMPTY; ++i) {
+        out[i] = index;
+        index = t->links[index].next;
+    }
+    return g->count;
+}
+
+/* ================== LOOKUP INDEX ================== */
+
+VF_API int vf_index_build(vf_file_t *vf) {
+    if (!vf || (vf->header.entry_count > 0 && !vf->entries))
+        return 1;
+
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "vf_index_build");
+    const int rc = vf_index_build_hashed(vf, NULL);
+    SSO_STATS_OP_END(op);
+    return rc;
+}
+
+VF_API void vf_index_drop(vf_file_t *vf) {
+    if (!vf)
+        return;
+    vf_index_drop_from(vf);
+}
+
+VF_API int vf_index_find_path(const vf_file_t *vf, const char *path, size_t len, uint32_t *out) {
+    if (!vf || !path || !out)
+        return 1;
+    return vf_index_collect(vf, VF_INDEX_PATH, sso_hash32(path, len), path, len, out, 1) ? 0 : 1;
+}
+
+VF_API uint32_t vf_index_find_name(const vf_file_t *vf, const char *name, size_t len, uint32_t *out, uint32_t max) {
+    if (!vf || !name || (!out && max > 0))
+        return 0;
+    return vf_index_collect(vf, VF_INDEX_NAME, sso_hash32(name, len), name, len, out, max);
+}
+
+VF_API uint32_t vf_index_find_source(const vf_file_t *vf, uint32_t source_file_number, uint32_t *out,
+                                     uint32_t max) {
+    if (!vf || (!out && max > 0))
+        return 0;
+    return vf_index_collect(vf, VF_INDEX_SOURCE, vf_index_hash_source(source_file_number),
+                            (const char *) &source_file_number, sizeof(uint32_t), out, max);
+}
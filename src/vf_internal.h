@@ -0,0 +1,95 @@
+#ifndef VF_INTERNAL_H
+#define VF_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vf.h"
+
+/* Fixed block between file_name and file_path of an on-disk entry. */
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t unknown1[8];
+    uint8_t original_crc[4];
+    uint8_t exported_crc[4];
+    uint8_t unknown2[4];
+    uint32_t file_size;
+    uint8_t unknown4[8];
+    uint32_t source_file_number;
+    uint8_t unknown5[4];
+    uint32_t path_len;
+} vf_entry_fixed_t;
+#pragma pack(pop)
+
+/* Smallest possible encoded entry: name length, fixed block, empty name and path. */
+#define VF_ENTRY_MIN_SIZE (4 + sizeof(vf_entry_fixed_t))
+
+/* Offset table record: where an entry starts inside an in-memory file image. */
+typedef struct {
+    uint32_t entry_pos;
+    uint32_t name_len;
+    uint32_t path_len;
+} vf_slot_t;
+
+/*
+ * Walks the length fields of `n` entries following the header of an image of
+ * `size` (<= UINT32_MAX) bytes and fills `slots`. Nothing is copied.
+ */
+int vf_scan_entries(const uint8_t *data, size_t size, uint32_t n, vf_slot_t *slots);
+
+/* Reads one entry from `r`; heap strings unless `arena` is set. */
+int vf_entry_read_from(sso_reader_t *r, vf_entry_t *e, struct sso_arena *arena);
+
+/* Builds an entry from the bytes a slot points at; heap strings unless `arena` is set. */
+int vf_entry_decode_slot(vf_entry_t *e, const uint8_t *data, const vf_slot_t *s, struct sso_arena *arena);
+
+/* Lookup index maintenance, called by the entry management functions in vf.c. */
+void vf_index_free(struct vf_index *ix);
+void vf_index_on_insert(vf_file_t *vf, uint32_t index);
+void vf_index_on_remove(vf_file_t *vf, uint32_t index);
+void vf_index_on_truncate(vf_file_t *vf, uint32_t count);
+
+/* Builds vf->index, taking path hashes from `path_hashes` (sso_hash32 of each path) when not NULL. */
+int  vf_index_build_hashed(vf_file_t *vf, const uint32_t *path_hashes);
+
+/*
+ * Index tables in their sidecar cache layout: the per-entry {hash, next}
+ * links of the path, name and source tables, `count` uint32 pairs in all.
+ * The group slots follow from the chains, so adopting rebuilds them without
+ * touching a string. Export hands out a copy to release with sso_free.
+ */
+#define VF_INDEX_SLOT_SIZE 8u
+int  vf_index_export(const vf_file_t *vf, void **slots, uint32_t *count);
+int  vf_index_adopt(vf_file_t *vf, const void *slots, uint32_t count);
+
+/* File identity the verification cache trusts a stored CRC for. */
+typedef struct {
+    uint64_t dev;
+    uint64_t ino;
+    uint64_t size;
+    int64_t  mtime_ns;
+    int64_t  ctime_ns;
+} vf_file_stat_t;
+
+/* Timestamp granularity slack: files touched this close to a run are not cached. */
+#define VF_CACHE_RACY_NS 2000000000ll
+
+/* File hashing shared by verification and manifest building (vf_verify.c). */
+
+/* 0 with the identity of a regular file, 1 if there is no such file. */
+int     vf_file_stat(const char *path, vf_file_stat_t *out);
+/* Wall clock in the same epoch and unit as vf_file_stat_t times. */
+int64_t vf_now_ns(void);
+/*
+ * CRC32 of a whole file, through a mapping or buffered reads into `buf`.
+ * The mapped one fails if the file is no longer `size` bytes.
+ */
+int     vf_file_crc_mapped(const char *path, uint64_t size, uint32_t *crc);
+int     vf_file_crc_read(const char *path, uint8_t *buf, size_t buf_size, uint32_t *crc, uint64_t *bytes);
+
+/* 0 and the stored CRC if `path` is cached with exactly this identity. Read-only, safe from workers. */
+int vf_verify_cache_lookup(const vf_verify_cache_t *c, const char *path, const vf_file_stat_t *st, uint32_t *crc);
+int vf_verify_cache_store(vf_verify_cache_t *c, const char *path, const vf_file_stat_t *st, uint32_t crc);
+
+#endif /* VF_INTERNAL_H */
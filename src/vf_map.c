@@ -0,0 +1,193 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "map.h"
+#include "alloc.h"
+#include "stats_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+struct vf_mapped {
+    sso_map_t    map;
+    vf_header_t  header;
+    vf_record_t *records;
+};
+
+static void vf_mapped_discard(vf_mapped_t *vm) {
+    sso_map_close(&vm->map);
+    sso_free(vm->records);
+    sso_free(vm);
+}
+
+/* Single pass: bounds-check every length field and fill the record while the bytes are hot. */
+static int vf_mapped_scan(vf_mapped_t *vm) {
+    const uint32_t n = vm->header.entry_count;
+    if (n == 0)
+        return 0;
+
+    const uint8_t *data = vm->map.data;
+    const size_t size = vm->map.size;
+    if (n > (size - sizeof(vf_header_t)) / (4 + sizeof(vf_entry_fixed_t)))
+        return 1;
+
+    vm->records = (vf_record_t *) sso_malloc((size_t) n * sizeof(vf_record_t));
+    if (!vm->records)
+        return 1;
+
+    size_t pos = sizeof(vf_header_t);
+    for (uint32_t i = 0; i < n; ++i) {
+        vf_record_t *r = &vm->records[i];
+
+        if (size - pos < 4)
+            return 1;
+        memcpy(&r->name_len, data + pos, 4);
+        pos += 4;
+
+        if (size - pos < sizeof(vf_entry_fixed_t) || size - pos - sizeof(vf_entry_fixed_t) < r->name_len)
+            return 1;
+        r->name_pos = (uint32_t) pos;
+        pos += r->name_len;
+
+        vf_entry_fixed_t blk;
+        memcpy(&blk, data + pos, sizeof(blk));
+        pos += sizeof(blk);
+
+        if (size - pos < blk.path_len)
+            return 1;
+        r->path_pos = (uint32_t) pos;
+        r->path_len = blk.path_len;
+        pos += blk.path_len;
+
+        memcpy(r->unknown1, blk.unknown1, 8);
+        memcpy(r->original_crc, blk.original_crc, 4);
+        memcpy(r->exported_crc, blk.exported_crc, 4);
+        memcpy(r->unknown2, blk.unknown2, 4);
+        r->file_size = blk.file_size;
+        memcpy(r->unknown4, blk.unknown4, 8);
+        r->source_file_number = blk.source_file_number;
+        memcpy(r->unknown5, blk.unknown5, 4);
+    }
+
+    return 0;
+}
+
+static vf_mapped_t *vf_mapped_open(const char *filename) {
+    vf_mapped_t *vm = (vf_mapped_t *) sso_calloc(1, sizeof(vf_mapped_t));
+    if (!vm)
+        return NULL;
+
+    if (sso_map_open(filename, 0, &vm->map)) {
+        sso_free(vm);
+        return NULL;
+    }
+
+    /* Record positions are 32-bit; larger manifests have to go through vf_file_read. */
+    if (vm->map.size < sizeof(vf_header_t) || vm->map.size > UINT32_MAX) {
+        vf_mapped_discard(vm);
+        return NULL;
+    }
+
+    memcpy(&vm->header, vm->map.data, sizeof(vf_header_t));
+    SSO_STATS_READ(vm->map.size);
+
+    if (vf_mapped_scan(vm)) {
+        vf_mapped_discard(vm);
+        return NULL;
+    }
+
+    SSO_STATS_ENTRIES(vm->header.entry_count);
+    return vm;
+}
+
+/* ================== MAPPED READER ================== */
+
+VF_API vf_mapped_t *vf_file_open_mapped(const char *filename) {
+    if (!filename)
+        return NULL;
+    SSO_STATS_OP(op);
+    SSO_STATS_OP_BEGIN(op, "vf_file_open_mapped");
+    vf_mapped_t *vm = vf_mapped_open(filename);
+    SSO_STATS_OP_END(op);
+    return vm;
+}
+
+VF_API void vf_mapped_close(vf_mapped_t *vm) {
+    if (!vm)
+        return;
+    vf_mapped_discard(vm);
+}
+
+VF_API const vf_header_t *vf_mapped_header(const vf_mapped_t *vm) {
+    return vm ? &vm->header : NULL;
+}
+
+VF_API uint32_t vf_mapped_entry_count(const vf_mapped_t *vm) {
+    return vm ? vm->header.entry_count : 0;
+}
+
+VF_API const vf_record_t *vf_mapped_records(const vf_mapped_t *vm) {
+    return vm ? vm->records : NULL;
+}
+
+VF_API const char *vf_mapped_data(const vf_mapped_t *vm) {
+    return vm ? (const char *) vm->map.data : NULL;
+}
+
+VF_API const vf_record_t *vf_mapped_record(const vf_mapped_t *vm, uint32_t index) {
+    if (!vm || index >= vm->header.entry_count)
+        return NULL;
+    return &vm->records[index];
+}
+
+VF_API int vf_mapped_get_name(const vf_mapped_t *vm, uint32_t index, vf_view_t *out) {
+    const vf_record_t *r = vf_mapped_record(vm, index);
+    if (!r || !out)
+        return 1;
+    out->data = (const char *) vm->map.data + r->name_pos;
+    out->length = r->name_len;
+    return 0;
+}
+
+VF_API int vf_mapped_get_path(const vf_mapped_t *vm, uint32_t index, vf_view_t *out) {
+    const vf_record_t *r = vf_mapped_record(vm, index);
+    if (!r || !out)
+        return 1;
+    out->data = (const char *) vm->map.data + r->path_pos;
+    out->length = r->path_len;
+    return 0;
+}
+
+VF_API vf_entry_t *vf_mapped_clone_entry(const vf_mapped_t *vm, uint32_t index) {
+    const vf_record_t *r = vf_mapped_record(vm, index);
+    if (!r)
+        return NULL;
+
+    vf_entry_t *e = vf_entry_create();
+    if (!e)
+        return NULL;
+
+    e->file_name = (char *) sso_malloc((size_t) r->name_len + 1);
+    e->file_path = (char *) sso_malloc((size_t) r->path_len + 1);
+    if (!e->file_name || !e->file_path) {
+        vf_entry_free(e);
+        return NULL;
+    }
+    memcpy(e->file_name, vm->map.data + r->name_pos, r->name_len);
+    e->file_name[r->name_len] = '\0';
+    memcpy(e->file_path, vm->map.data + r->path_pos, r->path_len);
+    e->file_path[r->path_len] = '\0';
+
+    memcpy(e->unknown1, r->unknown1, 8);
+    memcpy(e->original_crc, r->original_crc, 4);
+    memcpy(e->exported_crc, r->exported_crc, 4);
+    memcpy(e->unknown2, r->unknown2, 4);
+    e->file_size = r->file_size;
+    memcpy(e->unknown4, r->unknown4, 8);
+    e->source_file_number = r->source_file_number;
+    memcpy(e->unknown5, r->unknown5, 4);
+    return e;
+}
@@ -0,0 +1,95 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "arena.h"
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define VF_READER_DEFAULT_BUFFER (1u << 16)
+
+struct vf_reader {
+    FILE         *f;
+    char         *io_buf;
+    sso_reader_t  in;
+    vf_header_t   header;
+    uint32_t      next;
+    int           failed;
+
+    /* Holds the current entry's strings; reset per entry, so it settles at one block. */
+    sso_arena_t  *strings;
+    vf_entry_t    entry;
+};
+
+static int vf_reader_fail(vf_reader_t *r) {
+    r->failed = 1;
+    return 1;
+}
+
+/* ================== STREAMING READER ================== */
+
+VF_API vf_reader_t *vf_reader_open(const char *filename, size_t buffer_size) {
+    if (!filename)
+        return NULL;
+
+    vf_reader_t *r = (vf_reader_t *) sso_calloc(1, sizeof(vf_reader_t));
+    if (!r)
+        return NULL;
+
+    r->f = fopen(filename, "rb");
+    if (!r->f) {
+        sso_free(r);
+        return NULL;
+    }
+
+    if (buffer_size == 0)
+        buffer_size = VF_READER_DEFAULT_BUFFER;
+    r->io_buf = (char *) sso_malloc(buffer_size);
+    r->strings = sso_arena_create(0);
+    if (!r->io_buf || !r->strings || setvbuf(r->f, r->io_buf, _IOFBF, buffer_size) != 0 ||
+        vf_header_read(r->f, &r->header)) {
+        vf_reader_close(r);
+        return NULL;
+    }
+
+    sso_reader_init_stdio(&r->in, r->f);
+    return r;
+}
+
+VF_API void vf_reader_close(vf_reader_t *r) {
+    if (!r)
+        return;
+    if (r->f)
+        fclose(r->f);
+    sso_free(r->io_buf);
+    sso_arena_destroy(r->strings);
+    sso_free(r);
+}
+
+VF_API const vf_header_t *vf_reader_header(const vf_reader_t *r) {
+    return r ? &r->header : NULL;
+}
+
+VF_API int vf_reader_failed(const vf_reader_t *r) {
+    return r ? r->failed : 1;
+}
+
+VF_API int vf_reader_next(vf_reader_t *r, const vf_entry_t **out) {
+    if (!r || !out)
+        return 1;
+    *out = NULL;
+    if (r->failed || r->next >= r->header.entry_count)
+        return 1;
+
+    sso_arena_reset(r->strings);
+    if (vf_entry_read_from(&r->in, &r->entry, r->strings))
+        return vf_reader_fail(r);
+
+    r->next++;
+    *out = &r->entry;
+    return 0;
+}
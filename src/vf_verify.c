@@ -0,0 +1,347 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "crc32.h"
+#include "map.h"
+#include "pool.h"
+#include "alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define VF_VERIFY_DEFAULT_READ (1u << 20)
+
+/* How an entry's CRC was obtained, for the cache update after the parallel pass. */
+#define VF_CRC_NONE   0
+#define VF_CRC_HASHED 1
+#define VF_CRC_CACHED 2
+
+/* Scratch owned by one pool worker: the joined path and the read buffer. */
+typedef struct {
+    char    *path;
+    size_t   path_cap;
+    uint8_t *buf;
+    uint64_t bytes;
+} vf_verify_worker_t;
+
+typedef struct {
+    const vf_file_t    *vf;
+    const char         *root;
+    size_t              root_len;
+    vf_verify_opts_t    opts;
+    vf_verify_report_t *report;
+    vf_verify_worker_t *workers;
+    vf_file_stat_t     *stats;
+    uint8_t            *crc_source;
+} vf_verify_job_t;
+
+static uint32_t vf_crc_field(const uint8_t crc[4]) {
+    return (uint32_t) crc[0] | ((uint32_t) crc[1] << 8) | ((uint32_t) crc[2] << 16) | ((uint32_t) crc[3] << 24);
+}
+
+/* root + '/' + file_path, with manifest backslashes turned into the native separator. */
+static const char *vf_verify_join(vf_verify_worker_t *w, const char *root, size_t root_len, const char *file_path) {
+    while (*file_path == '/' || *file_path == '\\')
+        file_path++;
+
+    const size_t path_len = strlen(file_path);
+    const size_t need = root_len + 1 + path_len + 1;
+    if (need > w->path_cap) {
+        char *p = (char *) sso_realloc(w->path, need);
+        if (!p)
+            return NULL;
+        w->path = p;
+        w->path_cap = need;
+    }
+
+    size_t pos = 0;
+    if (root_len) {
+        memcpy(w->path, root, root_len);
+        pos = root_len;
+        if (root[root_len - 1] != '/' && root[root_len - 1] != '\\')
+            w->path[pos++] = '/';
+    }
+    for (size_t i = 0; i < path_len; ++i) {
+#ifdef _WIN32
+        w->path[pos++] = file_path[i] == '/' ? '\\' : file_path[i];
+#else
+        w->path[pos++] = file_path[i] == '\\' ? '/' : file_path[i];
+#endif
+    }
+    w->path[pos] = '\0';
+    return w->path;
+}
+
+/* ================== FILE HASHING ================== */
+
+int vf_file_stat(const char *path, vf_file_stat_t *out) {
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(path, &st) || !(st.st_mode & _S_IFREG))
+        return 1;
+    out->mtime_ns = (int64_t) st.st_mtime * 1000000000;
+    out->ctime_ns = (int64_t) st.st_ctime * 1000000000;
+#else
+    struct stat st;
+    if (stat(path, &st) || !S_ISREG(st.st_mode))
+        return 1;
+    out->mtime_ns = (int64_t) st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    out->ctime_ns = (int64_t) st.st_ctim.tv_sec * 1000000000 + st.st_ctim.tv_nsec;
+#endif
+    out->dev = (uint64_t) st.st_dev;
+    out->ino = (uint64_t) st.st_ino;
+    out->size = (uint64_t) st.st_size;
+    return 0;
+}
+
+int64_t vf_now_ns(void) {
+#ifdef _WIN32
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    const int64_t ticks = (int64_t) (((uint64_t) ft.dwHighDateTime << 32) | ft.dwLowDateTime);
+    return (ticks - 116444736000000000ll) * 100;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+int vf_file_crc_mapped(const char *path, uint64_t size, uint32_t *crc) {
+    if (size == 0) {
+        *crc = 0;
+        return 0;
+    }
+    sso_map_t map;
+    if (sso_map_open(path, 0, &map))
+        return 1;
+    /* A file that changed size since it was stat'ed would get a CRC that no longer fits its size. */
+    const int changed = map.size != size;
+    if (!changed)
+        *crc = sso_crc32(0, map.data, map.size);
+    sso_map_close(&map);
+    return changed;
+}
+
+int vf_file_crc_read(const char *path, uint8_t *buf, size_t buf_size, uint32_t *crc, uint64_t *bytes) {
+    uint32_t c = 0;
+    uint64_t total = 0;
+
+#ifdef _WIN32
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return 1;
+    setvbuf(f, NULL, _IONBF, 0);
+    for (;;) {
+        const size_t got = fread(buf, 1, buf_size, f);
+        c = sso_crc32(c, buf, got);
+        total += got;
+        if (got < buf_size)
+            break;
+    }
+    const int failed = ferror(f);
+    fclose(f);
+    if (failed)
+        return 1;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 1;
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    for (;;) {
+        const ssize_t got = read(fd, buf, buf_size);
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            return 1;
+        }
+        if (got == 0)
+            break;
+        c = sso_crc32(c, buf, (size_t) got);
+        total += (uint64_t) got;
+    }
+    close(fd);
+#endif
+
+    *crc = c;
+    *bytes = total;
+    return 0;
+}
+
+/* ================== ENTRY CHECKS ================== */
+
+static uint8_t vf_verify_entry(vf_verify_job_t *job, vf_verify_worker_t *w, uint32_t i) {
+    const vf_entry_t *e = &job->vf->entries[i];
+    if (!e->file_path)
+        return VF_VERIFY_MISSING;
+
+    const char *path = vf_verify_join(w, job->root, job->root_len, e->file_path);
+    if (!path)
+        return VF_VERIFY_READ_ERROR;
+
+    vf_file_stat_t *st = &job->stats[i];
+    if (vf_file_stat(path, st))
+        return VF_VERIFY_MISSING;
+    const uint64_t size = st->size;
+    if (size != e->file_size)
+        return VF_VERIFY_SIZE_MISMATCH;
+    if (job->opts.crc == VF_VERIFY_CRC_NONE)
+        return VF_VERIFY_OK;
+
+    uint32_t crc;
+    if (job->opts.cache && vf_verify_cache_lookup(job->opts.cache, path, st, &crc) == 0) {
+        job->crc_source[i] = VF_CRC_CACHED;
+    } else if (job->opts.use_mmap) {
+        if (vf_file_crc_mapped(path, size, &crc))
+            return VF_VERIFY_READ_ERROR;
+        w->bytes += size;
+    } else {
+        if (!w->buf && !(w->buf = (uint8_t *) sso_malloc(job->opts.read_size)))
+            return VF_VERIFY_READ_ERROR;
+        uint64_t got;
+        if (vf_file_crc_read(path, w->buf, job->opts.read_size, &crc, &got))
+            return VF_VERIFY_READ_ERROR;
+        w->bytes += got;
+    }
+    if (job->crc_source[i] == VF_CRC_NONE)
+        job->crc_source[i] = VF_CRC_HASHED;
+    job->report->crc[i] = crc;
+
+    const uint32_t original = vf_crc_field(e->original_crc);
+    const uint32_t exported = vf_crc_field(e->exported_crc);
+    switch (job->opts.crc) {
+    case VF_VERIFY_CRC_EXPORTED:
+        return crc == exported ? VF_VERIFY_OK : VF_VERIFY_CRC_MISMATCH;
+    case VF_VERIFY_CRC_EITHER:
+        return crc == original || crc == exported ? VF_VERIFY_OK : VF_VERIFY_CRC_MISMATCH;
+    default:
+        return crc == original ? VF_VERIFY_OK : VF_VERIFY_CRC_MISMATCH;
+    }
+}
+
+static void vf_verify_range(void *ctx, size_t begin, size_t end, unsigned worker) {
+    vf_verify_job_t *job = (vf_verify_job_t *) ctx;
+    vf_verify_worker_t *w = &job->workers[worker];
+
+    for (size_t i = begin; i < end; ++i)
+        job->report->status[i] = vf_verify_entry(job, w, (uint32_t) i);
+}
+
+/* ================== VERIFICATION ================== */
+
+VF_API int vf_verify_tree(const vf_file_t *vf, const char *root_dir, const vf_verify_opts_t *opts,
+                          vf_verify_report_t *report) {
+    if (!vf || !report)
+        return 1;
+    memset(report, 0, sizeof(*report));
+
+    const uint32_t n = vf->header.entry_count;
+    if (n > 0 && !vf->entries)
+        return 1;
+
+    vf_verify_job_t job;
+    memset(&job, 0, sizeof(job));
+    if (opts)
+        job.opts = *opts;
+    if (job.opts.read_size == 0)
+        job.opts.read_size = VF_VERIFY_DEFAULT_READ;
+    job.vf = vf;
+    job.root = root_dir ? root_dir : "";
+    job.root_len = strlen(job.root);
+    job.report = report;
+
+    report->count = n;
+    if (n == 0)
+        return 0;
+
+    report->status = (uint8_t *) sso_calloc(n, sizeof(uint8_t));
+    report->crc = (uint32_t *) sso_calloc(n, sizeof(uint32_t));
+    job.stats = (vf_file_stat_t *) sso_calloc(n, sizeof(vf_file_stat_t));
+    job.crc_source = (uint8_t *) sso_calloc(n, sizeof(uint8_t));
+
+    /* Files vary from bytes to gigabytes, so workers claim one entry at a time. */
+    const unsigned threads = sso_pool_threads(job.opts.nthreads, n, 1);
+    job.workers = (vf_verify_worker_t *) sso_calloc(threads, sizeof(vf_verify_worker_t));
+    if (!report->status || !report->crc || !job.stats || !job.crc_source || !job.workers) {
+        sso_free(job.workers);
+        sso_free(job.stats);
+        sso_free(job.crc_source);
+        vf_verify_report_free(report);
+        return 1;
+    }
+
+    const int64_t start_ns = vf_now_ns();
+    /* The CRC tables and kernel choice are set up lazily; do it here, not racing in every worker. */
+    sso_crc32_active_kernel();
+    sso_parallel_for(threads, n, 1, vf_verify_range, &job);
+
+    /*
+     * Workers only read the cache; new CRCs are recorded here. A file changed
+     * within the timestamp granularity of this run could still change without
+     * its mtime moving, so it stays uncached and is hashed again next time.
+     */
+    for (uint32_t i = 0; i < n; ++i) {
+        if (job.crc_source[i] == VF_CRC_CACHED) {
+            report->cache_hits++;
+            continue;
+        }
+        if (!job.opts.cache || job.crc_source[i] != VF_CRC_HASHED)
+            continue;
+        const vf_file_stat_t *st = &job.stats[i];
+        if (st->mtime_ns >= start_ns - VF_CACHE_RACY_NS || st->ctime_ns >= start_ns - VF_CACHE_RACY_NS)
+            continue;
+        const char *path = vf_verify_join(&job.workers[0], job.root, job.root_len, vf->entries[i].file_path);
+        if (path)
+            vf_verify_cache_store(job.opts.cache, path, st, report->crc[i]);
+    }
+
+    for (unsigned t = 0; t < threads; ++t) {
+        report->bytes_hashed += job.workers[t].bytes;
+        sso_free(job.workers[t].path);
+        sso_free(job.workers[t].buf);
+    }
+    sso_free(job.workers);
+    sso_free(job.stats);
+    sso_free(job.crc_source);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        switch (report->status[i]) {
+        case VF_VERIFY_OK:            report->ok++; break;
+        case VF_VERIFY_MISSING:       report->missing++; break;
+        case VF_VERIFY_SIZE_MISMATCH: report->size_mismatch++; break;
+        case VF_VERIFY_CRC_MISMATCH:  report->crc_mismatch++; break;
+        default:                      report->read_errors++; break;
+        }
+    }
+    return 0;
+}
+
+VF_API void vf_verify_report_free(vf_verify_report_t *report) {
+    if (!report)
+        return;
+    sso_free(report->status);
+    sso_free(report->crc);
+    memset(report, 0, sizeof(*report));
+}
@@ -0,0 +1,315 @@
+#define VF_BUILD_DLL
+#define SSO_BUILD_DLL
+#include "vf.h"
+#include "vf_internal.h"
+#include "hash.h"
+#include "write.h"
+#include "alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================== INTERNAL HELPERS ================== */
+
+#define VF_VCACHE_VERSION 1u
+#define VF_VCACHE_EMPTY   UINT32_MAX
+#define VF_VCACHE_MIN_CAP 64u
+
+typedef struct {
+    vf_file_stat_t st;
+    uint64_t       hash;
+    uint32_t       path_pos;
+    uint32_t       path_len;
+    uint32_t       crc;
+} vf_vcache_rec_t;
+
+struct vf_verify_cache {
+    char            *filename;
+    vf_vcache_rec_t *recs;
+    uint32_t         count;
+    uint32_t         cap;
+    char            *paths;
+    size_t           paths_len;
+    size_t           paths_cap;
+    uint32_t        *table;
+    uint32_t         mask;
+};
+
+#pragma pack(push, 1)
+typedef struct {
+    char     magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t payload_hash;
+} vf_vcache_header_t;
+
+/* On-disk record; the path bytes follow it directly. */
+typedef struct {
+    uint64_t dev;
+    uint64_t ino;
+    uint64_t size;
+    int64_t  mtime_ns;
+    int64_t  ctime_ns;
+    uint32_t crc;
+    uint32_t path_len;
+} vf_vcache_disk_t;
+#pragma pack(pop)
+
+static const char vf_vcache_magic[4] = { 'S', 'S', 'O', 'V' };
+
+static int vf_vcache_rehash(vf_verify_cache_t *c, uint32_t cap) {
+    uint32_t *table = (uint32_t *) sso_malloc((size_t) cap * sizeof(uint32_t));
+    if (!table)
+        return 1;
+    for (uint32_t i = 0; i < cap; ++i)
+        table[i] = VF_VCACHE_EMPTY;
+
+    for (uint32_t r = 0; r < c->count; ++r) {
+        uint32_t pos = (uint32_t) c->recs[r].hash & (cap - 1);
+        while (table[pos] != VF_VCACHE_EMPTY)
+            pos = (pos + 1) & (cap - 1);
+        table[pos] = r;
+    }
+
+    sso_free(c->table);
+    c->table = table;
+    c->mask = cap - 1;
+    return 0;
+}
+
+/* Slot holding `path`, or the empty slot where it would go. */
+static uint32_t vf_vcache_probe(const vf_verify_cache_t *c, const char *path, size_t len, uint64_t hash) {
+    uint32_t pos = (uint32_t) hash & c->mask;
+    for (;;) {
+        const uint32_t r = c->table[pos];
+        if (r == VF_VCACHE_EMPTY)
+            return pos;
+        const vf_vcache_rec_t *rec = &c->recs[r];
+        if (rec->hash == hash && rec->path_len == len && memcmp(c->paths + rec->path_pos, path, len) == 0)
+            return pos;
+        pos = (pos + 1) & c->mask;
+    }
+}
+
+static int vf_vcache_append(vf_verify_cache_t *c, const char *path, size_t len, uint64_t hash,
+                            const vf_file_stat_t *st, uint32_t crc) {
+    if (len > UINT32_MAX || c->count == UINT32_MAX - 1)
+        return 1;
+
+    if (c->count == c->cap) {
+        const uint32_t cap = c->cap ? c->cap * 2 : VF_VCACHE_MIN_CAP;
+        vf_vcache_rec_t *recs = (vf_vcache_rec_t *) sso_realloc(c->recs, (size_t) cap * sizeof(vf_vcache_rec_t));
+        if (!recs)
+            return 1;
+        c->recs = recs;
+        c->cap = cap;
+    }
+    if (c->paths_len + len > c->paths_cap) {
+        size_t cap = c->paths_cap ? c->paths_cap : 4096;
+        while (cap < c->paths_len + len)
+            cap *= 2;
+        char *paths = (char *) sso_realloc(c->paths, cap);
+        if (!paths)
+            return 1;
+        c->paths = paths;
+        c->paths_cap = cap;
+    }
+    if ((uint64_t) (c->count + 1) * 2 > (uint64_t) c->mask + 1 &&
+        vf_vcache_rehash(c, (c->mask + 1) * 2))
+        return 1;
+
+    vf_vcache_rec_t *rec = &c->recs[c->count];
+    rec->st = *st;
+    rec->hash = hash;
+    rec->path_pos = (uint32_t) c->paths_len;
+    rec->path_len = (uint32_t) len;
+    rec->crc = crc;
+    memcpy(c->paths + c->paths_len, path, len);
+    c->paths_len += len;
+
+    c->table[vf_vcache_probe(c, path, len, hash)] = c->count;
+    c->count++;
+    return 0;
+}
+
+static int vf_vcache_load(vf_verify_cache_t *c, const uint8_t *data, size_t size) {
+    if (size < sizeof(vf_vcache_header_t))
+        return 1;
+
+    vf_vcache_header_t h;
+    memcpy(&h, data, sizeof(h));
+    if (memcmp(h.magic, vf_vcache_magic, 4) != 0 || h.version != VF_VCACHE_VERSION)
+        return 1;
+
+    const uint8_t *p = data + sizeof(h);
+    size_t left = size - sizeof(h);
+    if (sso_hash_bytes(p, left) != h.payload_hash)
+        return 1;
+
+    for (uint32_t i = 0; i < h.count; ++i) {
+        vf_vcache_disk_t d;
+        if (left < sizeof(d))
+            return 1;
+        memcpy(&d, p, sizeof(d));
+        p += sizeof(d);
+        left -= sizeof(d);
+        if (left < d.path_len)
+            return 1;
+
+        vf_file_stat_t st;
+        st.dev = d.dev;
+        st.ino = d.ino;
+        st.size = d.size;
+        st.mtime_ns = d.mtime_ns;
+        st.ctime_ns = d.ctime_ns;
+
+        const char *path = (const char *) p;
+        const uint64_t hash = sso_hash_bytes(path, d.path_len);
+        if (c->table[vf_vcache_probe(c, path, d.path_len, hash)] == VF_VCACHE_EMPTY &&
+            vf_vcache_append(c, path, d.path_len, hash, &st, d.crc))
+            return 1;
+        p += d.path_len;
+        left -= d.path_len;
+    }
+    return left == 0 ? 0 : 1;
+}
+
+static void vf_vcache_clear(vf_verify_cache_t *c) {
+    c->count = 0;
+    c->paths_len = 0;
+    for (uint32_t i = 0; i <= c->mask; ++i)
+        c->table[i] = VF_VCACHE_EMPTY;
+}
+
+static uint8_t *vf_vcache_read_file(const char *filename, size_t *size) {
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return NULL;
+
+    uint8_t *buf = NULL;
+    long len = -1;
+    if (fseek(f, 0, SEEK_END) == 0)
+        len = ftell(f);
+    if (len > 0 && fseek(f, 0, SEEK_SET) == 0)
+        buf = (uint8_t *) sso_malloc((size_t) len);
+    if (buf && io_read_exact(f, buf, (size_t) len)) {
+        sso_free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+
+    *size = buf ? (size_t) len : 0;
+    return buf;
+}
+
+/* ================== INTERNAL API ================== */
+
+int vf_verify_cache_lookup(const vf_verify_cache_t *c, const char *path, const vf_file_stat_t *st, uint32_t *crc) {
+    const size_t len = strlen(path);
+    const uint32_t r = c->table[vf_vcache_probe(c, path, len, sso_hash_bytes(path, len))];
+    if (r == VF_VCACHE_EMPTY)
+        return 1;
+
+    const vf_file_stat_t *old = &c->recs[r].st;
+    if (old->dev != st->dev || old->ino != st->ino || old->size != st->size ||
+        old->mtime_ns != st->mtime_ns || old->ctime_ns != st->ctime_ns)
+        return 1;
+
+    *crc = c->recs[r].crc;
+    return 0;
+}
+
+int vf_verify_cache_store(vf_verify_cache_t *c, const char *path, const vf_file_stat_t *st, uint32_t crc) {
+    const size_t len = strlen(path);
+    const uint64_t hash = sso_hash_bytes(path, len);
+    const uint32_t r = c->table[vf_vcache_probe(c, path, len, hash)];
+    if (r == VF_VCACHE_EMPTY)
+        return vf_vcache_append(c, path, len, hash, st, crc);
+
+    c->recs[r].st = *st;
+    c->recs[r].crc = crc;
+    return 0;
+}
+
+/* ================== VERIFICATION CACHE ================== */
+
+VF_API vf_verify_cache_t *vf_verify_cache_open(const char *filename) {
+    if (!filename)
+        return NULL;
+
+    vf_verify_cache_t *c = (vf_verify_cache_t *) sso_calloc(1, sizeof(vf_verify_cache_t));
+    if (!c)
+        return NULL;
+
+    const size_t name_len = strlen(filename);
+    c->filename = (char *) sso_malloc(name_len + 1);
+    if (!c->filename || vf_vcache_rehash(c, VF_VCACHE_MIN_CAP)) {
+        vf_verify_cache_close(c);
+        return NULL;
+    }
+    memcpy(c->filename, filename, name_len + 1);
+
+    /* A missing or damaged cache just means every file is hashed once more. */
+    size_t size;
+    uint8_t *data = vf_vcache_read_file(filename, &size);
+    if (data && vf_vcache_load(c, data, size))
+        vf_vcache_clear(c);
+    sso_free(data);
+
+    return c;
+}
+
+VF_API int vf_verify_cache_save(const vf_verify_cache_t *c) {
+    if (!c)
+        return 1;
+
+    const size_t size = sizeof(vf_vcache_header_t) + (size_t) c->count * sizeof(vf_vcache_disk_t) + c->paths_len;
+    uint8_t *buf = (uint8_t *) sso_malloc(size);
+    if (!buf)
+        return 1;
+
+    uint8_t *p = buf + sizeof(vf_vcache_header_t);
+    for (uint32_t i = 0; i < c->count; ++i) {
+        const vf_vcache_rec_t *rec = &c->recs[i];
+        vf_vcache_disk_t d;
+        d.dev = rec->st.dev;
+        d.ino = rec->st.ino;
+        d.size = rec->st.size;
+        d.mtime_ns = rec->st.mtime_ns;
+        d.ctime_ns = rec->st.ctime_ns;
+        d.crc = rec->crc;
+        d.path_len = rec->path_len;
+        memcpy(p, &d, sizeof(d));
+        p += sizeof(d);
+        memcpy(p, c->paths + rec->path_pos, rec->path_len);
+        p += rec->path_len;
+    }
+
+    vf_vcache_header_t h;
+    memcpy(h.magic, vf_vcache_magic, 4);
+    h.version = VF_VCACHE_VERSION;
+    h.count = c->count;
+    h.reserved = 0;
+    h.payload_hash = sso_hash_bytes(buf + sizeof(h), size - sizeof(h));
+    memcpy(buf, &h, sizeof(h));
+
+    const int rc = sso_write_atomic(c->filename, buf, size, 0);
+    sso_free(buf);
+    return rc;
+}
+
+VF_API uint32_t vf_verify_cache_count(const vf_verify_cache_t *c) {
+    return c ? c->count : 0;
+}
+
+VF_API void vf_verify_cache_close(vf_verify_cache_t *c) {
+    if (!c)
+        return;
+    sso_free(c->filename);
+    sso_free(c->recs);
+    sso_free(c->paths);
+    sso_free(c->table);
+    sso_free(c);
+}
@@ -0,0 +1,149 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#define SSO_BUILD_DLL
+#include "write.h"
+#include "alloc.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SSO_TMP_ATTEMPTS 16
+
+#ifdef _WIN32
+
+int sso_write_atomic(const char *filename, const void *data, size_t size, unsigned flags) {
+    if (!filename || (!data && size))
+        return 1;
+
+    const size_t name_len = strlen(filename);
+    char *tmp = (char *) sso_malloc(name_len + 32);
+    if (!tmp)
+        return 1;
+
+    static volatile LONG counter;
+    HANDLE h = INVALID_HANDLE_VALUE;
+    for (int attempt = 0; attempt < SSO_TMP_ATTEMPTS && h == INVALID_HANDLE_VALUE; ++attempt) {
+        snprintf(tmp, name_len + 32, "%s.%lu.%ld.tmp", filename,
+                 (unsigned long) GetCurrentProcessId(), (long) InterlockedIncrement(&counter));
+        h = CreateFileA(tmp, GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (h == INVALID_HANDLE_VALUE && GetLastError() != ERROR_FILE_EXISTS) {
+            sso_free(tmp);
+            return 1;
+        }
+    }
+    if (h == INVALID_HANDLE_VALUE) {
+        sso_free(tmp);
+        return 1;
+    }
+
+    const uint8_t *p = (const uint8_t *) data;
+    size_t left = size;
+    while (left > 0) {
+        DWORD chunk = left > 0x40000000u ? 0x40000000u : (DWORD) left;
+        DWORD written = 0;
+        if (!WriteFile(h, p, chunk, &written, NULL) || written == 0) {
+            CloseHandle(h);
+            DeleteFileA(tmp);
+            sso_free(tmp);
+            return 1;
+        }
+        p += written;
+        left -= written;
+    }
+
+    /* The data must be on disk before the rename, or a crash can leave an empty file in place. */
+    if ((flags & SSO_WRITE_SYNC) && !FlushFileBuffers(h)) {
+        CloseHandle(h);
+        DeleteFileA(tmp);
+        sso_free(tmp);
+        return 1;
+    }
+    CloseHandle(h);
+
+    if (!MoveFileExA(tmp, filename, MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileA(tmp);
+        sso_free(tmp);
+        return 1;
+    }
+
+    sso_free(tmp);
+    return 0;
+}
+
+#else
+
+int sso_write_atomic(const char *filename, const void *data, size_t size, unsigned flags) {
+    if (!filename || (!data && size))
+        return 1;
+
+    const size_t name_len = strlen(filename);
+    char *tmp = (char *) sso_malloc(name_len + 32);
+    if (!tmp)
+        return 1;
+
+    /* O_EXCL with a per-process counter instead of mkstemp keeps the umask-derived mode for new files. */
+    static volatile unsigned counter;
+    int fd = -1;
+    for (int attempt = 0; attempt < SSO_TMP_ATTEMPTS && fd < 0; ++attempt) {
+        snprintf(tmp, name_len + 32, "%s.%ld.%u.tmp", filename, (long) getpid(), counter++);
+        fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, 0666);
+        if (fd < 0 && errno != EEXIST) {
+            sso_free(tmp);
+            return 1;
+        }
+    }
+    if (fd < 0) {
+        sso_free(tmp);
+        return 1;
+    }
+
+    const char *p = (const char *) data;
+    size_t left = size;
+    while (left > 0) {
+        ssize_t written = write(fd, p, left);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0) {
+            close(fd);
+            unlink(tmp);
+            sso_free(tmp);
+            return 1;
+        }
+        p += written;
+        left -= (size_t) written;
+    }
+
+    /* A replaced file keeps its permission bits rather than the umask default. */
+    struct stat st;
+    int failed = stat(filename, &st) == 0 && fchmod(fd, st.st_mode & 07777) != 0;
+
+    /* The data must be on disk before the rename, or a crash can leave an empty file in place. */
+    while (!failed && (flags & SSO_WRITE_SYNC) && fsync(fd) != 0) {
+        if (errno != EINTR)
+            failed = 1;
+    }
+
+    if (close(fd) || failed || rename(tmp, filename)) {
+        unlink(tmp);
+        sso_free(tmp);
+        return 1;
+    }
+
+    sso_free(tmp);
+    return 0;
+}
+
+#endif
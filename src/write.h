@@ -0,0 +1,19 @@
+#ifndef SSO_WRITE_H
+#define SSO_WRITE_H
+
+#include <stddef.h>
+
+/*
+ * Writes `size` bytes to a temporary file next to `filename` and renames it
+ * over the destination, so readers only ever see the old or the new file.
+ * An existing destination keeps its permission bits.
+ *
+ * With SSO_WRITE_SYNC the data is flushed to disk before the rename, so a
+ * crash cannot leave an empty file in place. Rebuildable caches leave it out
+ * and skip the flush.
+ */
+#define SSO_WRITE_SYNC 0x1u
+
+int sso_write_atomic(const char *filename, const void *data, size_t size, unsigned flags);
+
+#endif /* SSO_WRITE_H */
@@ -0,0 +1,28 @@
+#ifndef SSO_TEST_H
+#define SSO_TEST_H
+
+#include <stdio.h>
+
+/*
+ * Minimal check helpers for the behaviour tests. Each test is one program
+ * that keeps going after a failed check and exits nonzero if any failed;
+ * ctest runs it from the build directory, where it may create scratch files.
+ */
+
+static int test_failures;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                        \
+        }                                                                           \
+    } while (0)
+
+static inline int test_result(void) {
+    if (test_failures)
+        fprintf(stderr, "%d check(s) failed\n", test_failures);
+    return test_failures != 0;
+}
+
+#endif /* SSO_TEST_H */
@@ -0,0 +1,266 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "text.h"
+#include "vf.h"
+#include "test.h"
+#include "test_fs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TEXT_FILE    "cache_text.text"
+#define TEXT_SIDECAR "cache_text.text.ssoidx"
+#define VF_FILE      "cache_vf.ccx"
+#define VF_SIDECAR   "cache_vf.ccx.ssoidx"
+#define ENTRIES      2000u
+
+static uint8_t *read_all(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return NULL;
+    uint8_t *buf = NULL;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        const long n = ftell(f);
+        if (n >= 0 && fseek(f, 0, SEEK_SET) == 0 && (buf = (uint8_t *) malloc((size_t) n + 1)) != NULL) {
+            if (fread(buf, 1, (size_t) n, f) != (size_t) n) {
+                free(buf);
+                buf = NULL;
+            } else {
+                *size = (size_t) n;
+            }
+        }
+    }
+    fclose(f);
+    return buf;
+}
+
+static int file_equals(const char *path, const uint8_t *data, size_t size) {
+    size_t n = 0;
+    uint8_t *buf = read_all(path, &n);
+    const int same = buf && n == size && memcmp(buf, data, size) == 0;
+    free(buf);
+    return same;
+}
+
+/* The corruptions every sidecar goes through: flipped bytes across header and payload, then cuts. */
+typedef void (*corrupt_check_fn)(const char *label);
+
+static void corrupt_each(const char *sidecar, const uint8_t *good, size_t size, corrupt_check_fn check) {
+    uint8_t *bad = (uint8_t *) malloc(size);
+    CHECK(bad != NULL);
+    if (!bad)
+        return;
+
+    const size_t flips[] = { 0, 4, 8, 12, 16, 24, 32, 40, 48, 56, 60, 64, size / 2, size - 1 };
+    for (size_t k = 0; k < sizeof(flips) / sizeof(flips[0]); ++k) {
+        if (flips[k] >= size)
+            continue;
+        memcpy(bad, good, size);
+        bad[flips[k]] ^= 0x10;
+        CHECK(test_write_file(sidecar, bad, size) == 0);
+        check("flip");
+        CHECK(file_equals(sidecar, good, size));
+    }
+
+    const size_t cuts[] = { 0, 10, 63, 64, size - 1 };
+    for (size_t k = 0; k < sizeof(cuts) / sizeof(cuts[0]); ++k) {
+        CHECK(test_write_file(sidecar, good, cuts[k]) == 0);
+        check("cut");
+        CHECK(file_equals(sidecar, good, size));
+    }
+
+    /* A valid sidecar grown by a byte no longer tiles its records. */
+    uint8_t *longer = (uint8_t *) realloc(bad, size + 1);
+    if (longer) {
+        memcpy(longer, good, size);
+        longer[size] = 0;
+        CHECK(test_write_file(sidecar, longer, size + 1) == 0);
+        check("grow");
+        CHECK(file_equals(sidecar, good, size));
+        bad = longer;
+    }
+    free(bad);
+}
+
+/* ================== TEXT ================== */
+
+static text_file_t *text_expected;
+
+static void text_write_source(uint32_t seed) {
+    text_file_t *tf = text_file_create();
+    for (uint32_t i = 0; tf && i < ENTRIES; ++i) {
+        text_entry_t *e = text_entry_create();
+        if (!e)
+            break;
+        char key[32], value[48];
+        snprintf(key, sizeof(key), "key_%05u", i);
+        snprintf(value, sizeof(value), "v%u_%u", seed, i * 2654435761u);
+        text_entry_set_key(e, key);
+        text_entry_set_value_utf8(e, value, strlen(value));
+        text_file_add_entry(tf, e);
+        text_entry_free(e);
+    }
+    CHECK(tf != NULL && text_file_write(TEXT_FILE, tf) == 0);
+    text_file_free(tf);
+    text_file_free(text_expected);
+    text_expected = text_file_read(TEXT_FILE);
+    CHECK(text_expected != NULL);
+}
+
+static int text_matches(text_file_t *tf) {
+    if (!tf || !text_expected || text_file_entry_count(tf) != text_file_entry_count(text_expected))
+        return 0;
+    for (uint32_t i = 0; i < text_file_entry_count(tf); ++i) {
+        const text_entry_t *a = text_file_get_entry(tf, i), *b = text_file_get_entry(text_expected, i);
+        if (strcmp(a->key, b->key) || a->value_length != b->value_length || memcmp(a->value, b->value, a->value_length))
+            return 0;
+        uint32_t at = UINT32_MAX;
+        if (text_file_find_index(tf, a->key, strlen(a->key), &at) || at != i)
+            return 0;
+    }
+    uint32_t at = 0;
+    return text_file_find_index(tf, "missing", 7, &at) != 0;
+}
+
+static int text_mapped_matches(text_mapped_t *tm) {
+    if (!tm || !text_expected || text_mapped_entry_count(tm) != text_file_entry_count(text_expected))
+        return 0;
+    for (uint32_t i = 0; i < text_mapped_entry_count(tm); ++i) {
+        const text_entry_t *b = text_file_get_entry(text_expected, i);
+        text_view_t key, value;
+        if (text_mapped_get_key(tm, i, &key) || text_mapped_get_value(tm, i, &value))
+            return 0;
+        if (key.length != strlen(b->key) || memcmp(key.data, b->key, key.length) ||
+            value.length != b->value_length || memcmp(value.data, b->value, value.length))
+            return 0;
+    }
+    return 1;
+}
+
+static void text_check(const char *label) {
+    text_file_t *tf = text_file_read_cached(TEXT_FILE);
+    if (!text_matches(tf))
+        fprintf(stderr, "text sidecar: %s\n", label);
+    CHECK(text_matches(tf));
+    text_file_free(tf);
+}
+
+static void text_mapped_check(const char *label) {
+    text_mapped_t *tm = text_file_open_mapped_cached(TEXT_FILE);
+    if (!text_mapped_matches(tm))
+        fprintf(stderr, "text mapped sidecar: %s\n", label);
+    CHECK(text_mapped_matches(tm));
+    text_mapped_close(tm);
+}
+
+/* The mapped reader rebuilds a sidecar without the key table; the next full read adds it back. */
+static void text_mapped_then_read_check(const char *label) {
+    text_mapped_check(label);
+    text_check(label);
+}
+
+static void test_text(void) {
+    remove(TEXT_SIDECAR);
+    text_write_source(1);
+
+    /* Cold read writes the sidecar, warm read adopts it. */
+    text_check("cold");
+    size_t size = 0;
+    uint8_t *good = read_all(TEXT_SIDECAR, &size);
+    CHECK(good != NULL && size > 64);
+    if (!good)
+        return;
+    text_check("warm");
+    text_mapped_check("warm");
+    CHECK(file_equals(TEXT_SIDECAR, good, size));
+
+    corrupt_each(TEXT_SIDECAR, good, size, text_check);
+    corrupt_each(TEXT_SIDECAR, good, size, text_mapped_then_read_check);
+    free(good);
+
+    /* Same size, new contents: the old sidecar is stale even if mtime granularity hides the write. */
+    text_write_source(2);
+    text_check("stale");
+    text_mapped_check("stale");
+
+    text_file_free(text_expected);
+    text_expected = NULL;
+}
+
+/* ================== VF ================== */
+
+static vf_file_t *vf_expected;
+
+static void vf_write_source(uint32_t seed) {
+    vf_file_t *vf = vf_file_create();
+    for (uint32_t i = 0; vf && i < ENTRIES; ++i) {
+        vf_entry_t *e = vf_entry_create();
+        if (!e)
+            break;
+        char path[64];
+        snprintf(path, sizeof(path), "root\\d%u\\s%u\\f%05u.bin", (i + seed) % 11, i % 5, i);
+        vf_entry_set_path(e, path);
+        vf_entry_set_name(e, strrchr(path, '\\') + 1);
+        vf_entry_set_file_size(e, (uint64_t) i * seed);
+        vf_file_add_entry(vf, e);
+        vf_entry_free(e);
+    }
+    CHECK(vf != NULL && vf_file_write(VF_FILE, vf) == 0);
+    vf_file_free(vf);
+    vf_file_free(vf_expected);
+    vf_expected = vf_file_read(VF_FILE);
+    CHECK(vf_expected != NULL);
+}
+
+static int vf_matches(vf_file_t *vf) {
+    if (!vf || !vf_expected || vf_file_entry_count(vf) != vf_file_entry_count(vf_expected))
+        return 0;
+    for (uint32_t i = 0; i < vf_file_entry_count(vf); ++i) {
+        const vf_entry_t *a = vf_file_get_entry(vf, i), *b = vf_file_get_entry(vf_expected, i);
+        if (strcmp(a->file_path, b->file_path) || strcmp(a->file_name, b->file_name) || a->file_size != b->file_size)
+            return 0;
+        uint32_t at = UINT32_MAX;
+        if (vf_index_find_path(vf, a->file_path, strlen(a->file_path), &at) || at != i)
+            return 0;
+    }
+    return 1;
+}
+
+static void vf_check(const char *label) {
+    vf_file_t *vf = vf_file_read_cached(VF_FILE);
+    if (!vf_matches(vf))
+        fprintf(stderr, "vf sidecar: %s\n", label);
+    CHECK(vf_matches(vf));
+    vf_file_free(vf);
+}
+
+static void test_vf(void) {
+    remove(VF_SIDECAR);
+    vf_write_source(1);
+
+    vf_check("cold");
+    size_t size = 0;
+    uint8_t *good = read_all(VF_SIDECAR, &size);
+    CHECK(good != NULL && size > 64);
+    if (!good)
+        return;
+    vf_check("warm");
+    CHECK(file_equals(VF_SIDECAR, good, size));
+
+    corrupt_each(VF_SIDECAR, good, size, vf_check);
+    free(good);
+
+    vf_write_source(3);
+    vf_check("stale");
+
+    vf_file_free(vf_expected);
+    vf_expected = NULL;
+}
+
+int main(void) {
+    test_text();
+    test_vf();
+    return test_result();
+}
@@ -0,0 +1,98 @@
+#include "crc32.h"
+#include "test.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Bit-at-a-time reference for the reflected CRC-32 polynomial. */
+static uint32_t crc32_ref(uint32_t crc, const uint8_t *p, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= p[i];
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static uint8_t data[70000 + 16];
+
+static void fill(void) {
+    uint32_t x = 12345;
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        x = x * 1103515245u + 12345u;
+        data[i] = (uint8_t) (x >> 16);
+    }
+}
+
+static void test_vectors(void) {
+    CHECK(sso_crc32(0, "123456789", 9) == 0xCBF43926u);
+    CHECK(sso_crc32(0, "a", 1) == 0xE8B7BE43u);
+    CHECK(sso_crc32(0, "", 0) == 0);
+    CHECK(sso_crc32(0x1234u, NULL, 0) == 0x1234u);
+}
+
+/* Every kernel against the reference, at every tail length and misalignment around its block sizes. */
+static void test_kernels(void) {
+    static const size_t big[] = { 255, 256, 257, 1023, 1024, 4095, 4096, 4097, 65536 + 13, 70000 };
+
+    for (int k = SSO_CRC32_SLICE16; k < SSO_CRC32_KERNEL_COUNT; ++k) {
+        if (!sso_crc32_kernel_supported((sso_crc32_kernel_t) k))
+            continue;
+        CHECK(sso_crc32_select_kernel((sso_crc32_kernel_t) k) == 0);
+        CHECK(sso_crc32_active_kernel() == (sso_crc32_kernel_t) k);
+
+        for (size_t off = 0; off < 16; ++off) {
+            for (size_t len = 0; len <= 200; ++len)
+                CHECK(sso_crc32(0, data + off, len) == crc32_ref(0, data + off, len));
+            for (size_t i = 0; i < sizeof(big) / sizeof(big[0]); ++i)
+                CHECK(sso_crc32(0, data + off, big[i]) == crc32_ref(0, data + off, big[i]));
+        }
+
+        /* Feeding the running CRC back in continues the same stream. */
+        const uint32_t whole = crc32_ref(0, data, 70000);
+        for (size_t split = 0; split <= 70000; split += 4999) {
+            const uint32_t a = sso_crc32(0, data, split);
+            CHECK(sso_crc32(a, data + split, 70000 - split) == whole);
+        }
+    }
+
+    CHECK(sso_crc32_select_kernel(SSO_CRC32_AUTO) == 0);
+    CHECK(sso_crc32_active_kernel() != SSO_CRC32_AUTO);
+    CHECK(sso_crc32_select_kernel(SSO_CRC32_KERNEL_COUNT) == 1);
+    CHECK(strcmp(sso_crc32_kernel_name(SSO_CRC32_SLICE16), "slice16") == 0);
+    CHECK(strcmp(sso_crc32_kernel_name(SSO_CRC32_KERNEL_COUNT), "unknown") == 0);
+}
+
+static void test_combine(void) {
+    static const size_t splits[] = { 0, 1, 2, 3, 7, 8, 15, 16, 17, 100, 4096, 33333, 69999, 70000 };
+    const uint32_t whole = crc32_ref(0, data, 70000);
+
+    for (size_t i = 0; i < sizeof(splits) / sizeof(splits[0]); ++i) {
+        const size_t s = splits[i];
+        const uint32_t a = sso_crc32(0, data, s);
+        const uint32_t b = sso_crc32(0, data + s, 70000 - s);
+        CHECK(sso_crc32_combine(a, b, 70000 - s) == whole);
+    }
+
+    /* Three pieces combine the same either way round. */
+    const uint32_t a = sso_crc32(0, data, 1000);
+    const uint32_t b = sso_crc32(0, data + 1000, 2345);
+    const uint32_t c = sso_crc32(0, data + 3345, 66655);
+    CHECK(sso_crc32_combine(sso_crc32_combine(a, b, 2345), c, 66655) == whole);
+    CHECK(sso_crc32_combine(a, sso_crc32_combine(b, c, 66655), 2345 + 66655) == whole);
+
+    /* Lengths past 4 GiB exercise the high bits of the shift, without the data. */
+    const uint64_t l1 = ((uint64_t) 1 << 32) + 12345, l2 = ((uint64_t) 3 << 33) + 7;
+    CHECK(sso_crc32_combine(sso_crc32_combine(a, b, l1), c, l2) ==
+          sso_crc32_combine(a, sso_crc32_combine(b, c, l2), l1 + l2));
+    CHECK(sso_crc32_combine(a, 0, 0) == a);
+}
+
+int main(void) {
+    fill();
+    test_vectors();
+    test_kernels();
+    test_combine();
+    return test_result();
+}
@@ -0,0 +1,59 @@
+#ifndef SSO_TEST_FS_H
+#define SSO_TEST_FS_H
+
+/*
+ * Scratch-file helpers for tests that work on real files. On POSIX the test
+ * defines _POSIX_C_SOURCE before its first include, as write.c does.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <time.h>
+#endif
+
+static inline void test_mkdir(const char *path) {
+#ifdef _WIN32
+    _mkdir(path);
+#else
+    mkdir(path, 0777);
+#endif
+}
+
+static inline void test_sleep_ms(unsigned ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long) (ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static inline int test_write_file(const char *path, const void *data, size_t size) {
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return 1;
+    const int failed = fwrite(data, 1, size, f) != size;
+    return fclose(f) != 0 || failed;
+}
+
+/* Deterministic filler so reruns produce the same files and CRCs. */
+static inline void test_fill(uint8_t *buf, size_t size, uint32_t seed) {
+    uint32_t x = seed * 2654435761u + 1;
+    for (size_t i = 0; i < size; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = (uint8_t) x;
+    }
+}
+
+#endif /* SSO_TEST_FS_H */
@@ -0,0 +1,333 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "io.h"
+#include "alloc.h"
+#include "text.h"
+#include "vf.h"
+#include "test.h"
+#include "test_fs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define test_open_read(path)  _open((path), _O_RDONLY | _O_BINARY)
+#define test_open_write(path) _open((path), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0666)
+#define test_close(fd)        _close(fd)
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define test_open_read(path)  open((path), O_RDONLY)
+#define test_open_write(path) open((path), O_WRONLY | O_CREAT | O_TRUNC, 0666)
+#define test_close(fd)        close(fd)
+#endif
+
+#define DATA_FILE "io_data.bin"
+#define DATA_SIZE 200003u
+#define WINDOW    65536u
+
+static uint8_t data[DATA_SIZE];
+
+/* Chunk sizes that land reads on, just before and just after the fd backend's window edges. */
+static const size_t chunks[] = { 1, 3, WINDOW - 5, 4, WINDOW, 2, WINDOW + 1, 17, 4096, WINDOW - 1, 100000 };
+
+/* Reads the whole source from `start` in the chunk pattern, then checks it is exhausted. */
+static void check_stream(sso_reader_t *r, size_t start, int sized) {
+    static uint8_t buf[DATA_SIZE];
+    size_t pos = start, k = 0;
+
+    while (pos < DATA_SIZE) {
+        size_t n = chunks[k++ % (sizeof(chunks) / sizeof(chunks[0]))];
+        if (n > DATA_SIZE - pos)
+            n = DATA_SIZE - pos;
+        if (sized) {
+            uint64_t left = 0;
+            CHECK(sso_reader_remaining(r, &left) == 0 && left == DATA_SIZE - pos);
+        }
+        const int rc = sso_reader_read(r, buf, n);
+        CHECK(rc == 0 && memcmp(buf, data + pos, n) == 0);
+        if (rc)
+            return;
+        pos += n;
+    }
+
+    CHECK(sso_reader_read(r, buf, 1) == 1);
+    CHECK(sso_reader_read(r, buf, 0) == 0);
+    if (sized) {
+        uint64_t left = 1;
+        CHECK(sso_reader_remaining(r, &left) == 0 && left == 0);
+    }
+}
+
+static void test_readers(void) {
+    sso_reader_t r;
+
+    sso_reader_init_mem(&r, data, DATA_SIZE);
+    check_stream(&r, 0, 1);
+    sso_reader_close(&r);
+
+    CHECK(sso_reader_open_mmap(&r, DATA_FILE) == 0);
+    check_stream(&r, 0, 1);
+    sso_reader_close(&r);
+
+    const size_t offsets[] = { 0, 1, WINDOW - 1, WINDOW + 7 };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+        const int fd = test_open_read(DATA_FILE);
+        CHECK(fd >= 0);
+        if (fd < 0)
+            continue;
+        CHECK(sso_reader_init_fd(&r, fd, offsets[i]) == 0);
+        check_stream(&r, offsets[i], 1);
+        sso_reader_close(&r);
+        test_close(fd);
+    }
+
+    FILE *f = fopen(DATA_FILE, "rb");
+    CHECK(f != NULL);
+    if (f) {
+        sso_reader_init_stdio(&r, f);
+        check_stream(&r, 0, 1);
+        sso_reader_close(&r);
+        fclose(f);
+    }
+}
+
+/* A custom backend with a 7-byte window, to drive the refill path of sso_reader_read. */
+typedef struct {
+    const uint8_t *src;
+    size_t         size;
+    size_t         next;
+    uint8_t        window[7];
+} tiny_source_t;
+
+static int tiny_read(sso_reader_t *r, void *buf, size_t n) {
+    tiny_source_t *t = (tiny_source_t *) r->ctx;
+    uint8_t *out = (uint8_t *) buf;
+    while (n) {
+        if (r->pos == r->size) {
+            const size_t take = t->size - t->next < sizeof(t->window) ? t->size - t->next : sizeof(t->window);
+            if (take == 0)
+                return 1;
+            memcpy(t->window, t->src + t->next, take);
+            t->next += take;
+            r->data = t->window;
+            r->size = take;
+            r->pos = 0;
+        }
+        const size_t step = n < r->size - r->pos ? n : r->size - r->pos;
+        memcpy(out, r->data + r->pos, step);
+        r->pos += step;
+        out += step;
+        n -= step;
+    }
+    return 0;
+}
+
+static const sso_reader_ops_t tiny_ops = { tiny_read, NULL, NULL };
+
+static void tiny_init(sso_reader_t *r, tiny_source_t *t, const void *src, size_t size) {
+    memset(r, 0, sizeof(*r));
+    memset(t, 0, sizeof(*t));
+    t->src = (const uint8_t *) src;
+    t->size = size;
+    r->ops = &tiny_ops;
+    r->ctx = t;
+}
+
+static text_file_t *make_text(void) {
+    text_file_t *tf = text_file_create();
+    for (uint32_t i = 0; tf && i < 3000; ++i) {
+        text_entry_t *e = text_entry_create();
+        if (!e)
+            break;
+        char key[32], value[48];
+        snprintf(key, sizeof(key), "key_%u", i);
+        snprintf(value, sizeof(value), "value number %u", i * 7919);
+        text_entry_set_key(e, key);
+        text_entry_set_value_utf8(e, value, strlen(value));
+        text_file_add_entry(tf, e);
+        text_entry_free(e);
+    }
+    return tf;
+}
+
+static vf_file_t *make_vf(void) {
+    vf_file_t *vf = vf_file_create();
+    for (uint32_t i = 0; vf && i < 3000; ++i) {
+        vf_entry_t *e = vf_entry_create();
+        if (!e)
+            break;
+        char path[48];
+        snprintf(path, sizeof(path), "dir%u\\sub\\file_%u.bin", i % 13, i);
+        vf_entry_set_path(e, path);
+        vf_entry_set_name(e, strrchr(path, '\\') + 1);
+        vf_entry_set_file_size(e, i);
+        vf_file_add_entry(vf, e);
+        vf_entry_free(e);
+    }
+    return vf;
+}
+
+static int same_text(const text_file_t *a, const text_file_t *b) {
+    if (!a || !b || a->header.entry_count != b->header.entry_count)
+        return 0;
+    for (uint32_t i = 0; i < a->header.entry_count; ++i) {
+        const text_entry_t *x = &a->entries[i], *y = &b->entries[i];
+        if (strcmp(x->key, y->key) || x->value_length != y->value_length ||
+            memcmp(x->value, y->value, x->value_length))
+            return 0;
+    }
+    return 1;
+}
+
+static int same_vf(const vf_file_t *a, const vf_file_t *b) {
+    if (!a || !b || a->header.entry_count != b->header.entry_count)
+        return 0;
+    for (uint32_t i = 0; i < a->header.entry_count; ++i) {
+        const vf_entry_t *x = &a->entries[i], *y = &b->entries[i];
+        if (strcmp(x->file_path, y->file_path) || strcmp(x->file_name, y->file_name) || x->file_size != y->file_size)
+            return 0;
+    }
+    return 1;
+}
+
+/* Every writer produces the same bytes as the file writer, and every reader parses them back. */
+static void test_text_backends(void) {
+    text_file_t *tf = make_text();
+    CHECK(tf != NULL);
+    if (!tf)
+        return;
+    CHECK(text_file_write("io_text.text", tf) == 0);
+
+    sso_writer_t w;
+    sso_writer_init_mem(&w);
+    CHECK(text_file_write_to(&w, tf) == 0);
+    size_t size = 0;
+    uint8_t *image = (uint8_t *) sso_writer_take(&w, &size);
+    CHECK(image != NULL && w.size == 0 && sso_writer_take(&w, NULL) == NULL);
+    sso_writer_close(&w);
+    if (!image) {
+        text_file_free(tf);
+        return;
+    }
+
+    const int fd = test_open_write("io_text_fd.text");
+    CHECK(fd >= 0);
+    if (fd >= 0) {
+        sso_writer_init_fd(&w, fd);
+        CHECK(text_file_write_to(&w, tf) == 0);
+        sso_writer_close(&w);
+        test_close(fd);
+    }
+    FILE *f = fopen("io_text_stdio.text", "wb");
+    CHECK(f != NULL);
+    if (f) {
+        sso_writer_init_stdio(&w, f);
+        CHECK(text_file_write_to(&w, tf) == 0);
+        sso_writer_close(&w);
+        fclose(f);
+    }
+
+    const char *const files[] = { "io_text.text", "io_text_fd.text", "io_text_stdio.text" };
+    for (size_t i = 0; i < 3; ++i) {
+        text_file_t *back = text_file_read(files[i]);
+        CHECK(same_text(tf, back));
+        text_file_free(back);
+    }
+
+    text_file_t *back = text_file_read_mem(image, size);
+    CHECK(same_text(tf, back));
+    text_file_free(back);
+
+    sso_reader_t r;
+    tiny_source_t t;
+    tiny_init(&r, &t, image, size);
+    back = text_file_read_from(&r);
+    CHECK(same_text(tf, back));
+    text_file_free(back);
+
+    const int rfd = test_open_read("io_text_fd.text");
+    if (rfd >= 0) {
+        CHECK(sso_reader_init_fd(&r, rfd, 0) == 0);
+        back = text_file_read_from(&r);
+        CHECK(same_text(tf, back));
+        text_file_free(back);
+        sso_reader_close(&r);
+        test_close(rfd);
+    }
+
+    /* A cut image fails cleanly, through the sized and the unsized path. */
+    const size_t cuts[] = { 0, 15, 16, 17, size / 2, size - 1 };
+    for (size_t k = 0; k < sizeof(cuts) / sizeof(cuts[0]); ++k) {
+        CHECK(text_file_read_mem(image, cuts[k]) == NULL);
+        tiny_init(&r, &t, image, cuts[k]);
+        CHECK(text_file_read_from(&r) == NULL);
+    }
+
+    sso_free(image);
+    text_file_free(tf);
+}
+
+static void test_vf_backends(void) {
+    vf_file_t *vf = make_vf();
+    CHECK(vf != NULL);
+    if (!vf)
+        return;
+
+    sso_writer_t w;
+    sso_writer_init_mem(&w);
+    CHECK(vf_file_write_to(&w, vf) == 0);
+    size_t size = 0;
+    uint8_t *image = (uint8_t *) sso_writer_take(&w, &size);
+    sso_writer_close(&w);
+    CHECK(image != NULL);
+    if (!image) {
+        vf_file_free(vf);
+        return;
+    }
+    CHECK(test_write_file("io_vf.ccx", image, size) == 0);
+
+    vf_file_t *back = vf_file_read("io_vf.ccx");
+    CHECK(same_vf(vf, back));
+    vf_file_free(back);
+
+    back = vf_file_read_mem(image, size);
+    CHECK(same_vf(vf, back));
+    vf_file_free(back);
+
+    sso_reader_t r;
+    CHECK(sso_reader_open_mmap(&r, "io_vf.ccx") == 0);
+    back = vf_file_read_from(&r);
+    CHECK(same_vf(vf, back));
+    vf_file_free(back);
+    sso_reader_close(&r);
+
+    tiny_source_t t;
+    tiny_init(&r, &t, image, size);
+    back = vf_file_read_from(&r);
+    CHECK(same_vf(vf, back));
+    vf_file_free(back);
+
+    const size_t cuts[] = { 0, 11, 12, 13, size / 2, size - 1 };
+    for (size_t k = 0; k < sizeof(cuts) / sizeof(cuts[0]); ++k) {
+        CHECK(vf_file_read_mem(image, cuts[k]) == NULL);
+        tiny_init(&r, &t, image, cuts[k]);
+        CHECK(vf_file_read_from(&r) == NULL);
+    }
+
+    sso_free(image);
+    vf_file_free(vf);
+}
+
+int main(void) {
+    test_fill(data, DATA_SIZE, 25);
+    CHECK(test_write_file(DATA_FILE, data, DATA_SIZE) == 0);
+    test_readers();
+    test_text_backends();
+    test_vf_backends();
+    return test_result();
+}
@@ -0,0 +1,201 @@
+#include "snapshot.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEXT_SNAP "snapshot_text.sso"
+#define VF_SNAP   "snapshot_vf.sso"
+
+static text_file_t *make_text(void) {
+    text_file_t *tf = text_file_create();
+    CHECK(tf != NULL);
+    for (uint32_t i = 0; tf && i < 40; ++i) {
+        text_entry_t *e = text_entry_create();
+        if (!e)
+            break;
+        char key[32], value[64];
+        /* Keys repeat every 16 entries; entry 5 has neither key nor value. */
+        snprintf(key, sizeof(key), "KEY_%u", i % 16);
+        snprintf(value, sizeof(value), "value %u \xc3\xa9\xe2\x82\xac", i);
+        if (i != 5) {
+            text_entry_set_key(e, key);
+            CHECK(text_entry_set_value_utf8(e, value, strlen(value)) == 0);
+        }
+        const uint8_t u2[4] = { 1, 2, 3, (uint8_t) i };
+        text_entry_set_unknown2(e, u2);
+        text_entry_set_unknown6(e, (uint8_t) (i * 7));
+        CHECK(text_file_add_entry(tf, e) == 0);
+        text_entry_free(e);
+    }
+    return tf;
+}
+
+static vf_file_t *make_vf(void) {
+    vf_file_t *vf = vf_file_create();
+    CHECK(vf != NULL);
+    for (uint32_t i = 0; vf && i < 40; ++i) {
+        vf_entry_t *e = vf_entry_create();
+        if (!e)
+            break;
+        char path[32];
+        snprintf(path, sizeof(path), "dir%u\\file%u.bin", i % 4, i % 30);
+        vf_entry_set_path(e, path);
+        if (i != 9)
+            vf_entry_set_name(e, strchr(path, '\\') + 1);
+        const uint8_t crc[4] = { (uint8_t) i, 0xAA, 0xBB, 0xCC };
+        vf_entry_set_original_crc(e, crc);
+        vf_entry_set_file_size(e, i * 1000 + 1);
+        vf_entry_set_source_file_number(e, 40 - i);
+        CHECK(vf_file_add_entry(vf, e) == 0);
+        vf_entry_free(e);
+    }
+    return vf;
+}
+
+static int same_str(const char *a, const char *b) {
+    return (!a && !b) || (a && b && strcmp(a, b) == 0);
+}
+
+static void check_text(const char *filename, text_file_t *tf) {
+    sso_snapshot_t *s = sso_snapshot_open(filename);
+    CHECK(s != NULL);
+    if (!s)
+        return;
+    CHECK(sso_snapshot_verify(s) == 0);
+    CHECK(sso_snapshot_kind(s) == SSO_SNAPSHOT_TEXT);
+    CHECK(sso_snapshot_vf_header(s) == NULL);
+    CHECK(sso_snapshot_entry_count(s) == text_file_entry_count(tf));
+    const text_header_t *h = sso_snapshot_text_header(s);
+    CHECK(h && memcmp(h, &tf->header, sizeof(*h)) == 0);
+
+    for (uint32_t i = 0; i < sso_snapshot_entry_count(s); ++i) {
+        const text_entry_t *o = &tf->entries[i];
+        const sso_snapshot_text_record_t *r = sso_snapshot_text_record(s, i);
+        CHECK(r != NULL);
+        if (!r)
+            continue;
+        CHECK(same_str(sso_snapshot_string(s, r->key), o->key));
+        text_entry_t *e = sso_snapshot_clone_text_entry(s, i);
+        CHECK(e != NULL);
+        if (!e)
+            continue;
+        CHECK(same_str(e->key, o->key) && e->value_length == o->value_length);
+        CHECK(!o->value || memcmp(e->value, o->value, o->value_length) == 0);
+        CHECK(memcmp(e->unknown2, o->unknown2, 4) == 0 && e->unknown6 == o->unknown6);
+        text_entry_free(e);
+    }
+
+    /* Duplicate keys resolve to their first entry. */
+    uint32_t at = UINT32_MAX;
+    if (text_file_entry_count(tf) > 0)
+        CHECK(sso_snapshot_find(s, "KEY_3", 5, &at) == 0 && at == 3);
+    CHECK(sso_snapshot_find(s, "KEY_99", 6, &at) == 1);
+    CHECK(sso_snapshot_text_record(s, sso_snapshot_entry_count(s)) == NULL);
+    sso_snapshot_close(s);
+}
+
+static void check_vf(const char *filename, vf_file_t *vf) {
+    sso_snapshot_t *s = sso_snapshot_open(filename);
+    CHECK(s != NULL);
+    if (!s)
+        return;
+    CHECK(sso_snapshot_verify(s) == 0);
+    CHECK(sso_snapshot_kind(s) == SSO_SNAPSHOT_VF);
+    CHECK(sso_snapshot_text_header(s) == NULL);
+    CHECK(sso_snapshot_entry_count(s) == vf_file_entry_count(vf));
+
+    for (uint32_t i = 0; i < sso_snapshot_entry_count(s); ++i) {
+        const vf_entry_t *o = &vf->entries[i];
+        vf_entry_t *e = sso_snapshot_clone_vf_entry(s, i);
+        CHECK(e != NULL);
+        if (!e)
+            continue;
+        CHECK(same_str(e->file_path, o->file_path) && same_str(e->file_name, o->file_name));
+        CHECK(e->file_size == o->file_size && e->source_file_number == o->source_file_number);
+        CHECK(memcmp(e->original_crc, o->original_crc, 4) == 0);
+        vf_entry_free(e);
+    }
+
+    uint32_t at = UINT32_MAX;
+    CHECK(sso_snapshot_find(s, "dir1\\file1.bin", 14, &at) == 0 && at == 1);
+    CHECK(sso_snapshot_find(s, "dir3\\file1.bin", 14, &at) == 0 && at == 31);
+    CHECK(sso_snapshot_clone_text_entry(s, 0) == NULL);
+    sso_snapshot_close(s);
+}
+
+static size_t read_file(const char *filename, uint8_t *buf, size_t cap) {
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return 0;
+    const size_t n = fread(buf, 1, cap, f);
+    fclose(f);
+    return n;
+}
+
+static int write_file(const char *filename, const uint8_t *buf, size_t size) {
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+        return 1;
+    const int failed = fwrite(buf, 1, size, f) != size;
+    return fclose(f) != 0 || failed;
+}
+
+/* Any flipped byte is refused by open or caught by verify; a cut file never opens. */
+static void check_corruption(const char *filename) {
+    static uint8_t image[1 << 16], bad[1 << 16];
+    const size_t size = read_file(filename, image, sizeof(image));
+    CHECK(size > 0 && size < sizeof(image));
+    if (size == 0 || size >= sizeof(image))
+        return;
+
+    const char *scratch = "snapshot_bad.sso";
+    uint32_t missed = 0;
+    for (size_t pos = 0; pos < size; ++pos) {
+        memcpy(bad, image, size);
+        bad[pos] ^= 0x10;
+        if (write_file(scratch, bad, size))
+            break;
+        sso_snapshot_t *s = sso_snapshot_open(scratch);
+        if (s && sso_snapshot_verify(s) == 0)
+            missed++;
+        sso_snapshot_close(s);
+    }
+    CHECK(missed == 0);
+
+    const size_t cuts[] = { 0, 1, 16, size / 2, size - 1 };
+    for (size_t k = 0; k < sizeof(cuts) / sizeof(cuts[0]); ++k) {
+        CHECK(write_file(scratch, image, cuts[k]) == 0);
+        sso_snapshot_t *s = sso_snapshot_open(scratch);
+        CHECK(s == NULL);
+        sso_snapshot_close(s);
+    }
+    CHECK(sso_snapshot_open("snapshot_missing.sso") == NULL);
+}
+
+int main(void) {
+    text_file_t *tf = make_text();
+    if (tf) {
+        CHECK(sso_snapshot_write_text(TEXT_SNAP, tf) == 0);
+        check_text(TEXT_SNAP, tf);
+        check_corruption(TEXT_SNAP);
+        text_file_free(tf);
+    }
+
+    vf_file_t *vf = make_vf();
+    if (vf) {
+        CHECK(sso_snapshot_write_vf(VF_SNAP, vf) == 0);
+        check_vf(VF_SNAP, vf);
+        check_corruption(VF_SNAP);
+        vf_file_free(vf);
+    }
+
+    /* An empty file still makes a valid snapshot. */
+    tf = text_file_create();
+    if (tf) {
+        CHECK(sso_snapshot_write_text(TEXT_SNAP, tf) == 0);
+        check_text(TEXT_SNAP, tf);
+        text_file_free(tf);
+    }
+    return test_result();
+}
@@ -0,0 +1,87 @@
+#include "text.h"
+#include "test.h"
+
+#include <string.h>
+
+static const char *const keys[] = {
+    "a", "ab", "abc", "abcdefg", "abcdefgh", "abcdefghi", "abcdefghXY",
+    "ab", "b", "abcdefghijklmnop", "zz", "",
+};
+#define KEY_COUNT (sizeof(keys) / sizeof(keys[0]))
+
+static int key_compare(const char *a, size_t alen, const char *b, size_t blen) {
+    const int c = memcmp(a, b, alen < blen ? alen : blen);
+    if (c)
+        return c;
+    return alen < blen ? -1 : alen > blen;
+}
+
+static const char *key_at(text_file_t *tf, const text_sorted_t *ts, uint32_t rank) {
+    return text_entry_get_key(text_file_get_entry(tf, text_sorted_entry(ts, rank)));
+}
+
+int main(void) {
+    text_file_t *tf = text_file_create();
+    CHECK(tf != NULL);
+    if (!tf)
+        return test_result();
+
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        text_entry_t *e = text_entry_create();
+        CHECK(e != NULL);
+        if (!e)
+            continue;
+        text_entry_set_key(e, keys[i]);
+        text_entry_set_value(e, "v");
+        CHECK(text_file_add_entry(tf, e) == 0);
+        text_entry_free(e);
+    }
+
+    text_sorted_t *ts = text_sorted_build(tf);
+    CHECK(ts != NULL);
+    if (!ts) {
+        text_file_free(tf);
+        return test_result();
+    }
+    CHECK(text_sorted_count(ts) == KEY_COUNT);
+
+    /* Keys of 8 bytes or fewer sort against longer keys sharing their head. */
+    for (uint32_t r = 1; r < text_sorted_count(ts); ++r) {
+        const char *a = key_at(tf, ts, r - 1);
+        const char *b = key_at(tf, ts, r);
+        CHECK(key_compare(a, strlen(a), b, strlen(b)) <= 0);
+    }
+
+    /*
+     * Probes with embedded NULs share their 8-byte head with the short keys,
+     * which zero-pad theirs; every bound must match a linear count.
+     */
+    static const char probes[][16] = {
+        "ab\0\0\0\0\0\0\0\0zz", "a\0\0\0\0\0\0\0\0", "abcdefgh", "abcdefgh\0",
+        "abcdefghi", "\0\0\0\0\0\0\0\0\0\0\0\0", "abcdefgz",
+    };
+    static const size_t probe_len[] = { 12, 9, 8, 9, 9, 12, 8 };
+
+    for (size_t p = 0; p < sizeof(probe_len) / sizeof(probe_len[0]); ++p) {
+        for (size_t len = 0; len <= probe_len[p]; ++len) {
+            uint32_t lower = 0, upper = 0, prefixed = 0;
+            for (size_t i = 0; i < KEY_COUNT; ++i) {
+                const size_t klen = strlen(keys[i]);
+                const int c = key_compare(keys[i], klen, probes[p], len);
+                lower += c < 0;
+                upper += c <= 0;
+                prefixed += klen >= len && memcmp(keys[i], probes[p], len) == 0;
+            }
+            CHECK(text_sorted_lower_bound(ts, probes[p], len) == lower);
+            CHECK(text_sorted_upper_bound(ts, probes[p], len) == upper);
+
+            uint32_t first = 0, last = 0;
+            text_sorted_prefix_range(ts, probes[p], len, &first, &last);
+            CHECK(last - first == prefixed);
+        }
+    }
+
+    text_sorted_free(ts);
+    text_file_free(tf);
+    return test_result();
+}
@@ -0,0 +1,75 @@
+#include "text.h"
+#include "utf.h"
+#include "test.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Entries without a value read as the empty string, alone and inside a whole-file transcode. */
+static void test_missing_value(void) {
+    char out[8];
+    size_t len = 123;
+
+    CHECK(sso_utf16le_to_utf8(NULL, 0, out, sizeof(out)) == 0);
+    CHECK(sso_utf8_to_utf16le(NULL, 0, out, 4) == 0);
+    CHECK(sso_utf16le_to_utf8(NULL, 1, out, sizeof(out)) == SIZE_MAX);
+
+    text_entry_t *e = text_entry_create();
+    CHECK(e != NULL);
+    if (!e)
+        return;
+    text_entry_set_key(e, "key");
+    CHECK(text_entry_get_value_utf8(e, out, sizeof(out), &len) == 0);
+    CHECK(len == 0 && out[0] == '\0');
+
+    text_file_t *tf = text_file_create();
+    CHECK(tf != NULL);
+    if (tf) {
+        CHECK(text_file_add_entry(tf, e) == 0);
+        CHECK(text_file_resize(tf, 3) == 0);
+
+        text_utf8_table_t table;
+        CHECK(text_file_transcode_all(tf, &table) == 0);
+        for (uint32_t i = 0; i < 3; ++i) {
+            const char *s = text_utf8_table_get(&table, i, &len);
+            CHECK(s != NULL && len == 0 && s[0] == '\0');
+        }
+        text_utf8_table_free(&table);
+        text_file_free(tf);
+    }
+    text_entry_free(e);
+}
+
+/* Mixed 1-, 2-, 3- and 4-byte sequences at every length, so vector blocks end at every offset. */
+static void test_round_trip(void) {
+    static const char *pieces[] = { "a", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "Z" };
+    char in[512], out[512];
+
+    for (size_t count = 0; count < 80; ++count) {
+        size_t len = 0;
+        for (size_t i = 0; i < count; ++i) {
+            /* Long ASCII stretches in between keep the fast paths busy. */
+            const char *p = (i % 7 < 4) ? "x" : pieces[i % 5];
+            memcpy(in + len, p, strlen(p));
+            len += strlen(p);
+        }
+
+        text_entry_t *e = text_entry_create();
+        CHECK(e != NULL);
+        if (!e)
+            return;
+        CHECK(text_entry_set_value_utf8(e, in, len) == 0);
+
+        size_t got = 0;
+        CHECK(text_entry_get_value_utf8(e, out, sizeof(out), &got) == 0);
+        CHECK(got == len && memcmp(in, out, len) == 0);
+        CHECK(text_entry_get_value_utf8(e, out, got, NULL) == 1);
+        text_entry_free(e);
+    }
+}
+
+int main(void) {
+    test_missing_value();
+    test_round_trip();
+    return test_result();
+}
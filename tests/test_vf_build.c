@@ -0,0 +1,112 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "vf.h"
+#include "crc32.h"
+#include "test.h"
+#include "test_fs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TREE "vf_build_tree"
+
+/* In byte order of the relative path, which is the order the build emits. */
+static const char *const rel[] = {
+    "A.bin",
+    "a.bin",
+    "dir/empty.bin",
+    "dir/nested/deep/leaf.bin",
+    "dir/x.bin",
+    "dir2/y.bin",
+};
+static const size_t sizes[] = { 17, 1, 0, 300000, 4096, 65537 };
+#define FILES (sizeof(rel) / sizeof(rel[0]))
+
+static uint32_t crcs[FILES];
+
+static int make_tree(void) {
+    test_mkdir(TREE);
+    test_mkdir(TREE "/dir");
+    test_mkdir(TREE "/dir/nested");
+    test_mkdir(TREE "/dir/nested/deep");
+    test_mkdir(TREE "/dir/emptydir");
+    test_mkdir(TREE "/dir2");
+    for (size_t i = 0; i < FILES; ++i) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%s", TREE, rel[i]);
+        uint8_t *buf = (uint8_t *) malloc(sizes[i] + 1);
+        if (!buf)
+            return 1;
+        test_fill(buf, sizes[i], (uint32_t) i + 7);
+        crcs[i] = sso_crc32(0, buf, sizes[i]);
+        const int rc = test_write_file(path, buf, sizes[i]);
+        free(buf);
+        if (rc)
+            return 1;
+    }
+    return 0;
+}
+
+static uint32_t crc_field(const uint8_t b[4]) {
+    return (uint32_t) b[0] | ((uint32_t) b[1] << 8) | ((uint32_t) b[2] << 16) | ((uint32_t) b[3] << 24);
+}
+
+static void check_build(const vf_build_opts_t *opts, char sep) {
+    vf_file_t *vf = vf_file_build_from_dir(TREE, opts);
+    CHECK(vf != NULL);
+    if (!vf)
+        return;
+
+    CHECK(vf_file_entry_count(vf) == FILES);
+    CHECK(memcmp(vf->header.magic_bytes, opts->header.magic_bytes, 4) == 0);
+    CHECK(vf->header.manifest_version == opts->header.manifest_version);
+
+    for (uint32_t i = 0; i < FILES && i < vf_file_entry_count(vf); ++i) {
+        const vf_entry_t *e = &vf->entries[i];
+        char want[256];
+        size_t k = 0;
+        for (; rel[i][k]; ++k)
+            want[k] = rel[i][k] == '/' ? sep : rel[i][k];
+        want[k] = '\0';
+
+        const char *slash = strrchr(rel[i], '/');
+        CHECK(strcmp(e->file_path, want) == 0);
+        CHECK(strcmp(e->file_name, slash ? slash + 1 : rel[i]) == 0);
+        CHECK(e->file_size == sizes[i]);
+        CHECK(crc_field(e->original_crc) == crcs[i] && crc_field(e->exported_crc) == crcs[i]);
+        CHECK(e->source_file_number == opts->first_source_number + i);
+    }
+
+    /* What the build wrote down is exactly what verification expects. */
+    vf_verify_report_t rep;
+    CHECK(vf_verify_tree(vf, TREE, NULL, &rep) == 0);
+    CHECK(rep.ok == FILES);
+    vf_verify_report_free(&rep);
+
+    vf_file_free(vf);
+}
+
+int main(void) {
+    CHECK(make_tree() == 0);
+
+    vf_build_opts_t opts;
+    memset(&opts, 0, sizeof(opts));
+    check_build(&opts, '\\');
+
+    opts.separator = '/';
+    opts.first_source_number = 100;
+    memcpy(opts.header.magic_bytes, "CCX1", 4);
+    opts.header.manifest_version = 3;
+    opts.nthreads = 1;
+    opts.read_size = 1000;
+    check_build(&opts, '/');
+
+    opts.nthreads = 4;
+    opts.use_mmap = 1;
+    check_build(&opts, '/');
+
+    CHECK(vf_file_build_from_dir(TREE "/no_such_dir", NULL) == NULL);
+    return test_result();
+}
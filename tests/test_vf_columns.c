@@ -0,0 +1,168 @@
+#include "vf.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Odd lengths and offsets leave a scalar tail and an unaligned head around every vector block. */
+#define MAX_LEN 300
+
+static uint32_t values[MAX_LEN + 8];
+
+static int cmp_ref(uint32_t x, vf_cmp_t op, uint32_t v) {
+    switch (op) {
+    case VF_CMP_EQ: return x == v;
+    case VF_CMP_NE: return x != v;
+    case VF_CMP_LT: return x < v;
+    case VF_CMP_LE: return x <= v;
+    case VF_CMP_GT: return x > v;
+    default:        return x >= v;
+    }
+}
+
+static void fill(void) {
+    /* Values straddle the sign bit so a signed vector compare would get them wrong. */
+    static const uint32_t picks[] = { 0, 1, 7, 0x7FFFFFFFu, 0x80000000u, 0x80000001u, 0xFFFFFFFEu, 0xFFFFFFFFu };
+    uint32_t x = 2463534242u;
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        values[i] = (x & 3) ? picks[x % 8] : x;
+    }
+}
+
+static void test_filter(void) {
+    static const uint32_t probes[] = { 0, 1, 7, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu, 12345 };
+    static uint32_t out[MAX_LEN], want[MAX_LEN];
+
+    for (uint32_t off = 0; off < 8; ++off) {
+        for (uint32_t len = 0; len <= MAX_LEN; len += (len < 40 ? 1 : 37)) {
+            const uint32_t *col = values + off;
+            for (int op = VF_CMP_EQ; op <= VF_CMP_GE; ++op) {
+                for (size_t p = 0; p < sizeof(probes) / sizeof(probes[0]); ++p) {
+                    uint32_t n = 0;
+                    for (uint32_t i = 0; i < len; ++i)
+                        if (cmp_ref(col[i], (vf_cmp_t) op, probes[p]))
+                            want[n++] = i;
+
+                    const uint32_t got = vf_columns_filter(col, len, (vf_cmp_t) op, probes[p], out);
+                    CHECK(got == n && memcmp(out, want, n * sizeof(uint32_t)) == 0);
+                    CHECK(vf_columns_filter(col, len, (vf_cmp_t) op, probes[p], NULL) == n);
+                }
+            }
+        }
+    }
+}
+
+static void test_aggregates(void) {
+    for (uint32_t off = 0; off < 8; ++off) {
+        for (uint32_t len = 0; len <= MAX_LEN; ++len) {
+            const uint32_t *col = values + off;
+            uint64_t sum = 0, bins[33], want[33];
+            memset(want, 0, sizeof(want));
+            for (uint32_t i = 0; i < len; ++i) {
+                sum += col[i];
+                uint32_t bits = 0;
+                for (uint32_t v = col[i]; v; v >>= 1)
+                    bits++;
+                want[bits]++;
+            }
+            CHECK(vf_columns_sum(col, len) == sum);
+            vf_columns_histogram_log2(col, len, bins);
+            CHECK(memcmp(bins, want, sizeof(bins)) == 0);
+        }
+    }
+
+    /* Every other row, then the rows a filter picked. */
+    static uint32_t idx[MAX_LEN];
+    uint32_t n = 0;
+    uint64_t want = 0;
+    for (uint32_t i = 0; i < MAX_LEN; i += 2) {
+        idx[n++] = i;
+        want += values[i];
+    }
+    CHECK(vf_columns_sum_selected(values, idx, n) == want);
+    CHECK(vf_columns_sum_selected(values, idx, 0) == 0);
+
+    n = vf_columns_filter(values, MAX_LEN, VF_CMP_GE, 0x80000000u, idx);
+    want = 0;
+    for (uint32_t i = 0; i < MAX_LEN; ++i)
+        if (values[i] >= 0x80000000u)
+            want += values[i];
+    CHECK(vf_columns_sum_selected(values, idx, n) == want);
+}
+
+static int drop_odd(void *ctx, const vf_entry_t *e, uint32_t index) {
+    (void) ctx;
+    (void) e;
+    return index & 1;
+}
+
+/* Columns of a real manifest carry every field and string, missing ones stored empty. */
+static void test_manifest_columns(void) {
+    vf_file_t *vf = vf_file_create();
+    CHECK(vf != NULL);
+    if (!vf)
+        return;
+
+    CHECK(vf_file_reserve(vf, 64) == 0);
+    CHECK(vf->capacity >= 64);
+    for (uint32_t i = 0; i < 50; ++i) {
+        vf_entry_t *e = vf_entry_create();
+        if (!e)
+            break;
+        char path[32];
+        snprintf(path, sizeof(path), "%s\\f%u.bin", i % 3 ? "data" : "misc", i);
+        const uint8_t crc[4] = { (uint8_t) i, 0, 0, 0x80 };
+        vf_entry_set_path(e, path);
+        if (i != 7)
+            vf_entry_set_name(e, path + 5);
+        vf_entry_set_file_size(e, i * 3);
+        vf_entry_set_original_crc(e, crc);
+        CHECK(vf_file_append_take(vf, e) == 0);
+        vf_entry_free(e);
+    }
+
+    vf_columns_t c;
+    CHECK(vf_file_to_columns(vf, &c) == 0);
+    CHECK(c.count == 50);
+    for (uint32_t i = 0; i < c.count; ++i) {
+        uint32_t len;
+        const char *p = vf_columns_path(&c, i, &len);
+        CHECK(p && len == strlen(vf->entries[i].file_path) && strcmp(p, vf->entries[i].file_path) == 0);
+        const char *nm = vf_columns_name(&c, i, &len);
+        CHECK(nm && (i == 7 ? len == 0 : strcmp(nm, vf->entries[i].file_name) == 0));
+        CHECK(c.file_size[i] == i * 3 && c.original_crc[i] == (0x80000000u | i));
+    }
+
+    uint32_t rows[50];
+    const uint32_t n = vf_columns_filter_prefix(&c, "misc\\", 5, rows);
+    CHECK(n == 17);
+    for (uint32_t k = 0; k < n; ++k)
+        CHECK(rows[k] % 3 == 0);
+    vf_columns_free(&c);
+
+    /* Bulk removal keeps order, the slots and the lookup index. */
+    CHECK(vf_index_build(vf) == 0);
+    const uint32_t cap = vf->capacity;
+    CHECK(vf_file_remove_if(vf, drop_odd, NULL) == 25);
+    CHECK(vf_file_entry_count(vf) == 25 && vf->capacity == cap);
+    for (uint32_t i = 0; i < 25; ++i) {
+        uint32_t at = UINT32_MAX;
+        CHECK(vf->entries[i].file_size == i * 6);
+        CHECK(vf_index_find_path(vf, vf->entries[i].file_path, strlen(vf->entries[i].file_path), &at) == 0);
+        CHECK(at == i);
+    }
+    CHECK(vf_index_find_path(vf, "data\\f1.bin", 11, rows) == 1);
+    CHECK(vf_file_shrink_to_fit(vf) == 0 && vf->capacity == 25);
+    vf_file_free(vf);
+}
+
+int main(void) {
+    fill();
+    test_filter();
+    test_aggregates();
+    test_manifest_columns();
+    return test_result();
+}
@@ -0,0 +1,127 @@
+#include "vf.h"
+#include "test.h"
+
+#include <string.h>
+
+/* Separators agree with the tree, disagree with it, mix within a path, or repeat. */
+static const char *const paths[] = {
+    "data\\maps\\town.bin",
+    "data\\maps\\field.bin",
+    "data/maps/cave.bin",
+    "data\\maps/mixed.bin",
+    "data/sound\\bgm.ogg",
+    "data\\sound\\se\\hit.wav",
+    "data\\sound\\se\\",
+    "data\\\\double.bin",
+    "\\leading.bin",
+    "top.bin",
+    "",
+    "data\\maps\\town.bin",
+    "a/b/c/d/e/f/g/deep.bin",
+};
+#define PATHS (sizeof(paths) / sizeof(paths[0]))
+
+static vf_file_t *make_manifest(void) {
+    vf_file_t *vf = vf_file_create();
+    CHECK(vf != NULL);
+    for (uint32_t i = 0; vf && i < PATHS; ++i) {
+        vf_entry_t *e = vf_entry_create();
+        if (!e)
+            break;
+        const uint8_t crc[4] = { (uint8_t) i, 1, 2, 3 };
+        const uint8_t u1[8] = { 9, 9, 9, 9, 9, 9, 9, (uint8_t) (i & 1) };
+        vf_entry_set_name(e, i & 1 ? "odd" : "even");
+        vf_entry_set_path(e, paths[i]);
+        vf_entry_set_file_size(e, i * 1000);
+        vf_entry_set_source_file_number(e, i);
+        vf_entry_set_original_crc(e, crc);
+        vf_entry_set_unknown1(e, u1);
+        CHECK(vf_file_add_entry(vf, e) == 0);
+        vf_entry_free(e);
+    }
+    return vf;
+}
+
+static void check_paths(const vf_compact_t *vc, const vf_file_t *vf) {
+    CHECK(vf_compact_entry_count(vc) == PATHS);
+    for (uint32_t i = 0; i < PATHS && i < vf_compact_entry_count(vc); ++i) {
+        char out[128];
+        size_t len = 0;
+        CHECK(vf_compact_get_path(vc, i, out, sizeof(out), &len) == 0);
+        CHECK(len == strlen(paths[i]) && strcmp(out, paths[i]) == 0);
+
+        /* The length is reported even when the buffer is too small. */
+        size_t short_len = 0;
+        CHECK(vf_compact_get_path(vc, i, out, len, &short_len) == 1);
+        CHECK(short_len == len);
+
+        vf_entry_t *e = vf_compact_clone_entry(vc, i);
+        CHECK(e != NULL);
+        if (!e)
+            continue;
+        const vf_entry_t *o = &vf->entries[i];
+        CHECK(strcmp(vf_entry_get_path(e), paths[i]) == 0);
+        CHECK(strcmp(vf_entry_get_name(e), o->file_name) == 0);
+        CHECK(strcmp(vf_compact_get_name(vc, i), o->file_name) == 0);
+        CHECK(e->file_size == o->file_size && e->source_file_number == o->source_file_number);
+        CHECK(memcmp(e->original_crc, o->original_crc, 4) == 0);
+        CHECK(memcmp(e->unknown1, o->unknown1, 8) == 0);
+        vf_entry_free(e);
+    }
+}
+
+static void check_dirs(const vf_compact_t *vc) {
+    uint32_t maps, maps2, root_sound;
+    CHECK(vf_compact_find_dir(vc, "data\\maps", 9, &maps) == 0);
+    CHECK(vf_compact_find_dir(vc, "data/maps/", 10, &maps2) == 0);
+    CHECK(maps == maps2);
+    CHECK(vf_compact_find_dir(vc, "data/sound", 10, &root_sound) == 0);
+    CHECK(vf_compact_find_dir(vc, "data/nothing", 12, &maps2) == 1);
+
+    uint32_t len = 0;
+    const char *name = vf_compact_dir_name(vc, maps, &len);
+    CHECK(name && len == 4 && memcmp(name, "maps", 4) == 0);
+
+    /* town, field, cave, mixed and the repeated town all live in data\maps. */
+    uint32_t n = 0;
+    const uint32_t *ids = vf_compact_dir_entries(vc, maps, 0, &n);
+    CHECK(ids != NULL && n == 5);
+    for (uint32_t i = 0; ids && i < n; ++i) {
+        char out[128];
+        CHECK(vf_compact_get_path(vc, ids[i], out, sizeof(out), NULL) == 0);
+        CHECK(strncmp(out, "data", 4) == 0 && strstr(out, "maps") == out + 5);
+        if (i > 0)
+            CHECK(ids[i - 1] < ids[i]);
+    }
+
+    uint32_t below = 0;
+    CHECK(vf_compact_dir_entries(vc, root_sound, 1, &below) != NULL);
+    CHECK(below == 3);
+}
+
+int main(void) {
+    vf_file_t *vf = make_manifest();
+    if (!vf)
+        return test_result();
+
+    vf_compact_t *vc = vf_compact_build(vf);
+    CHECK(vc != NULL);
+    if (vc) {
+        check_paths(vc, vf);
+        check_dirs(vc);
+        vf_compact_free(vc);
+    }
+
+    /* The streaming reader builds the same tree straight from disk. */
+    CHECK(vf_file_write("vf_compact.ccx", vf) == 0);
+    vc = vf_compact_read("vf_compact.ccx");
+    CHECK(vc != NULL);
+    if (vc) {
+        check_paths(vc, vf);
+        check_dirs(vc);
+        vf_compact_free(vc);
+    }
+
+    vf_file_free(vf);
+    return test_result();
+}
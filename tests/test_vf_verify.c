@@ -0,0 +1,147 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "vf.h"
+#include "crc32.h"
+#include "test.h"
+#include "test_fs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TREE "vf_verify_tree"
+
+typedef struct {
+    const char *path;   /* as written to disk, below TREE */
+    size_t      size;
+} tree_file_t;
+
+static const tree_file_t tree[] = {
+    { TREE "/a.bin", 1000 },
+    { TREE "/sub/b.bin", 70000 },
+    { TREE "/sub/c.bin", 0 },
+    { TREE "/sub/d.bin", 300 },
+};
+#define TREE_FILES (sizeof(tree) / sizeof(tree[0]))
+
+static uint32_t tree_crc[TREE_FILES];
+
+static int make_tree(void) {
+    test_mkdir(TREE);
+    test_mkdir(TREE "/sub");
+    for (size_t i = 0; i < TREE_FILES; ++i) {
+        uint8_t *buf = (uint8_t *) malloc(tree[i].size + 1);
+        if (!buf)
+            return 1;
+        test_fill(buf, tree[i].size, (uint32_t) i + 1);
+        tree_crc[i] = sso_crc32(0, buf, tree[i].size);
+        const int rc = test_write_file(tree[i].path, buf, tree[i].size);
+        free(buf);
+        if (rc)
+            return 1;
+    }
+    return 0;
+}
+
+static void crc_bytes(uint32_t crc, uint8_t out[4]) {
+    out[0] = (uint8_t) crc;
+    out[1] = (uint8_t) (crc >> 8);
+    out[2] = (uint8_t) (crc >> 16);
+    out[3] = (uint8_t) (crc >> 24);
+}
+
+static void add(vf_file_t *vf, const char *path, uint32_t size, uint32_t original, uint32_t exported) {
+    vf_entry_t *e = vf_entry_create();
+    CHECK(e != NULL);
+    if (!e)
+        return;
+    uint8_t b[4];
+    vf_entry_set_name(e, "name");
+    vf_entry_set_path(e, path);
+    vf_entry_set_file_size(e, size);
+    crc_bytes(original, b);
+    vf_entry_set_original_crc(e, b);
+    crc_bytes(exported, b);
+    vf_entry_set_exported_crc(e, b);
+    CHECK(vf_file_add_entry(vf, e) == 0);
+    vf_entry_free(e);
+}
+
+/* One entry per outcome, with both separators in manifest paths. */
+static vf_file_t *make_manifest(void) {
+    vf_file_t *vf = vf_file_create();
+    CHECK(vf != NULL);
+    if (!vf)
+        return NULL;
+    add(vf, "a.bin", 1000, tree_crc[0], 0);
+    add(vf, "sub\\b.bin", 70000, tree_crc[1], tree_crc[1] ^ 1);
+    add(vf, "\\sub/c.bin", 0, 0, 0);
+    add(vf, "sub\\d.bin", 300, tree_crc[3] ^ 0x80000000u, tree_crc[3]);
+    add(vf, "sub\\missing.bin", 5, 0, 0);
+    add(vf, "a.bin", 999, tree_crc[0], 0);
+    return vf;
+}
+
+static void test_statuses(const vf_file_t *vf, unsigned nthreads, size_t read_size, int use_mmap) {
+    vf_verify_opts_t opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.nthreads = nthreads;
+    opts.read_size = read_size;
+    opts.use_mmap = use_mmap;
+
+    vf_verify_report_t rep;
+    CHECK(vf_verify_tree(vf, TREE, &opts, &rep) == 0);
+    CHECK(rep.count == 6);
+    if (rep.count != 6) {
+        vf_verify_report_free(&rep);
+        return;
+    }
+    CHECK(rep.status[0] == VF_VERIFY_OK);
+    CHECK(rep.status[1] == VF_VERIFY_OK);
+    CHECK(rep.status[2] == VF_VERIFY_OK);
+    CHECK(rep.status[3] == VF_VERIFY_CRC_MISMATCH);
+    CHECK(rep.status[4] == VF_VERIFY_MISSING);
+    CHECK(rep.status[5] == VF_VERIFY_SIZE_MISMATCH);
+    CHECK(rep.ok == 3 && rep.crc_mismatch == 1 && rep.missing == 1 && rep.size_mismatch == 1);
+    CHECK(rep.read_errors == 0 && rep.cache_hits == 0);
+    CHECK(rep.crc[0] == tree_crc[0] && rep.crc[1] == tree_crc[1] && rep.crc[3] == tree_crc[3]);
+    CHECK(rep.bytes_hashed == 1000 + 70000 + 300);
+    vf_verify_report_free(&rep);
+}
+
+static void test_crc_choice(const vf_file_t *vf) {
+    vf_verify_opts_t opts;
+    memset(&opts, 0, sizeof(opts));
+    vf_verify_report_t rep;
+
+    opts.crc = VF_VERIFY_CRC_EXPORTED;
+    CHECK(vf_verify_tree(vf, TREE, &opts, &rep) == 0);
+    CHECK(rep.status[1] == VF_VERIFY_CRC_MISMATCH && rep.status[3] == VF_VERIFY_OK);
+    vf_verify_report_free(&rep);
+
+    opts.crc = VF_VERIFY_CRC_EITHER;
+    CHECK(vf_verify_tree(vf, TREE, &opts, &rep) == 0);
+    CHECK(rep.status[1] == VF_VERIFY_OK && rep.status[3] == VF_VERIFY_OK);
+    vf_verify_report_free(&rep);
+
+    /* Sizes only: nothing is read. */
+    opts.crc = VF_VERIFY_CRC_NONE;
+    CHECK(vf_verify_tree(vf, TREE, &opts, &rep) == 0);
+    CHECK(rep.ok == 4 && rep.bytes_hashed == 0);
+    vf_verify_report_free(&rep);
+}
+
+int main(void) {
+    CHECK(make_tree() == 0);
+    vf_file_t *vf = make_manifest();
+    if (vf) {
+        test_statuses(vf, 0, 0, 0);
+        test_statuses(vf, 1, 4096, 0);
+        test_statuses(vf, 4, 7, 0);
+        test_statuses(vf, 3, 0, 1);
+        test_crc_choice(vf);
+        vf_file_free(vf);
+    }
+    return test_result();
+}
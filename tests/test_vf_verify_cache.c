@@ -0,0 +1,155 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "vf.h"
+#include "crc32.h"
+#include "test.h"
+#include "test_fs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TREE  "vf_vcache_tree"
+#define CACHE "vf_vcache.bin"
+
+static const char *const tree_paths[] = { TREE "/a.bin", TREE "/b.bin", TREE "/c.bin" };
+static const size_t tree_sizes[] = { 100, 5000, 65536 };
+#define TREE_FILES 3
+
+static uint32_t tree_crc[TREE_FILES];
+
+static int write_tree_file(size_t i, uint32_t seed) {
+    uint8_t *buf = (uint8_t *) malloc(tree_sizes[i]);
+    if (!buf)
+        return 1;
+    test_fill(buf, tree_sizes[i], seed);
+    tree_crc[i] = sso_crc32(0, buf, tree_sizes[i]);
+    const int rc = test_write_file(tree_paths[i], buf, tree_sizes[i]);
+    free(buf);
+    return rc;
+}
+
+static vf_file_t *make_manifest(void) {
+    vf_file_t *vf = vf_file_create();
+    CHECK(vf != NULL);
+    for (size_t i = 0; vf && i < TREE_FILES; ++i) {
+        vf_entry_t *e = vf_entry_create();
+        if (!e)
+            break;
+        const uint8_t crc[4] = { (uint8_t) tree_crc[i], (uint8_t) (tree_crc[i] >> 8),
+                                 (uint8_t) (tree_crc[i] >> 16), (uint8_t) (tree_crc[i] >> 24) };
+        vf_entry_set_name(e, "name");
+        vf_entry_set_path(e, tree_paths[i] + sizeof(TREE));
+        vf_entry_set_file_size(e, (uint32_t) tree_sizes[i]);
+        vf_entry_set_original_crc(e, crc);
+        CHECK(vf_file_add_entry(vf, e) == 0);
+        vf_entry_free(e);
+    }
+    return vf;
+}
+
+/* Verifies against a freshly opened cache and saves it back; returns the cache hits. */
+static uint32_t verify_cached(const vf_file_t *vf, int use_mmap, uint32_t expect_ok) {
+    vf_verify_cache_t *c = vf_verify_cache_open(CACHE);
+    CHECK(c != NULL);
+    if (!c)
+        return UINT32_MAX;
+
+    vf_verify_opts_t opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.use_mmap = use_mmap;
+    opts.cache = c;
+
+    vf_verify_report_t rep;
+    CHECK(vf_verify_tree(vf, TREE, &opts, &rep) == 0);
+    CHECK(rep.ok == expect_ok);
+    for (uint32_t i = 0; i < rep.count; ++i)
+        CHECK(rep.crc[i] == tree_crc[i]);
+    const uint32_t hits = rep.cache_hits;
+    vf_verify_report_free(&rep);
+
+    CHECK(vf_verify_cache_save(c) == 0);
+    vf_verify_cache_close(c);
+    return hits;
+}
+
+static uint32_t cache_count(void) {
+    vf_verify_cache_t *c = vf_verify_cache_open(CACHE);
+    CHECK(c != NULL);
+    const uint32_t n = c ? vf_verify_cache_count(c) : UINT32_MAX;
+    vf_verify_cache_close(c);
+    return n;
+}
+
+static size_t read_cache(uint8_t *buf, size_t cap) {
+    FILE *f = fopen(CACHE, "rb");
+    if (!f)
+        return 0;
+    const size_t n = fread(buf, 1, cap, f);
+    fclose(f);
+    return n;
+}
+
+/* Damaged caches open empty instead of handing out stale CRCs. */
+static void test_corruption(void) {
+    static uint8_t image[4096], bad[4096];
+    const size_t size = read_cache(image, sizeof(image));
+    CHECK(size > 24 && size < sizeof(image));
+    if (size <= 24 || size >= sizeof(image))
+        return;
+
+    const size_t flips[] = { 0, 4, 8, size / 2, size - 1 };
+    for (size_t k = 0; k < sizeof(flips) / sizeof(flips[0]); ++k) {
+        memcpy(bad, image, size);
+        bad[flips[k]] ^= 0x01;
+        CHECK(test_write_file(CACHE, bad, size) == 0);
+        CHECK(cache_count() == 0);
+    }
+
+    const size_t cuts[] = { 0, 10, 24, size - 1 };
+    for (size_t k = 0; k < sizeof(cuts) / sizeof(cuts[0]); ++k) {
+        CHECK(test_write_file(CACHE, image, cuts[k]) == 0);
+        CHECK(cache_count() == 0);
+    }
+
+    memcpy(bad, image, size);
+    memset(bad + size, 0, 8);
+    CHECK(test_write_file(CACHE, bad, size + 8) == 0);
+    CHECK(cache_count() == 0);
+
+    CHECK(test_write_file(CACHE, image, size) == 0);
+    CHECK(cache_count() == TREE_FILES);
+}
+
+int main(void) {
+    remove(CACHE);
+    test_mkdir(TREE);
+    for (size_t i = 0; i < TREE_FILES; ++i)
+        CHECK(write_tree_file(i, (uint32_t) i + 1) == 0);
+
+    vf_file_t *vf = make_manifest();
+    if (!vf)
+        return test_result();
+
+    /* Files changed within the timestamp granularity of a run are never cached. */
+    CHECK(verify_cached(vf, 0, TREE_FILES) == 0);
+    CHECK(cache_count() == 0);
+    test_sleep_ms(2100);
+
+    CHECK(verify_cached(vf, 0, TREE_FILES) == 0);
+    CHECK(cache_count() == TREE_FILES);
+    CHECK(verify_cached(vf, 0, TREE_FILES) == TREE_FILES);
+    CHECK(verify_cached(vf, 1, TREE_FILES) == TREE_FILES);
+
+    test_corruption();
+
+    /* A rewritten file no longer matches its cached identity and is hashed again. */
+    const uint32_t old_crc = tree_crc[1];
+    CHECK(write_tree_file(1, 99) == 0);
+    CHECK(tree_crc[1] != old_crc);
+    CHECK(verify_cached(vf, 0, TREE_FILES - 1) == TREE_FILES - 1);
+
+    vf_file_free(vf);
+    return test_result();
+}